@@ -0,0 +1,303 @@
+/*
+ * CrosstalkSolverBenchmark.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+// Standard
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+using namespace std;
+
+// ROOT
+#include <TRandom.h>
+
+// MEGAlib
+#include "MGlobal.h"
+#include "MTimer.h"
+
+// Nuclearizer
+#include "MStripCrosstalkSolver.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Compare the banded cross-talk solver of MModuleCrosstalkCorrection with the dense
+//! TMatrixD reference solver for random strip configurations, and benchmark both
+class CrosstalkSolverBenchmark
+{
+public:
+  //! Default constructor
+  CrosstalkSolverBenchmark();
+  //! Default destructor
+  ~CrosstalkSolverBenchmark();
+
+  //! Parse the command line
+  bool ParseCommandLine(int argc, char** argv);
+  //! Analyze what eveer needs to be analyzed...
+  bool Analyze();
+  //! Interrupt the analysis
+  void Interrupt() { m_Interrupt = true; }
+
+private:
+  //! True, if the analysis needs to be interrupted
+  bool m_Interrupt;
+  //! The number of strip configurations
+  unsigned int m_NConfigurations;
+  //! The maximum number of strip hits per configuration
+  unsigned int m_MaxNStrips;
+  //! The maximum accepted relative deviation between the banded and the dense solver
+  double m_Tolerance;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default constructor
+CrosstalkSolverBenchmark::CrosstalkSolverBenchmark() : m_Interrupt(false), m_NConfigurations(1000000), m_MaxNStrips(10), m_Tolerance(1E-10)
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default destructor
+CrosstalkSolverBenchmark::~CrosstalkSolverBenchmark()
+{
+  // Intentionally left blank
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Parse the command line
+bool CrosstalkSolverBenchmark::ParseCommandLine(int argc, char** argv)
+{
+  ostringstream Usage;
+  Usage<<endl;
+  Usage<<"  Usage: CrosstalkSolverBenchmark <options>"<<endl;
+  Usage<<"    General options:"<<endl;
+  Usage<<"         -n:   number of strip configurations (default: 1000000)"<<endl;
+  Usage<<"         -m:   maximum number of strip hits per configuration (default: 10)"<<endl;
+  Usage<<"         -t:   maximum accepted relative deviation (default: 1E-10)"<<endl;
+  Usage<<"         -h:   print this help"<<endl;
+  Usage<<endl;
+
+  string Option;
+
+  // Check for help
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+    if (Option == "-h" || Option == "--help" || Option == "?" || Option == "-?") {
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  // Now parse the command line options:
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+
+    // First check if each option has sufficient arguments:
+    // Single argument
+    if (Option == "-n" || Option == "-m" || Option == "-t") {
+      if (!((argc > i+1) &&
+            (argv[i+1][0] != '-' || isalpha(argv[i+1][1]) == 0))){
+        cout<<"Error: Option "<<argv[i][1]<<" needs a second argument!"<<endl;
+        cout<<Usage.str()<<endl;
+        return false;
+      }
+    }
+
+    // Then fulfill the options:
+    if (Option == "-n") {
+      m_NConfigurations = atoi(argv[++i]);
+      cout<<"Accepting number of configurations: "<<m_NConfigurations<<endl;
+    } else if (Option == "-m") {
+      m_MaxNStrips = atoi(argv[++i]);
+      cout<<"Accepting maximum number of strip hits: "<<m_MaxNStrips<<endl;
+    } else if (Option == "-t") {
+      m_Tolerance = atof(argv[++i]);
+      cout<<"Accepting tolerance: "<<m_Tolerance<<endl;
+    } else {
+      cout<<"Error: Unknown option \""<<Option<<"\"!"<<endl;
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  if (m_NConfigurations == 0 || m_MaxNStrips < 2 || m_MaxNStrips > 64) {
+    cout<<"Error: Need at least one configuration and between 2 and 64 strip hits"<<endl;
+    return false;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Do whatever analysis is necessary
+bool CrosstalkSolverBenchmark::Analyze()
+{
+  if (m_Interrupt == true) return false;
+
+  // Random configurations: a few clusters of adjacent strips out of 64 with
+  // cross-talk coefficients of the typical magnitude, some with a strip hit twice
+  vector<unsigned int> Starts(m_NConfigurations + 1, 0);
+  vector<int> StripIDs;
+  vector<double> Energies;
+  vector<double> Coefficients(4*m_NConfigurations);
+  for (unsigned int c = 0; c < m_NConfigurations; ++c) {
+    unsigned int N = 2 + gRandom->Integer(m_MaxNStrips - 1);
+    vector<int> IDs;
+    while (IDs.size() < N) {
+      int Center = gRandom->Integer(64);
+      int Width = 1 + gRandom->Integer(4);
+      for (int s = Center; s < Center + Width && s < 64 && IDs.size() < N; ++s) {
+        if (find(IDs.begin(), IDs.end(), s) == IDs.end()) IDs.push_back(s);
+      }
+    }
+    if (gRandom->Rndm() < 0.01) IDs.back() = IDs.front();
+    sort(IDs.begin(), IDs.end());
+    for (int ID: IDs) {
+      StripIDs.push_back(ID);
+      Energies.push_back(gRandom->Uniform(10.0, 1000.0));
+    }
+    Starts[c+1] = StripIDs.size();
+    Coefficients[4*c] = gRandom->Uniform(-2.0, 2.0);
+    Coefficients[4*c+1] = gRandom->Uniform(-0.05, 0.05);
+    Coefficients[4*c+2] = gRandom->Uniform(-1.0, 1.0);
+    Coefficients[4*c+3] = gRandom->Uniform(-0.02, 0.02);
+  }
+
+  vector<double> DenseEnergies(Energies.size());
+  vector<double> BandedEnergies(Energies.size());
+  MStripCrosstalkSolver Solver;
+
+  cout<<endl;
+  cout<<"Comparing "<<m_NConfigurations<<" strip configurations with up to "<<m_MaxNStrips<<" strip hits:"<<endl;
+  cout<<endl;
+
+  MTimer Timer;
+  Solver.SetMode(MStripCrosstalkSolver::c_ModeDense);
+  for (unsigned int c = 0; c < m_NConfigurations; ++c) {
+    Solver.SetCoefficients(Coefficients[4*c], Coefficients[4*c+1], Coefficients[4*c+2], Coefficients[4*c+3]);
+    Solver.Solve(Starts[c+1] - Starts[c], &StripIDs[Starts[c]], &Energies[Starts[c]], &DenseEnergies[Starts[c]]);
+  }
+  double DenseTime = Timer.GetElapsed();
+  if (m_Interrupt == true) return false;
+
+  Timer.Reset();
+  Solver.SetMode(MStripCrosstalkSolver::c_ModeBanded);
+  for (unsigned int c = 0; c < m_NConfigurations; ++c) {
+    Solver.SetCoefficients(Coefficients[4*c], Coefficients[4*c+1], Coefficients[4*c+2], Coefficients[4*c+3]);
+    Solver.Solve(Starts[c+1] - Starts[c], &StripIDs[Starts[c]], &Energies[Starts[c]], &BandedEnergies[Starts[c]]);
+  }
+  double BandedTime = Timer.GetElapsed();
+
+  unsigned int NFallbacks = 0;
+  unsigned int NFailures = 0;
+  double MaxDeviation = 0.0;
+  vector<double> Dummy(m_MaxNStrips);
+  for (unsigned int c = 0; c < m_NConfigurations; ++c) {
+    Solver.SetCoefficients(Coefficients[4*c], Coefficients[4*c+1], Coefficients[4*c+2], Coefficients[4*c+3]);
+    if (Solver.SolveBanded(Starts[c+1] - Starts[c], &StripIDs[Starts[c]], &Energies[Starts[c]], &Dummy[0]) == false) ++NFallbacks;
+    bool Failed = false;
+    for (unsigned int i = Starts[c]; i < Starts[c+1]; ++i) {
+      double Deviation = fabs(BandedEnergies[i] - DenseEnergies[i])/max(1.0, fabs(DenseEnergies[i]));
+      MaxDeviation = max(MaxDeviation, Deviation);
+      if (Deviation > m_Tolerance) Failed = true;
+    }
+    if (Failed == true) ++NFailures;
+  }
+
+  cout<<"  "<<setw(8)<<left<<"Dense"<<": "<<setw(12)<<right<<setprecision(4)<<scientific<<m_NConfigurations/DenseTime<<" configurations/s"<<endl;
+  cout<<"  "<<setw(8)<<left<<"Banded"<<": "<<setw(12)<<right<<setprecision(4)<<scientific<<m_NConfigurations/BandedTime<<" configurations/s"
+      <<"  (speed-up: "<<setprecision(2)<<fixed<<DenseTime/BandedTime<<")"<<endl;
+  cout<<endl;
+  cout<<"  Configurations solved with the dense fall-back: "<<NFallbacks<<endl;
+  cout<<"  Maximum relative deviation: "<<setprecision(2)<<scientific<<MaxDeviation<<endl;
+  cout<<"  Configurations exceeding the tolerance: "<<NFailures<<endl;
+  cout<<endl;
+
+  return (NFailures == 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+CrosstalkSolverBenchmark* g_Prg = 0;
+int g_NInterruptCatches = 1;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Called when an interrupt signal is flagged
+//! All catched signals lead to a well defined exit of the program
+void CatchSignal(int a)
+{
+  if (g_Prg != 0 && g_NInterruptCatches-- > 0) {
+    cout<<"Catched signal Ctrl-C (ID="<<a<<"):"<<endl;
+    g_Prg->Interrupt();
+  } else {
+    abort();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Main program
+int main(int argc, char** argv)
+{
+  // Catch a user interupt for graceful shutdown
+  signal(SIGINT, CatchSignal);
+
+  // Initialize global MEGALIB variables, especially mgui, etc.
+  MGlobal::Initialize("Standalone", "a standalone example program");
+
+  g_Prg = new CrosstalkSolverBenchmark();
+
+  if (g_Prg->ParseCommandLine(argc, argv) == false) {
+    cerr<<"Error during parsing of command line!"<<endl;
+    return -1;
+  }
+  if (g_Prg->Analyze() == false) {
+    cerr<<"Error during analysis!"<<endl;
+    return -2;
+  }
+
+  cout<<"Program exited normally!"<<endl;
+
+  return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
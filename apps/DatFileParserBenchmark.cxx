@@ -0,0 +1,261 @@
+/*
+ * DatFileParserBenchmark.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+// Standard
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+using namespace std;
+
+// MEGAlib
+#include "MGlobal.h"
+#include "MTimer.h"
+#include "MFile.h"
+
+// Nuclearizer
+#include "MReadOutAssembly.h"
+#include "MDatFileParser.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Benchmark reading a dat file line by line via MReadOutAssembly::GetNextFromDatFile()
+//! against the bulk MDatFileParser, and compare the number of events, hits and strip hits both find
+class DatFileParserBenchmark
+{
+public:
+  //! Default constructor
+  DatFileParserBenchmark();
+  //! Default destructor
+  ~DatFileParserBenchmark() {}
+
+  //! Parse the command line
+  bool ParseCommandLine(int argc, char** argv);
+  //! Analyze what eveer needs to be analyzed...
+  bool Analyze();
+  //! Interrupt the analysis
+  void Interrupt() { m_Interrupt = true; }
+
+private:
+  //! True, if the analysis needs to be interrupted
+  bool m_Interrupt;
+  //! The dat file
+  MString m_FileName;
+  //! The number of passes over the file
+  unsigned int m_NPasses;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default constructor
+DatFileParserBenchmark::DatFileParserBenchmark() : m_Interrupt(false), m_FileName(""), m_NPasses(3)
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Parse the command line
+bool DatFileParserBenchmark::ParseCommandLine(int argc, char** argv)
+{
+  ostringstream Usage;
+  Usage<<endl;
+  Usage<<"  Usage: DatFileParserBenchmark <options>"<<endl;
+  Usage<<"    General options:"<<endl;
+  Usage<<"         -f:   dat file (GetNextFromDatFile does not follow the IN lines of split files)"<<endl;
+  Usage<<"         -p:   number of passes over the file (default: 3)"<<endl;
+  Usage<<"         -h:   print this help"<<endl;
+  Usage<<endl;
+
+  string Option;
+
+  // Check for help
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+    if (Option == "-h" || Option == "--help" || Option == "?" || Option == "-?") {
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  // Now parse the command line options:
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+
+    // First check if each option has sufficient arguments:
+    // Single argument
+    if (Option == "-f" || Option == "-p") {
+      if (!((argc > i+1) &&
+            (argv[i+1][0] != '-' || isalpha(argv[i+1][1]) == 0))){
+        cout<<"Error: Option "<<argv[i][1]<<" needs a second argument!"<<endl;
+        cout<<Usage.str()<<endl;
+        return false;
+      }
+    }
+
+    // Then fulfill the options:
+    if (Option == "-f") {
+      m_FileName = argv[++i];
+      cout<<"Accepting file name: "<<m_FileName<<endl;
+    } else if (Option == "-p") {
+      m_NPasses = atoi(argv[++i]);
+      cout<<"Accepting number of passes: "<<m_NPasses<<endl;
+    } else {
+      cout<<"Error: Unknown option \""<<Option<<"\"!"<<endl;
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  if (m_FileName == "" || m_NPasses == 0) {
+    cout<<"Error: Need a file and at least one pass"<<endl;
+    cout<<Usage.str()<<endl;
+    return false;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Do whatever analysis is necessary
+bool DatFileParserBenchmark::Analyze()
+{
+  if (m_Interrupt == true) return false;
+
+  // (a) Line by line
+  unsigned long NEventsLines = 0, NHitsLines = 0, NStripHitsLines = 0;
+  MTimer Timer;
+  for (unsigned int p = 0; p < m_NPasses && m_Interrupt == false; ++p) {
+    MFile File;
+    if (File.Open(m_FileName, MFile::c_Read) == false) {
+      cout<<"Error: Unable to open file "<<m_FileName<<endl;
+      return false;
+    }
+    MReadOutAssembly Event;
+    while (Event.GetNextFromDatFile(File) == true) {
+      ++NEventsLines;
+      NHitsLines += Event.GetNHits();
+      NStripHitsLines += Event.GetNStripHits();
+    }
+    File.Close();
+  }
+  double LinesTime = Timer.GetElapsed();
+
+  // (b) The bulk parser with its pools
+  unsigned long NEventsBulk = 0, NHitsBulk = 0, NStripHitsBulk = 0;
+  MDatFileParser Parser;
+  Timer.Reset();
+  for (unsigned int p = 0; p < m_NPasses && m_Interrupt == false; ++p) {
+    if (Parser.Open(m_FileName) == false) {
+      cout<<"Error: Unable to open file "<<m_FileName<<endl;
+      return false;
+    }
+    MReadOutAssembly* Event = nullptr;
+    while ((Event = Parser.Next()) != nullptr) {
+      ++NEventsBulk;
+      NHitsBulk += Event->GetNHits();
+      NStripHitsBulk += Event->GetNStripHits();
+      Parser.Release(Event);
+    }
+    Parser.Close();
+  }
+  double BulkTime = Timer.GetElapsed();
+
+  if (m_Interrupt == true) return false;
+
+  double NEvents = NEventsBulk;
+  cout<<endl;
+  cout<<"Events per pass: "<<NEventsBulk/m_NPasses<<" (hits: "<<NHitsBulk/m_NPasses<<", strip hits: "<<NStripHitsBulk/m_NPasses<<")"<<endl;
+  cout<<"  GetNextFromDatFile: "<<setw(12)<<right<<setprecision(0)<<fixed<<NEvents/LinesTime<<" events/s"<<endl;
+  cout<<"  MDatFileParser:     "<<setw(12)<<right<<NEvents/BulkTime<<" events/s"
+      <<"  (speed-up: "<<setprecision(2)<<LinesTime/BulkTime<<", lines not parsed: "<<Parser.GetNBadLines()<<")"<<endl;
+  cout<<endl;
+
+  // GetNextFromDatFile() gives up after 1000 lines, which usually drops the last event of the file
+  if (NEventsLines != NEventsBulk || NHitsLines != NHitsBulk || NStripHitsLines != NStripHitsBulk) {
+    cout<<"Note: The parsers found different events: "<<NEventsLines<<" vs. "<<NEventsBulk<<" events, "
+        <<NHitsLines<<" vs. "<<NHitsBulk<<" hits, "<<NStripHitsLines<<" vs. "<<NStripHitsBulk<<" strip hits"<<endl;
+    cout<<endl;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+DatFileParserBenchmark* g_Prg = 0;
+int g_NInterruptCatches = 1;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Called when an interrupt signal is flagged
+//! All catched signals lead to a well defined exit of the program
+void CatchSignal(int a)
+{
+  if (g_Prg != 0 && g_NInterruptCatches-- > 0) {
+    cout<<"Catched signal Ctrl-C (ID="<<a<<"):"<<endl;
+    g_Prg->Interrupt();
+  } else {
+    abort();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Main program
+int main(int argc, char** argv)
+{
+  // Catch a user interupt for graceful shutdown
+  signal(SIGINT, CatchSignal);
+
+  // Initialize global MEGALIB variables, especially mgui, etc.
+  MGlobal::Initialize("Standalone", "a standalone example program");
+
+  g_Prg = new DatFileParserBenchmark();
+
+  if (g_Prg->ParseCommandLine(argc, argv) == false) {
+    cerr<<"Error during parsing of command line!"<<endl;
+    return -1;
+  }
+  if (g_Prg->Analyze() == false) {
+    cerr<<"Error during analysis!"<<endl;
+    return -2;
+  }
+
+  cout<<"Program exited normally!"<<endl;
+
+  return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
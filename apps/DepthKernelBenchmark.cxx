@@ -0,0 +1,326 @@
+/*
+ * DepthKernelBenchmark.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+// Standard
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+#include <cmath>
+using namespace std;
+
+// ROOT
+#include <TRandom.h>
+
+// MEGAlib
+#include "MGlobal.h"
+#include "MTimer.h"
+
+// Nuclearizer
+#include "MGaussianDepthKernel.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Benchmark the Gaussian-weighted CTD->depth kernel of MModuleDepthCalibration2024
+//! for all available instruction sets against the original three-pass implementation
+class DepthKernelBenchmark
+{
+public:
+  //! Default constructor
+  DepthKernelBenchmark();
+  //! Default destructor
+  ~DepthKernelBenchmark();
+
+  //! Parse the command line
+  bool ParseCommandLine(int argc, char** argv);
+  //! Analyze what eveer needs to be analyzed...
+  bool Analyze();
+  //! Interrupt the analysis
+  void Interrupt() { m_Interrupt = true; }
+
+private:
+  //! The original normal distribution of MModuleDepthCalibration2024 (copies its input)
+  vector<double> NormPdf(vector<double> x, double mu, double sigma);
+  //! The original three-pass depth calculation of MModuleDepthCalibration2024
+  void CalculateOriginal(vector<double> CTDs, vector<double> Depths, double CTD_s, double Noise, double& MeanDepth, double& DepthSigma);
+
+  //! True, if the analysis needs to be interrupted
+  bool m_Interrupt;
+  //! The number of hits to calculate
+  unsigned int m_NHits;
+  //! The number of depth grid points
+  unsigned int m_NGridPoints;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default constructor
+DepthKernelBenchmark::DepthKernelBenchmark() : m_Interrupt(false), m_NHits(1000000), m_NGridPoints(151)
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default destructor
+DepthKernelBenchmark::~DepthKernelBenchmark()
+{
+  // Intentionally left blank
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Parse the command line
+bool DepthKernelBenchmark::ParseCommandLine(int argc, char** argv)
+{
+  ostringstream Usage;
+  Usage<<endl;
+  Usage<<"  Usage: DepthKernelBenchmark <options>"<<endl;
+  Usage<<"    General options:"<<endl;
+  Usage<<"         -n:   number of hits (default: 1000000)"<<endl;
+  Usage<<"         -g:   number of depth grid points (default: 151)"<<endl;
+  Usage<<"         -h:   print this help"<<endl;
+  Usage<<endl;
+
+  string Option;
+
+  // Check for help
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+    if (Option == "-h" || Option == "--help" || Option == "?" || Option == "-?") {
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  // Now parse the command line options:
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+
+    // First check if each option has sufficient arguments:
+    // Single argument
+    if (Option == "-n" || Option == "-g") {
+      if (!((argc > i+1) &&
+            (argv[i+1][0] != '-' || isalpha(argv[i+1][1]) == 0))){
+        cout<<"Error: Option "<<argv[i][1]<<" needs a second argument!"<<endl;
+        cout<<Usage.str()<<endl;
+        return false;
+      }
+    }
+
+    // Then fulfill the options:
+    if (Option == "-n") {
+      m_NHits = atoi(argv[++i]);
+      cout<<"Accepting number of hits: "<<m_NHits<<endl;
+    } else if (Option == "-g") {
+      m_NGridPoints = atoi(argv[++i]);
+      cout<<"Accepting number of grid points: "<<m_NGridPoints<<endl;
+    } else {
+      cout<<"Error: Unknown option \""<<Option<<"\"!"<<endl;
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  if (m_NHits == 0 || m_NGridPoints < 2) {
+    cout<<"Error: Need at least one hit and two grid points"<<endl;
+    return false;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+vector<double> DepthKernelBenchmark::NormPdf(vector<double> x, double mu, double sigma)
+{
+  vector<double> result;
+  for( unsigned int i=0; i<x.size(); ++i ){
+    double prob = 1.0 / (sigma * sqrt(2.0 * M_PI)) * exp(-(pow((x[i] - mu)/sigma, 2.0)/2.0));
+    result.push_back(prob);
+  }
+  return result;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void DepthKernelBenchmark::CalculateOriginal(vector<double> CTDs, vector<double> Depths, double CTD_s, double Noise, double& MeanDepth, double& DepthSigma)
+{
+  vector<double> prob_dist = NormPdf(CTDs, CTD_s, Noise/2.355);
+
+  double prob_sum = 0.0;
+  for( unsigned int k=0; k < prob_dist.size(); ++k ){
+    prob_sum += prob_dist[k];
+  }
+  double weighted_depth = 0.0;
+  for( unsigned int k = 0; k < Depths.size(); ++k ){
+    weighted_depth += prob_dist[k]*Depths[k];
+  }
+  MeanDepth = weighted_depth/prob_sum;
+
+  double depth_var = 0.0;
+  for( unsigned int k=0; k<Depths.size(); ++k ){
+    depth_var += prob_dist[k]*pow(Depths[k]-MeanDepth, 2.0);
+  }
+  DepthSigma = sqrt(depth_var/prob_sum);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Do whatever analysis is necessary
+bool DepthKernelBenchmark::Analyze()
+{
+  if (m_Interrupt == true) return false;
+
+  // A realistic looking CTD->depth relation of a 1.5 cm thick detector
+  vector<double> Depths(m_NGridPoints);
+  vector<double> CTDs(m_NGridPoints);
+  for (unsigned int k = 0; k < m_NGridPoints; ++k) {
+    Depths[k] = 1.5*k/(m_NGridPoints - 1);
+    CTDs[k] = -180.0 + 240.0*Depths[k]/1.5 + 15.0*sin(2.0*Depths[k]);
+  }
+  double CTDMin = CTDs.front();
+  double CTDMax = CTDs.back();
+
+  // The hits: CTDs within the accepted range and timing noise of a few ns FWHM
+  vector<double> HitCTDs(m_NHits);
+  vector<double> HitNoises(m_NHits);
+  for (unsigned int h = 0; h < m_NHits; ++h) {
+    HitNoises[h] = gRandom->Uniform(5.0, 40.0);
+    HitCTDs[h] = gRandom->Uniform(CTDMin - 2.0*HitNoises[h], CTDMax + 2.0*HitNoises[h]);
+  }
+
+  vector<double> ReferenceMeans(m_NHits);
+  vector<double> ReferenceSigmas(m_NHits);
+
+  cout<<endl;
+  cout<<"Benchmarking "<<m_NHits<<" hits with "<<m_NGridPoints<<" grid points:"<<endl;
+  cout<<endl;
+
+  MTimer Timer;
+  for (unsigned int h = 0; h < m_NHits; ++h) {
+    CalculateOriginal(CTDs, Depths, HitCTDs[h], HitNoises[h], ReferenceMeans[h], ReferenceSigmas[h]);
+  }
+  double OriginalTime = Timer.GetElapsed();
+  cout<<"  "<<setw(10)<<left<<"Original"<<": "<<setw(12)<<right<<setprecision(4)<<scientific<<m_NHits/OriginalTime<<" hits/s"<<endl;
+
+  vector<MGaussianDepthKernelISA> ISAs = { MGaussianDepthKernelISA::c_Scalar, MGaussianDepthKernelISA::c_AVX2, MGaussianDepthKernelISA::c_AVX512 };
+  for (MGaussianDepthKernelISA ISA: ISAs) {
+    if (m_Interrupt == true) return false;
+
+    MGaussianDepthKernel Kernel;
+    if (Kernel.SetISA(ISA) == false) {
+      cout<<"  "<<setw(10)<<left<<MGaussianDepthKernel::GetISAName(ISA)<<": not supported on this machine"<<endl;
+      continue;
+    }
+
+    double MaxMeanDeviation = 0.0;
+    double MaxSigmaDeviation = 0.0;
+    double Mean = 0.0;
+    double Sigma = 0.0;
+
+    Timer.Reset();
+    for (unsigned int h = 0; h < m_NHits; ++h) {
+      Kernel.Calculate(CTDs, Depths, HitCTDs[h], HitNoises[h], Mean, Sigma);
+    }
+    double Time = Timer.GetElapsed();
+
+    for (unsigned int h = 0; h < m_NHits; ++h) {
+      Kernel.Calculate(CTDs, Depths, HitCTDs[h], HitNoises[h], Mean, Sigma);
+      MaxMeanDeviation = max(MaxMeanDeviation, fabs(Mean - ReferenceMeans[h]));
+      MaxSigmaDeviation = max(MaxSigmaDeviation, fabs(Sigma - ReferenceSigmas[h]));
+    }
+
+    cout<<"  "<<setw(10)<<left<<MGaussianDepthKernel::GetISAName(ISA)<<": "<<setw(12)<<right<<setprecision(4)<<scientific<<m_NHits/Time<<" hits/s"
+        <<"  (speed-up: "<<setprecision(2)<<fixed<<OriginalTime/Time<<", max deviation mean: "<<setprecision(2)<<scientific<<MaxMeanDeviation
+        <<" cm, sigma: "<<MaxSigmaDeviation<<" cm)"<<endl;
+  }
+  cout<<endl;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+DepthKernelBenchmark* g_Prg = 0;
+int g_NInterruptCatches = 1;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Called when an interrupt signal is flagged
+//! All catched signals lead to a well defined exit of the program
+void CatchSignal(int a)
+{
+  if (g_Prg != 0 && g_NInterruptCatches-- > 0) {
+    cout<<"Catched signal Ctrl-C (ID="<<a<<"):"<<endl;
+    g_Prg->Interrupt();
+  } else {
+    abort();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Main program
+int main(int argc, char** argv)
+{
+  // Catch a user interupt for graceful shutdown
+  signal(SIGINT, CatchSignal);
+
+  // Initialize global MEGALIB variables, especially mgui, etc.
+  MGlobal::Initialize("Standalone", "a standalone example program");
+
+  g_Prg = new DepthKernelBenchmark();
+
+  if (g_Prg->ParseCommandLine(argc, argv) == false) {
+    cerr<<"Error during parsing of command line!"<<endl;
+    return -1;
+  }
+  if (g_Prg->Analyze() == false) {
+    cerr<<"Error during analysis!"<<endl;
+    return -2;
+  }
+
+  cout<<"Program exited normally!"<<endl;
+
+  return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,430 @@
+/*
+ * EventStreamingBenchmark.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+// Standard
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <vector>
+using namespace std;
+
+// ROOT
+#include <TRandom.h>
+
+// MEGAlib
+#include "MGlobal.h"
+#include "MTimer.h"
+
+// Nuclearizer
+#include "MReadOutAssembly.h"
+#include "MStripHit.h"
+#include "MHit.h"
+#include "MAsciiBuffer.h"
+#include "MDatFileParser.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Benchmark the ASCII output of the events (dat, evta, and roa format) via ostream
+//! against the output via the reusable MAsciiBuffer, and check that both are identical
+class EventStreamingBenchmark
+{
+public:
+  //! Default constructor
+  EventStreamingBenchmark();
+  //! Default destructor
+  ~EventStreamingBenchmark();
+
+  //! Parse the command line
+  bool ParseCommandLine(int argc, char** argv);
+  //! Analyze what eveer needs to be analyzed...
+  bool Analyze();
+  //! Interrupt the analysis
+  void Interrupt() { m_Interrupt = true; }
+
+private:
+  //! Read the recorded events from the dat file
+  bool ReadEvents();
+  //! Create random events
+  void CreateEvents();
+  //! Stream an event via ostream
+  void Stream(MReadOutAssembly* Event, unsigned int Format, ostream& S);
+  //! Stream an event via the buffer
+  void Stream(MReadOutAssembly* Event, unsigned int Format, MAsciiBuffer& S);
+
+  //! True, if the analysis needs to be interrupted
+  bool m_Interrupt;
+  //! The dat file with the recorded events
+  MString m_FileName;
+  //! The number of random events
+  unsigned int m_NEvents;
+  //! The number of passes over all events
+  unsigned int m_NPasses;
+  //! The events
+  vector<MReadOutAssembly*> m_Events;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default constructor
+EventStreamingBenchmark::EventStreamingBenchmark() : m_Interrupt(false), m_FileName(""), m_NEvents(100000), m_NPasses(5)
+{
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Default destructor
+EventStreamingBenchmark::~EventStreamingBenchmark()
+{
+  for (MReadOutAssembly* Event: m_Events) delete Event;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Parse the command line
+bool EventStreamingBenchmark::ParseCommandLine(int argc, char** argv)
+{
+  ostringstream Usage;
+  Usage<<endl;
+  Usage<<"  Usage: EventStreamingBenchmark <options>"<<endl;
+  Usage<<"    General options:"<<endl;
+  Usage<<"         -f:   dat file with recorded events (default: random events)"<<endl;
+  Usage<<"         -n:   number of random events (default: 100000)"<<endl;
+  Usage<<"         -p:   number of passes over all events (default: 5)"<<endl;
+  Usage<<"         -h:   print this help"<<endl;
+  Usage<<endl;
+
+  string Option;
+
+  // Check for help
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+    if (Option == "-h" || Option == "--help" || Option == "?" || Option == "-?") {
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  // Now parse the command line options:
+  for (int i = 1; i < argc; i++) {
+    Option = argv[i];
+
+    // First check if each option has sufficient arguments:
+    // Single argument
+    if (Option == "-f" || Option == "-n" || Option == "-p") {
+      if (!((argc > i+1) &&
+            (argv[i+1][0] != '-' || isalpha(argv[i+1][1]) == 0))){
+        cout<<"Error: Option "<<argv[i][1]<<" needs a second argument!"<<endl;
+        cout<<Usage.str()<<endl;
+        return false;
+      }
+    }
+
+    // Then fulfill the options:
+    if (Option == "-f") {
+      m_FileName = argv[++i];
+      cout<<"Accepting file name: "<<m_FileName<<endl;
+    } else if (Option == "-n") {
+      m_NEvents = atoi(argv[++i]);
+      cout<<"Accepting number of random events: "<<m_NEvents<<endl;
+    } else if (Option == "-p") {
+      m_NPasses = atoi(argv[++i]);
+      cout<<"Accepting number of passes: "<<m_NPasses<<endl;
+    } else {
+      cout<<"Error: Unknown option \""<<Option<<"\"!"<<endl;
+      cout<<Usage.str()<<endl;
+      return false;
+    }
+  }
+
+  if (m_NEvents == 0 || m_NPasses == 0) {
+    cout<<"Error: Need at least one event and one pass"<<endl;
+    return false;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Read the recorded events from the dat file
+bool EventStreamingBenchmark::ReadEvents()
+{
+  MDatFileParser Parser;
+  if (Parser.Open(m_FileName) == false) {
+    cout<<"Error: Unable to open file "<<m_FileName<<endl;
+    return false;
+  }
+
+  MReadOutAssembly* Event = new MReadOutAssembly();
+  while (Parser.ReadNext(Event) == true) {
+    m_Events.push_back(Event);
+    Event = new MReadOutAssembly();
+  }
+  delete Event;
+  Parser.Close();
+
+  if (m_Events.size() == 0) {
+    cout<<"Error: No events in file "<<m_FileName<<endl;
+    return false;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Create random events - a few strip hits and hits each, and some BD flags
+void EventStreamingBenchmark::CreateEvents()
+{
+  for (unsigned int e = 0; e < m_NEvents; ++e) {
+    MReadOutAssembly* Event = new MReadOutAssembly();
+    Event->SetID(e + 1);
+    MTime Time;
+    Time.Set(1500000000 + e/100, (e % 100)*10000000 + gRandom->Integer(10000000));
+    Event->SetTime(Time);
+    Event->SetTimeUTC(Time);
+
+    unsigned int NHits = 1 + gRandom->Integer(3);
+    for (unsigned int h = 0; h < NHits; ++h) {
+      MHit* Hit = new MHit();
+      Hit->SetPosition(MVector(gRandom->Uniform(-4, 4), gRandom->Uniform(-4, 4), gRandom->Uniform(-1, 1)));
+      Hit->SetPositionResolution(MVector(0.1, 0.1, gRandom->Uniform(0.02, 0.2)));
+      Hit->SetEnergy(gRandom->Uniform(20, 2000));
+      Hit->SetEnergyResolution(gRandom->Uniform(1, 5));
+      for (unsigned int s = 0; s < 2; ++s) {
+        MStripHit* StripHit = new MStripHit();
+        StripHit->SetDetectorID(gRandom->Integer(12));
+        StripHit->IsXStrip(s == 0);
+        StripHit->SetStripID(gRandom->Integer(37) + 1);
+        StripHit->SetUncorrectedADCUnits(gRandom->Integer(16000));
+        StripHit->SetADCUnits(gRandom->Uniform(0, 16000));
+        StripHit->SetEnergy(Hit->GetEnergy() + gRandom->Gaus(0, 2));
+        StripHit->SetEnergyResolution(gRandom->Uniform(1, 5));
+        StripHit->SetTiming(gRandom->Uniform(0, 400));
+        StripHit->SetPreampTemp(gRandom->Uniform(15, 25));
+        Event->AddStripHit(StripHit);
+        Hit->AddStripHit(StripHit);
+      }
+      Event->AddHit(Hit);
+    }
+
+    if (gRandom->Rndm() < 0.05) Event->SetTimeIncomplete(true);
+    if (gRandom->Rndm() < 0.05) Event->SetStripPairingIncomplete(true, "Too many strips");
+    if (gRandom->Rndm() < 0.02) Event->SetDepthCalibrationIncomplete(true);
+
+    m_Events.push_back(Event);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Stream an event via ostream
+void EventStreamingBenchmark::Stream(MReadOutAssembly* Event, unsigned int Format, ostream& S)
+{
+  if (Format == 0) {
+    Event->StreamDat(S, 1);
+  } else if (Format == 1) {
+    Event->StreamEvta(S);
+  } else {
+    Event->StreamRoa(S);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Stream an event via the buffer
+void EventStreamingBenchmark::Stream(MReadOutAssembly* Event, unsigned int Format, MAsciiBuffer& S)
+{
+  if (Format == 0) {
+    Event->StreamDat(S, 1);
+  } else if (Format == 1) {
+    Event->StreamEvta(S);
+  } else {
+    Event->StreamRoa(S);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Do whatever analysis is necessary
+bool EventStreamingBenchmark::Analyze()
+{
+  if (m_Interrupt == true) return false;
+
+  if (m_FileName != "") {
+    if (ReadEvents() == false) return false;
+  } else {
+    CreateEvents();
+  }
+
+  cout<<endl;
+  cout<<"Benchmarking "<<m_Events.size()<<" events in "<<m_NPasses<<" passes:"<<endl;
+  cout<<endl;
+
+  vector<string> Formats = { "dat", "evta", "roa" };
+  for (unsigned int f = 0; f < Formats.size(); ++f) {
+    if (m_Interrupt == true) return false;
+
+    // Check first that the output is identical - each event starts with a new stream as in the event saver,
+    // and all events written into one stream keep its precision between the events
+    unsigned int NDifferent = 0;
+    MAsciiBuffer Buffer;
+    for (MReadOutAssembly* Event: m_Events) {
+      ostringstream Out;
+      Stream(Event, f, Out);
+      Buffer.Clear();
+      Buffer.SetPrecision(6);
+      Stream(Event, f, Buffer);
+      if (Out.str() != Buffer.GetString()) ++NDifferent;
+    }
+    ostringstream AllOut;
+    Buffer.Clear();
+    Buffer.SetPrecision(6);
+    for (MReadOutAssembly* Event: m_Events) {
+      Stream(Event, f, AllOut);
+      Stream(Event, f, Buffer);
+    }
+    if (AllOut.str() != Buffer.GetString()) ++NDifferent;
+
+    // (a) The event saver: a new ostringstream per event
+    double Bytes = 0;
+    MTimer Timer;
+    for (unsigned int p = 0; p < m_NPasses; ++p) {
+      for (MReadOutAssembly* Event: m_Events) {
+        ostringstream Out;
+        Stream(Event, f, Out);
+        Bytes += Out.str().size();
+      }
+    }
+    double StringStreamTime = Timer.GetElapsed();
+
+    // (b) The receiver: directly into an ofstream, flushing every line
+    ofstream File("/dev/null");
+    Timer.Reset();
+    for (unsigned int p = 0; p < m_NPasses; ++p) {
+      for (MReadOutAssembly* Event: m_Events) {
+        Stream(Event, f, File);
+      }
+    }
+    double FileStreamTime = Timer.GetElapsed();
+
+    // (c) The reusable buffer, written to the same ofstream
+    Timer.Reset();
+    for (unsigned int p = 0; p < m_NPasses; ++p) {
+      for (MReadOutAssembly* Event: m_Events) {
+        Buffer.Clear();
+        Buffer.SetPrecision(6);
+        Stream(Event, f, Buffer);
+        File.write(Buffer.Data(), Buffer.Size());
+      }
+    }
+    double BufferTime = Timer.GetElapsed();
+    File.close();
+
+    double MB = Bytes/1024/1024;
+    cout<<"  "<<setw(5)<<left<<Formats[f]<<": "
+        <<"ostringstream "<<setw(9)<<right<<setprecision(1)<<fixed<<MB/StringStreamTime<<" MB/s, "
+        <<"ofstream "<<setw(9)<<right<<MB/FileStreamTime<<" MB/s, "
+        <<"MAsciiBuffer "<<setw(9)<<right<<MB/BufferTime<<" MB/s"
+        <<"  (speed-up: "<<setprecision(2)<<StringStreamTime/BufferTime<<" / "<<FileStreamTime/BufferTime<<", "
+        <<(NDifferent == 0 ? "identical output" : "OUTPUT DIFFERS")<<")"<<endl;
+    if (NDifferent != 0) {
+      cout<<"Error: The output of "<<NDifferent<<" event(s) differs"<<endl;
+      return false;
+    }
+  }
+  cout<<endl;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+EventStreamingBenchmark* g_Prg = 0;
+int g_NInterruptCatches = 1;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Called when an interrupt signal is flagged
+//! All catched signals lead to a well defined exit of the program
+void CatchSignal(int a)
+{
+  if (g_Prg != 0 && g_NInterruptCatches-- > 0) {
+    cout<<"Catched signal Ctrl-C (ID="<<a<<"):"<<endl;
+    g_Prg->Interrupt();
+  } else {
+    abort();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Main program
+int main(int argc, char** argv)
+{
+  // Catch a user interupt for graceful shutdown
+  signal(SIGINT, CatchSignal);
+
+  // Initialize global MEGALIB variables, especially mgui, etc.
+  MGlobal::Initialize("Standalone", "a standalone example program");
+
+  g_Prg = new EventStreamingBenchmark();
+
+  if (g_Prg->ParseCommandLine(argc, argv) == false) {
+    cerr<<"Error during parsing of command line!"<<endl;
+    return -1;
+  }
+  if (g_Prg->Analyze() == false) {
+    cerr<<"Error during analysis!"<<endl;
+    return -2;
+  }
+
+  cout<<"Program exited normally!"<<endl;
+
+  return 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
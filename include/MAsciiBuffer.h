@@ -0,0 +1,155 @@
+/*
+ * MAsciiBuffer.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MAsciiBuffer__
+#define __MAsciiBuffer__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <string>
+#include <ostream>
+#include <streambuf>
+#include <charconv>
+#include <type_traits>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! A reusable character buffer, which formats numbers with to_chars exactly as an ostream with default flags
+//! would do it - including a sticky precision as set via setprecision - but without locales, virtual calls,
+//! and flushes. Once the buffer has grown to the size of the largest event, no memory is allocated anymore.
+//! Types without a fast path are formatted with their operator<< into the same buffer
+class MAsciiBuffer
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MAsciiBuffer();
+  //! Default destructor
+  virtual ~MAsciiBuffer();
+
+  //! Remove the content - the storage and the precision are kept
+  void Clear() { m_Data.clear(); }
+  //! Return the content
+  const string& GetString() const { return m_Data; }
+  //! Return the content
+  const char* Data() const { return m_Data.data(); }
+  //! Return the number of characters
+  size_t Size() const { return m_Data.size(); }
+
+  //! Set the precision of floating point numbers, like setprecision
+  void SetPrecision(int Precision) { m_Precision = Precision; }
+  //! Get the precision of floating point numbers
+  int GetPrecision() const { return m_Precision; }
+
+  //! Append a character
+  MAsciiBuffer& operator<<(char C) { m_Data.push_back(C); return *this; }
+  //! Append a character (as an ostream does, not a number)
+  MAsciiBuffer& operator<<(signed char C) { m_Data.push_back((char) C); return *this; }
+  //! Append a character (as an ostream does, not a number)
+  MAsciiBuffer& operator<<(unsigned char C) { m_Data.push_back((char) C); return *this; }
+  //! Append a text
+  MAsciiBuffer& operator<<(const char* Text) { m_Data.append(Text); return *this; }
+  //! Append a text
+  MAsciiBuffer& operator<<(const string& Text) { m_Data.append(Text); return *this; }
+  //! Append a text
+  MAsciiBuffer& operator<<(const MString& Text) { m_Data.append(Text.Data(), Text.Length()); return *this; }
+  //! Append a boolean as 1 or 0
+  MAsciiBuffer& operator<<(bool Value) { m_Data.push_back(Value == true ? '1' : '0'); return *this; }
+  //! Append a floating point number in the general format with the current precision
+  MAsciiBuffer& operator<<(double Value);
+  //! Append a floating point number in the general format with the current precision
+  MAsciiBuffer& operator<<(float Value) { return operator<<((double) Value); }
+
+  //! Append an integer
+  template <class T> typename enable_if<is_integral<T>::value, MAsciiBuffer&>::type operator<<(T Value) {
+    char Text[24];
+    char* End = to_chars(Text, Text + sizeof(Text), Value).ptr;
+    m_Data.append(Text, End - Text);
+    return *this;
+  }
+
+  //! Append any other type (e.g. MTime) via its operator<<
+  template <class T> typename enable_if<!is_arithmetic<T>::value, MAsciiBuffer&>::type operator<<(const T& Value) {
+    m_Stream.precision(m_Precision);
+    m_Stream<<Value;
+    return *this;
+  }
+
+
+  // protected methods:
+ protected:
+
+
+  // private methods:
+ private:
+  //! No copy constructor
+  MAsciiBuffer(const MAsciiBuffer&) = delete;
+  //! No copying itself
+  MAsciiBuffer& operator=(const MAsciiBuffer&) = delete;
+
+
+  // protected members:
+ protected:
+
+
+  // private members:
+ private:
+  //! The stream buffer of m_Stream, which appends to m_Data
+  class MAppendBuffer : public streambuf
+  {
+   public:
+    //! Default constructor
+    MAppendBuffer(string& Data) : m_Data(Data) {}
+   protected:
+    //! Append one character
+    virtual int_type overflow(int_type C) { if (traits_type::eq_int_type(C, traits_type::eof()) == false) m_Data.push_back((char) C); return C; }
+    //! Append N characters
+    virtual streamsize xsputn(const char* Text, streamsize N) { m_Data.append(Text, N); return N; }
+   private:
+    //! The content of the MAsciiBuffer
+    string& m_Data;
+  };
+
+  //! The content
+  string m_Data;
+  //! The precision of floating point numbers
+  int m_Precision;
+  //! The stream buffer appending to m_Data
+  MAppendBuffer m_AppendBuffer;
+  //! The stream for all types without a fast path
+  ostream m_Stream;
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MAsciiBuffer, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -24,6 +24,7 @@
 #include "MTime.h"
 
 // Forward declarations:
+class MAsciiBuffer;
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -163,6 +164,10 @@ class MAspect
   bool StreamDat(ostream& S, int Version = 1);
   //! Stream the content in MEGAlib's evta format 
   void StreamEvta(ostream& S);
+  //! Dump the content into a reusable character buffer (identical to the ostream version)
+  bool StreamDat(MAsciiBuffer& S, int Version = 1);
+  //! Stream the content in MEGAlib's evta format into a reusable character buffer (identical to the ostream version)
+  void StreamEvta(MAsciiBuffer& S);
 
   bool GetOutOfRange() const { return m_OutOfRange; }
   void SetOutOfRange(const bool X) { m_OutOfRange = X; } 
@@ -0,0 +1,211 @@
+/*
+ * MBinaryEventBlock.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MBinaryEventBlock__
+#define __MBinaryEventBlock__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <cstdint>
+#include <cstring>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! A block of events in the binary event file format: each property of the events, strip hits, hits etc.
+//! is stored in its own column, thus no number has to be formatted and the columns compress well.
+//!
+//! A file starts with the magic "NBEV" and the format version (uint32), followed by the blocks.
+//! A block starts with the magic "NBEB", its length in bytes after this header (uint64), the number
+//! of events (uint32) and the number of columns (uint32), followed by the columns: each has its ID (uint32),
+//! its length in bytes (uint64), and the values. All numbers are little-endian, whatever the byte order of the machine.
+//! A block without events ends the file.
+//!
+//! Columns with unknown IDs are skipped, and missing columns read as zero: thus columns can be added without
+//! changing the version, which is only increased if the meaning of an existing column changes
+class MBinaryEventBlock
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MBinaryEventBlock();
+  //! Default destructor
+  virtual ~MBinaryEventBlock();
+
+  //! Remove all events (the storage is kept)
+  void Clear();
+
+  //! Return the number of events in this block
+  unsigned int GetNEvents() const { return m_NEvents; }
+
+  //! Start writing a new event
+  void NewEvent() { ++m_NEvents; }
+  //! Start reading the next event, return false if all events have been read
+  bool NextEvent();
+
+  //! Append a value to a column
+  template <class T> void Add(unsigned int Column, T Value) {
+    vector<uint8_t>& C = m_Columns[Column];
+    size_t Size = C.size();
+    C.resize(Size + sizeof(T));
+    CopyLittleEndian(&C[Size], &Value, sizeof(T));
+  }
+  //! Append a string to a column
+  void AddString(unsigned int Column, const MString& String);
+
+  //! Read the next value of a column - zero if the column has no more values
+  template <class T> T Get(unsigned int Column) {
+    T Value = 0;
+    const vector<uint8_t>& C = m_Columns[Column];
+    size_t& Position = m_Positions[Column];
+    if (Position + sizeof(T) <= C.size()) {
+      CopyLittleEndian(&Value, &C[Position], sizeof(T));
+      Position += sizeof(T);
+    }
+    return Value;
+  }
+  //! Return the number of bytes of a column, which have not been read yet
+  size_t GetRemaining(unsigned int Column) const { return m_Columns[Column].size() - m_Positions[Column]; }
+  //! Read the next string of a column - empty if the column has no more strings
+  MString GetString(unsigned int Column);
+
+  //! Append the file header to Out
+  static void WriteFileHeader(vector<uint8_t>& Out);
+  //! Return the length of the file header
+  static size_t GetFileHeaderLength() { return 8; }
+  //! Check the file header, return false if this is not a binary event file or its version is not supported
+  static bool CheckFileHeader(const uint8_t* Data, size_t Length);
+
+  //! Copy a number of Length bytes from the native to the little-endian byte order of the file, or back
+  static void CopyLittleEndian(void* To, const void* From, size_t Length) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (size_t i = 0; i < Length; ++i) static_cast<uint8_t*>(To)[i] = static_cast<const uint8_t*>(From)[Length - 1 - i];
+#else
+    memcpy(To, From, Length);
+#endif
+  }
+
+  //! Append this block to Out
+  void Write(vector<uint8_t>& Out) const;
+  //! Set BlockLength to the length of the block starting at Data, or to zero if its header is not complete yet
+  //! Return false if Data does not start with a block
+  static bool GetBlockLength(const uint8_t* Data, size_t Length, size_t& BlockLength);
+  //! Read the block (of the length returned by GetBlockLength()) - return false if the block is corrupt
+  bool Read(const uint8_t* Data, size_t Length);
+
+  //! The version of the file format
+  static const uint32_t c_Version = 1;
+
+  //! The event columns
+  static const unsigned int c_EventID = 0;
+  static const unsigned int c_EventTimeSeconds = 1;
+  static const unsigned int c_EventTimeNanoSeconds = 2;
+  static const unsigned int c_EventUTCSeconds = 3;
+  static const unsigned int c_EventUTCNanoSeconds = 4;
+  static const unsigned int c_EventCL = 5;
+  static const unsigned int c_EventTI = 6;
+  static const unsigned int c_EventFC = 7;
+  static const unsigned int c_EventMJD = 8;
+  static const unsigned int c_EventQuality = 9;
+  static const unsigned int c_EventAnalysisProgress = 10;
+  static const unsigned int c_EventFlags = 11;
+  static const unsigned int c_EventNStripHits = 12;
+  static const unsigned int c_EventNStripHitsTOnly = 13;
+  static const unsigned int c_EventNHits = 14;
+  static const unsigned int c_EventNHitsSim = 15;
+  static const unsigned int c_EventNGuardringHits = 16;
+  static const unsigned int c_EventNSimIAs = 17;
+  //! The texts of the set BD flags
+  static const unsigned int c_EventBDTexts = 18;
+  static const unsigned int c_EventSimIAs = 19;
+  static const unsigned int c_EventSimAspect = 20;
+  static const unsigned int c_EventAspect = 21;
+  //! The strip hit columns
+  static const unsigned int c_StripHitDetectorID = 22;
+  static const unsigned int c_StripHitStripID = 23;
+  static const unsigned int c_StripHitFlags = 24;
+  static const unsigned int c_StripHitUncorrectedADCUnits = 25;
+  static const unsigned int c_StripHitADCUnits = 26;
+  static const unsigned int c_StripHitEnergy = 27;
+  static const unsigned int c_StripHitEnergyResolution = 28;
+  static const unsigned int c_StripHitTiming = 29;
+  static const unsigned int c_StripHitPreampTemp = 30;
+  static const unsigned int c_StripHitNOrigins = 31;
+  static const unsigned int c_StripHitOrigins = 32;
+  //! The hit columns
+  static const unsigned int c_HitPosition = 33;
+  static const unsigned int c_HitPositionResolution = 34;
+  static const unsigned int c_HitEnergy = 35;
+  static const unsigned int c_HitEnergyResolution = 36;
+  static const unsigned int c_HitQuality = 37;
+  static const unsigned int c_HitFlags = 38;
+  static const unsigned int c_HitNStripHits = 39;
+  //! The indices of the strip hits of a hit in the list of strip hits (followed by the T only strip hits) of the event
+  static const unsigned int c_HitStripHits = 40;
+  static const unsigned int c_HitNOrigins = 41;
+  static const unsigned int c_HitOrigins = 42;
+  //! The guard ring hit columns
+  static const unsigned int c_GuardringHitDetectorID = 43;
+  static const unsigned int c_GuardringHitADCUnits = 44;
+  static const unsigned int c_GuardringHitPosition = 45;
+  //! The number of columns
+  static const unsigned int c_NColumns = 46;
+
+
+  // protected methods:
+ protected:
+
+
+  // private methods:
+ private:
+
+
+  // protected members:
+ protected:
+
+
+  // private members:
+ private:
+  //! The number of events
+  unsigned int m_NEvents;
+  //! The number of events read
+  unsigned int m_NReadEvents;
+  //! The values of the columns
+  vector<vector<uint8_t>> m_Columns;
+  //! The read positions in the columns
+  vector<size_t> m_Positions;
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MBinaryEventBlock, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,137 @@
+/*
+ * MBinaryFileDecoder.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MBinaryFileDecoder__
+#define __MBinaryFileDecoder__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Nuclearizer libs
+#include "MBinaryFileReader.h"
+#include "MBinaryFlightDataParser.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Decodes the dataframes of one binary flight data file on its own thread with its own parser.
+//! The decoded blocks are handed out in file order, and are continued by the main parser with
+//! MBinaryFlightDataParser::ParseDecodedBlock(), thus several files can be decoded in parallel
+class MBinaryFileDecoder
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MBinaryFileDecoder();
+  //! Default destructor - stops decoding
+  virtual ~MBinaryFileDecoder();
+
+  //! Set the data selection mode - call before Start()
+  void SetDataSelectionMode(MBinaryFlightDataParserDataModes Mode) { m_Parser.SetDataSelectionMode(Mode); }
+  //! Memory map uncompressed files instead of reading them - call before Start()
+  void SetUseMemoryMapping(bool UseMemoryMapping) { m_Reader.SetUseMemoryMapping(UseMemoryMapping); }
+  //! Set the maximum number of decoded blocks kept ahead - call before Start()
+  void SetMaxQueuedBlocks(unsigned int MaxQueuedBlocks) { m_MaxQueuedBlocks = MaxQueuedBlocks > 0 ? MaxQueuedBlocks : 1; }
+
+  //! Open the file and start decoding it, return false if the file cannot be opened
+  //! A decoder decodes only one file, since its parser keeps the state of the file's data stream
+  bool Start(const MString& FileName);
+  //! Stop decoding and delete all decoded blocks, which have not been handed out
+  void Stop();
+  //! Return the file name
+  MString GetFileName() const { return m_FileName; }
+
+  //! Return the next decoded block - the content of Block is replaced
+  //! Return false at the end of the file
+  bool Next(MBinaryFlightDataParser::decodedblock& Block);
+  //! Return true if reading the file failed
+  bool HasError();
+
+
+  // protected methods:
+ protected:
+  //! The loop of the decoding thread
+  void Run();
+  //! Hand the content of the parser's decoded block to the consumer, return false if we have to stop
+  bool Push();
+  //! Delete the events of a decoded block
+  static void Clear(MBinaryFlightDataParser::decodedblock& Block);
+
+
+  // private methods:
+ private:
+  //! No copy constructor
+  MBinaryFileDecoder(const MBinaryFileDecoder&) = delete;
+  //! No copying itself
+  MBinaryFileDecoder& operator=(const MBinaryFileDecoder&) = delete;
+
+
+  // protected members:
+ protected:
+  //! The file name
+  MString m_FileName;
+  //! The reader of the file
+  MBinaryFileReader m_Reader;
+  //! The parser, which only decodes
+  MBinaryFlightDataParser m_Parser;
+  //! The maximum number of decoded blocks kept ahead
+  unsigned int m_MaxQueuedBlocks;
+
+  //! The decoding thread
+  thread m_Thread;
+  //! Protects the queue and the flags below
+  mutex m_Mutex;
+  //! Signals the consumer that a block (or the end of the file) is available
+  condition_variable m_BlockAvailable;
+  //! Signals the decoding thread that there is space in the queue (or that it has to stop)
+  condition_variable m_SpaceAvailable;
+  //! The decoded blocks
+  deque<MBinaryFlightDataParser::decodedblock> m_Queue;
+  //! True if the file has been decoded completely
+  bool m_IsDone;
+  //! True if a read error occurred
+  bool m_Error;
+  //! True if the decoding thread has to stop
+  bool m_Stop;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MBinaryFileDecoder, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
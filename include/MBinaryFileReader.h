@@ -0,0 +1,168 @@
+/*
+ * MBinaryFileReader.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MBinaryFileReader__
+#define __MBinaryFileReader__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+#include "zlib.h"
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Reads a plain or gzip'ed binary file in large blocks.
+//! A background thread reads (and decompresses) ahead into a bounded queue of blocks,
+//! thus decompression overlaps with the analysis of the previous blocks.
+//! Alternatively, uncompressed files can be memory mapped and are then handed out without any copy
+class MBinaryFileReader
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MBinaryFileReader();
+  //! Default destructor - closes the file
+  virtual ~MBinaryFileReader();
+
+  //! Set the size of a block in bytes - call before Open()
+  void SetBlockSize(unsigned int BlockSize) { m_BlockSize = BlockSize > 0 ? BlockSize : 1; }
+  //! Get the size of a block in bytes
+  unsigned int GetBlockSize() const { return m_BlockSize; }
+  //! Set the maximum number of blocks read ahead - zero reads on the calling thread - call before Open()
+  void SetMaxQueuedBlocks(unsigned int MaxQueuedBlocks) { m_MaxQueuedBlocks = MaxQueuedBlocks; }
+  //! Get the maximum number of blocks read ahead
+  unsigned int GetMaxQueuedBlocks() const { return m_MaxQueuedBlocks; }
+  //! Memory map uncompressed files instead of reading them - call before Open()
+  void SetUseMemoryMapping(bool UseMemoryMapping) { m_UseMemoryMapping = UseMemoryMapping; }
+  //! Return true if uncompressed files are memory mapped
+  bool GetUseMemoryMapping() const { return m_UseMemoryMapping; }
+
+  //! Open the file - it is gzip'ed if the name ends with ".gz" - and start reading ahead
+  bool Open(const MString& FileName);
+  //! Stop reading and close the file
+  void Close();
+  //! Return true if a file is open
+  bool IsOpen() const { return m_IsOpen; }
+  //! Return true if the open file is gzip'ed
+  bool IsZipped() const { return m_IsZipped; }
+  //! Return true if the open file is memory mapped
+  bool IsMapped() const { return m_IsMapped; }
+
+  //! Return the next block of the file in Block, whose old storage is recycled for later blocks
+  //! Return false (and an empty block) at the end of the file or after a read error
+  bool Read(vector<uint8_t>& Block);
+  //! Return the next block of the file as a span, which stays valid until the next call - or, if the file
+  //! is memory mapped, until the file is closed. Return false (and an empty span) at the end of the file
+  bool ReadSpan(const uint8_t*& Data, size_t& Length);
+  //! Return true if reading or decompressing the file failed
+  bool HasError();
+
+
+  // protected methods:
+ protected:
+  //! Read the next block from the file, return false at the end of the file - Error is set on read errors
+  bool ReadBlock(vector<uint8_t>& Block, bool& Error);
+  //! The loop of the read-ahead thread
+  void Run();
+
+
+  // private methods:
+ private:
+  //! No copy constructor
+  MBinaryFileReader(const MBinaryFileReader&) = delete;
+  //! No copying itself
+  MBinaryFileReader& operator=(const MBinaryFileReader&) = delete;
+
+
+  // protected members:
+ protected:
+  //! The block size in bytes
+  unsigned int m_BlockSize;
+  //! The maximum number of blocks read ahead
+  unsigned int m_MaxQueuedBlocks;
+
+  //! True if a file is open
+  bool m_IsOpen;
+  //! True if the current file is gzip'ed
+  bool m_IsZipped;
+  //! The uncompressed file stream
+  ifstream m_In;
+  //! The zlib file stream
+  gzFile m_ZipFile;
+
+  //! The read-ahead thread
+  thread m_Thread;
+  //! Protects the queue, the free blocks and the flags below
+  mutex m_Mutex;
+  //! Signals the consumer that a block (or the end of the file) is available
+  condition_variable m_BlockAvailable;
+  //! Signals the read-ahead thread that there is space in the queue (or that it has to stop)
+  condition_variable m_SpaceAvailable;
+  //! The blocks read ahead
+  deque<vector<uint8_t>> m_Queue;
+  //! Blocks handed back by the consumer for reuse
+  vector<vector<uint8_t>> m_FreeBlocks;
+  //! True if the end of the file has been reached by the reader
+  bool m_EndOfFile;
+  //! True if a read error occurred
+  bool m_Error;
+
+  //! True if uncompressed files are memory mapped
+  bool m_UseMemoryMapping;
+  //! True if the current file is memory mapped
+  bool m_IsMapped;
+  //! The memory mapped file
+  const uint8_t* m_MappedData;
+  //! The size of the memory mapped file
+  size_t m_MappedSize;
+  //! The position of the next span in the memory mapped file
+  size_t m_MappedPosition;
+  //! The last block handed out by ReadSpan if the file is not memory mapped
+  vector<uint8_t> m_SpanBlock;
+  //! True if the read-ahead thread has to stop
+  bool m_Stop;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MBinaryFileReader, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,177 @@
+/*
+ * MBinaryFileWriter.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MBinaryFileWriter__
+#define __MBinaryFileWriter__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+
+// ROOT libs:
+#include "zlib.h"
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Writes a plain or gzip'ed binary file - the counterpart of MBinaryFileReader
+//! In asynchronous mode the data is collected in large buffers, which are written by a background thread.
+//! Gzip'ed files are then compressed buffer by buffer in parallel, each buffer becoming its own gzip member
+//! of the file (like pigz), which any gzip reader (including gzread) decompresses as one stream
+class MBinaryFileWriter
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MBinaryFileWriter();
+  //! Default destructor - closes the file
+  virtual ~MBinaryFileWriter();
+
+  //! Write in the background - call before Open()
+  void SetAsynchronous(bool Asynchronous) { m_Asynchronous = Asynchronous; }
+  //! Return true if the data is written in the background
+  bool GetAsynchronous() const { return m_Asynchronous; }
+  //! Set the number of threads compressing gzip'ed files in asynchronous mode - call before Open()
+  void SetNumberOfCompressionThreads(unsigned int NThreads) { m_NCompressionThreads = NThreads > 0 ? NThreads : 1; }
+  //! Get the number of threads compressing gzip'ed files in asynchronous mode
+  unsigned int GetNumberOfCompressionThreads() const { return m_NCompressionThreads; }
+  //! Set the size of the buffers in asynchronous mode - call before Open()
+  void SetBufferSize(size_t BufferSize) { m_BufferSize = min(max(BufferSize, (size_t) 1), (size_t) 1 << 30); }
+
+  //! Open the file - it is gzip'ed if the name ends with ".gz"
+  bool Open(const MString& FileName);
+  //! Close the file, return false if not all data could be written
+  bool Close();
+  //! Return true if a file is open
+  bool IsOpen() const { return m_IsOpen; }
+  //! Return true if the open file is gzip'ed
+  bool IsZipped() const { return m_IsZipped; }
+
+  //! Write Length bytes
+  bool Write(const uint8_t* Data, size_t Length);
+  //! Write a block of bytes
+  bool Write(const vector<uint8_t>& Block) { return Write(Block.data(), Block.size()); }
+  //! Write a text
+  bool Write(const string& Text) { return Write((const uint8_t*) Text.data(), Text.size()); }
+  //! Write a text
+  bool Write(const MString& Text) { return Write((const uint8_t*) Text.Data(), Text.Length()); }
+  //! Return true if writing failed
+  bool HasError();
+
+
+  // protected methods:
+ protected:
+  //! A buffer written in asynchronous mode
+  struct writejob {
+    //! The data
+    vector<uint8_t> m_Data;
+    //! The compressed data (gzip'ed files only)
+    vector<uint8_t> m_Compressed;
+    //! True if the job can be written
+    bool m_IsReady;
+  };
+
+  //! Hand the current buffer to the background threads
+  void Submit();
+  //! The loop of a compression thread
+  void RunCompression();
+  //! The loop of the writer thread
+  void RunWriter();
+  //! Compress Data into a complete gzip member
+  static bool Compress(const vector<uint8_t>& Data, vector<uint8_t>& Compressed);
+
+
+  // private methods:
+ private:
+  //! No copy constructor
+  MBinaryFileWriter(const MBinaryFileWriter&) = delete;
+  //! No copying itself
+  MBinaryFileWriter& operator=(const MBinaryFileWriter&) = delete;
+
+
+  // protected members:
+ protected:
+  //! True if a file is open
+  bool m_IsOpen;
+  //! True if the current file is gzip'ed
+  bool m_IsZipped;
+  //! The uncompressed file stream
+  ofstream m_Out;
+  //! The zlib file stream
+  gzFile m_ZipFile;
+  //! True if a write error occurred
+  bool m_Error;
+
+  //! True if the data is written in the background
+  bool m_Asynchronous;
+  //! The number of compression threads in asynchronous mode
+  unsigned int m_NCompressionThreads;
+  //! The size of the buffers in asynchronous mode
+  size_t m_BufferSize;
+  //! The buffer, which is currently filled
+  vector<uint8_t> m_Buffer;
+
+  //! The writer thread
+  thread m_WriterThread;
+  //! The compression threads
+  vector<thread> m_CompressionThreads;
+  //! Protects the jobs, the error flag, and the flags below
+  mutex m_Mutex;
+  //! Signals the compression threads that a job (or the stop request) is available
+  condition_variable m_JobAvailable;
+  //! Signals the writer thread that a job is ready (or the stop request)
+  condition_variable m_JobReady;
+  //! Signals the producer that there is space for another job
+  condition_variable m_SpaceAvailable;
+  //! The jobs in file order
+  deque<writejob*> m_Jobs;
+  //! The sequence number of the first job in the queue
+  unsigned long m_FirstJob;
+  //! The sequence number of the next job to compress
+  unsigned long m_NextCompressionJob;
+  //! The written jobs, kept to reuse their buffers
+  vector<writejob*> m_FreeJobs;
+  //! True if the background threads have to stop once all jobs are written
+  bool m_Stop;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MBinaryFileWriter, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
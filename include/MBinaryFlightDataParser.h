@@ -34,6 +34,9 @@ using namespace std;
 #include "MReadOutAssembly.h"
 #include "MModuleEventSaver.h"
 #include "MTimeAndCoordinate.h"
+#include "MPacketKeyRecord.h"
+#include "MReadOutAssemblyQueue.h"
+#include "MThreadPool.h"
 
 // Forward declarations:
 
@@ -74,9 +77,20 @@ class MBinaryFlightDataParser
   void EnableCoincidenceMerging(bool X) {m_CoincidenceEnabled = X;}
   //! Get coincidence merging true/false
   bool GetCoincidenceMerging() const { return m_CoincidenceEnabled; }
+
+  //! Set the number of threads decoding the dataframes - zero decodes them while searching the packets
+  void SetNumberOfDecodingThreads(unsigned int NThreads) { m_NDecodingThreads = NThreads; }
+  //! Get the number of threads decoding the dataframes
+  unsigned int GetNumberOfDecodingThreads() const { return m_NDecodingThreads; }
  
   //! Parse some data, return true if the module is ready to analyze events
-  virtual bool ParseData(vector<uint8_t> Received) ;
+  virtual bool ParseData(const vector<uint8_t>& Received) ;
+  //! Parse some data, return true if the module is ready to analyze events
+  //! If IsPersistent is true, the data must stay valid and unchanged until DetachExternalData() is called:
+  //! it is then parsed in place, and successive calls with contiguous data are not copied at all
+  bool ParseData(const uint8_t* Received, size_t Length, bool IsPersistent);
+  //! Copy the not yet parsed persistent data into the internal buffer - call before the persistent data goes away
+  void DetachExternalData();
   
   //! Initialize the module
   virtual bool Initialize();
@@ -90,17 +104,31 @@ class MBinaryFlightDataParser
   //! Get the IsDone flag
   bool GetIsDone() {return m_IsDone;}
 
+  //! Get the number of times the input stream had to be resynchronized
+  uint64_t GetNumResyncs() const { return m_NumResyncs; }
+  //! Get the number of bytes skipped while resynchronizing the input stream
+  uint64_t GetResyncSkippedBytes() const { return m_ResyncSkippedBytes; }
+
   //! Get access to m_AspectReconstructor
   MAspectReconstruction* GetAspectReconstructor() const { return m_AspectReconstructor; }
 
   // protected methods:
  protected:
+  //! Return an empty read-out assembly, recycled from the pool if possible
+  MReadOutAssembly* NewAssembly();
+  //! Clear the read-out assembly and keep it in the pool for reuse
+  void ReleaseAssembly(MReadOutAssembly* Assembly);
+
+  //! The maximum number of read-out assemblies kept for reuse
+  static const unsigned int c_MaxAssemblyPoolSize = 1024;
 
 
   // private methods:
  private:
   void LoadStripMap(void);
   void LoadCCMap(void);
+  //! Drop all bytes of the search window but the last Keep ones
+  void ClearSBuf(unsigned int Keep = 0);
 
 
 
@@ -115,7 +143,7 @@ class MBinaryFlightDataParser
   MModuleEventSaver* m_EventSaver;
 
   //! internal event list - sorted but unmerged events
-  deque<MReadOutAssembly*> m_EventsBuf;//sorted, unmerged events
+  MReadOutAssemblyQueue m_EventsBuf;//time ordered, unmerged events
   //! The internal event list - final merged events
   deque<MReadOutAssembly*> m_Events;
   //! If true ignore aspect information if not ready
@@ -132,6 +160,9 @@ class MBinaryFlightDataParser
  
   //! The housekeeping file name
   MString m_HousekeepingFileName;
+
+  //! Cleared read-out assemblies for reuse
+  vector<MReadOutAssembly*> m_AssemblyPool;
   
   // private members:
  private:
@@ -151,7 +182,11 @@ class MBinaryFlightDataParser
   vector<uint64_t> LastTimestamps;
   uint64_t m_ComptonWindow;
   vector<uint8_t> m_SBuf;//search buffer for the incoming TCP data stream
+  const uint8_t* m_SData; //the search window: the content of m_SBuf, or persistent external data
+  size_t m_SSize; //the number of bytes in the search window
+  bool m_SExternal; //true if the search window is persistent external data
   unsigned int dx; //index into search buffer
+  bool m_ReleasePacket; //true if the packet last handed out by FindNextPacket is still in the search buffer
   unsigned int m_EventIDCounter;
   string m_LastDateTimeString;
   uint64_t m_LastCorrectedClk;
@@ -170,7 +205,12 @@ class MBinaryFlightDataParser
   uint32_t m_NumRawDataBytes;
   uint32_t m_NumBytesReceived;
   uint32_t m_LostBytes;
-  map<uint64_t,int> m_PacketRecord;
+  //! The number of resyncs of the input stream
+  uint64_t m_NumResyncs;
+  //! The number of bytes skipped during the resyncs
+  uint64_t m_ResyncSkippedBytes;
+  //! The keys of the last received packets to reject duplicates
+  MPacketKeyRecord m_PacketRecord;
   vector<uint16_t> m_PreampTemps;
   
   //! The house-keeping file stream
@@ -243,22 +283,99 @@ public:
 
   };
 
+  //! The events of one dataframe, which has been decoded ahead
+  class decodedframe {
+
+	  public:
+		  uint64_t PacketKey; //the key for the rejection of duplicates
+		  uint8_t Type;
+		  unsigned int Length;
+		  vector<MReadOutAssembly*> Events; //in time order
+
+  };
+
+  //! A part of the data stream decoded ahead: its dataframes and the unprocessed bytes of all other packets
+  class decodedblock {
+
+	  public:
+		  vector<decodedframe> Frames;
+		  vector<uint8_t> OtherPackets;
+		  bool StartsStream; //true for the first block of a data stream (e.g. a file)
+		  vector<uint8_t> Head; //the bytes before the first packet of the stream, they might complete a packet of the previous stream
+		  vector<uint8_t> Tail; //the unparsed bytes at the end of the stream
+		  uint64_t NumResyncs;
+		  uint64_t ResyncSkippedBytes;
+
+  };
+
   
  public:
-  int RawDataframe2Struct( vector<uint8_t> Buf, dataframe * DataOut);
-  bool ComptonDataframe2Struct( vector<uint8_t>& Buf, dataframe * DataOut); 
-  bool ConvertToMReadOutAssemblys( dataframe * DataIn, vector<MReadOutAssembly*> * CEvents);
-  bool SortEventsBuf(void);
+  int RawDataframe2Struct( const uint8_t* Buf, unsigned int BufSize, dataframe * DataOut);
+  bool ComptonDataframe2Struct( const uint8_t* Buf, unsigned int Length, dataframe * DataOut); 
+  bool ConvertToMReadOutAssemblys( dataframe * DataIn, vector<MReadOutAssembly*> * CEvents, bool UsePool = true);
   bool FlushEventsBuf(void);
   bool CheckEventsBuf(void);
   MReadOutAssembly * MergeEvents( deque<MReadOutAssembly*> * EventList );
-  bool FindNextPacket( vector<uint8_t> & NextPacket, unsigned int * idx = NULL );
+  bool FindNextPacket( const uint8_t*& NextPacket, unsigned int& NextPacketLength, unsigned int * idx = NULL );
   bool ResyncSBuf(void);
-  bool ProcessAspect( vector<uint8_t> & NextPacket );
+  bool ProcessAspect( const uint8_t* NextPacket, unsigned int Length );
   bool ProcessAspect_works( vector<uint8_t> & NextPacket );
   bool DecodeDSO( vector<uint8_t> & DSOString, MAspectPacket & DSO_Packet);
   bool DecodeMag( vector<uint8_t> & MagString, MAspectPacket & Mag_Packet);
 
+  //! Only frame the packets and decode the dataframes, which can be done in parallel for several parts of the
+  //! data stream: ParseData then does not produce any events, but collects them in a block - see TakeDecodedBlock()
+  //! Such a parser does not need to be initialized
+  void SetDecodeOnly(bool DecodeOnly) { m_DecodeOnly = DecodeOnly; }
+  //! Return true if the parser only decodes the dataframes
+  bool GetDecodeOnly() const { return m_DecodeOnly; }
+  //! Hand out everything decoded since the last call (decode-only mode)
+  void TakeDecodedBlock(decodedblock& Block);
+  //! Parse what is left at the end of the stream and keep the unparsed bytes as tail of the decoded block (decode-only mode)
+  void FinishDecoding();
+  //! Continue the analysis with a block decoded ahead by another parser, as if its data had been received now
+  //! Return true if the module is ready to analyze events
+  bool ParseDecodedBlock(decodedblock& Block);
+
+ protected:
+  //! Insert an event into the time sorted events buffer
+  void AddToEventsBuf(MReadOutAssembly* E);
+  //! Move the events out of the time window into the final events list, return true if the first one is ready
+  bool ProcessEventsBuf(void);
+
+ private:
+  //! Decode a dataframe into the decoded block, or keep any other packet as is (decode-only mode)
+  void DecodePacket(const uint8_t* Packet, unsigned int Length, uint8_t Type, uint64_t PacketKey);
+  //! Decode a raw or Compton dataframe into its events, return false on a parsing error
+  //! Without the assembly pool this can be called from several threads at once
+  bool DecodeDataframe(const uint8_t* Packet, unsigned int Length, uint8_t Type, vector<MReadOutAssembly*>& Events, bool UsePool);
+  //! Keep a copy of a dataframe for the decoding threads
+  void StageDataframe(const uint8_t* Packet, unsigned int Length, uint8_t Type, uint64_t PacketKey);
+  //! Decode the staged dataframes in parallel and add their events to the events buffer
+  void DecodeStagedDataframes();
+  //! Delete the staged dataframes
+  void ClearStagedDataframes();
+
+  //! True if the parser only decodes the dataframes
+  bool m_DecodeOnly;
+  //! The dataframes decoded and the packets kept since the last TakeDecodedBlock()
+  decodedblock m_DecodedBlock;
+  //! The first bytes of the stream, until the first packet has been found (decode-only mode)
+  vector<uint8_t> m_StreamHead;
+  //! True if a packet has been found in the stream (decode-only mode)
+  bool m_FoundPacket;
+
+  //! The number of threads decoding the dataframes
+  unsigned int m_NDecodingThreads;
+  //! The threads decoding the dataframes
+  MThreadPool m_ThreadPool;
+  //! The dataframes found in the current data, which are decoded by the threads
+  vector<decodedframe> m_StagedFrames;
+  //! The offsets of the staged dataframes in m_StagedBytes
+  vector<size_t> m_StagedOffsets;
+  //! The bytes of the staged dataframes
+  vector<uint8_t> m_StagedBytes;
+
 
   
   
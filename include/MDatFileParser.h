@@ -0,0 +1,181 @@
+/*
+ * MDatFileParser.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MDatFileParser__
+#define __MDatFileParser__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MString.h"
+#include "MTime.h"
+
+// Nuclearizer libs
+#include "MBinaryFileReader.h"
+#include "MReadOutAssembly.h"
+#include "MStripHit.h"
+#include "MHit.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! A fast parser of the dat and evta files written by the event saver - the bulk counterpart of
+//! MReadOutAssembly::GetNextFromDatFile().
+//! The file is read in large blocks (gzip'ed files are decompressed in the background), the lines are
+//! split in place without copying, and the numbers are parsed with from_chars. The events, hits and strip
+//! hits are taken from pools, thus re-reading a file does not allocate once the pools are filled.
+//! Files, which only include sub files ("IN" lines), are followed into the sub files.
+class MDatFileParser
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MDatFileParser();
+  //! Default destructor - deletes the pooled events
+  virtual ~MDatFileParser();
+
+  //! Open the file - it is gzip'ed if the name ends with ".gz"
+  bool Open(const MString& FileName);
+  //! Close the file
+  void Close();
+  //! Return true if a file is open
+  bool IsOpen() const { return m_Main.m_Reader.IsOpen(); }
+
+  //! Read the next event into Event - its content is replaced, and its hits and strip hits are recycled
+  //! Return false at the end of the file
+  bool ReadNext(MReadOutAssembly* Event);
+  //! Return the next event, which has to be handed back with Release() - or nullptr at the end of the file
+  MReadOutAssembly* Next();
+  //! Hand an event obtained from Next() back to the pool
+  void Release(MReadOutAssembly* Event);
+
+  //! Return the number of lines in the events, which could not be parsed
+  unsigned long GetNBadLines() const { return m_NBadLines; }
+  //! Return true if reading a file failed
+  bool HasError() const { return m_Error; }
+
+
+  // protected methods:
+ protected:
+  //! One file being read: its reader and the not yet parsed part of the data
+  struct source {
+    //! The reader
+    MBinaryFileReader m_Reader;
+    //! The data, of which the lines are split in place
+    vector<uint8_t> m_Buffer;
+    //! The block last read, kept to recycle its storage
+    vector<uint8_t> m_Block;
+    //! The position of the next line in the buffer
+    size_t m_Position;
+    //! True if all blocks of the file have been read
+    bool m_EndOfFile;
+  };
+
+  //! Open a source
+  bool Open(source& Source, const MString& FileName);
+  //! Close a source
+  void Close(source& Source);
+  //! Return the next line of a source (without the line end) - false at the end of the source
+  bool ReadLine(source& Source, const char*& Begin, const char*& End);
+  //! Return the next line of the included file, or of the main file - false at the end of the main file
+  //! The end of an included file is returned as an "EN" line, which completes its last event
+  bool NextLine(const char*& Begin, const char*& End);
+  //! Open the file included by an "IN" line - relative names are relative to the main file
+  void Include(MString FileName);
+
+  //! Parse a "SH" line, return false if it is malformed
+  bool ParseStripHit(const char* Pos, const char* End, MReadOutAssembly* Event);
+  //! Parse a "HT" line in dat or in evta format, return false if it is malformed
+  bool ParseHit(const char* Pos, const char* End, MReadOutAssembly* Event);
+  //! Parse a "BD" line, return false if the flag is unknown
+  bool ParseBD(const char* Pos, const char* End, MReadOutAssembly* Event);
+
+  //! Return an empty strip hit from the pool
+  MStripHit* NewStripHit();
+  //! Return an empty hit from the pool
+  MHit* NewHit();
+  //! Clear a strip hit and move it to the pool
+  void ReleaseStripHit(MStripHit* StripHit);
+  //! Clear a hit and move it to the pool
+  void ReleaseHit(MHit* Hit);
+  //! Move the strip hits and hits of the event to the pools and clear the event
+  void Recycle(MReadOutAssembly* Event);
+
+  //! Parse a number after optional blanks (or ';' in evta hits) and advance Pos, return false if there is none
+  template <class T> static bool ParseNumber(const char*& Pos, const char* End, T& Value);
+  //! Parse a time "seconds.nanoseconds" after optional blanks and advance Pos
+  static bool ParseTime(const char*& Pos, const char* End, MTime& Time);
+
+
+  // private methods:
+ private:
+  //! No copy constructor
+  MDatFileParser(const MDatFileParser&) = delete;
+  //! No copying itself
+  MDatFileParser& operator=(const MDatFileParser&) = delete;
+
+
+  // protected members:
+ protected:
+  //! The main file
+  source m_Main;
+  //! The file included by the main file
+  source m_Included;
+  //! The directory of the main file, the base of relative include paths
+  MString m_Directory;
+
+  //! True if a "SE" line of the next event has already been read
+  bool m_HasPendingEvent;
+  //! The name of an included file, which is opened once the current event is complete
+  MString m_PendingInclude;
+  //! The number of lines in the events, which could not be parsed
+  unsigned long m_NBadLines;
+  //! True if reading a file failed
+  bool m_Error;
+
+  //! The pool of events handed back via Release()
+  vector<MReadOutAssembly*> m_EventPool;
+  //! The pool of strip hits
+  vector<MStripHit*> m_StripHitPool;
+  //! The pool of hits
+  vector<MHit*> m_HitPool;
+  //! The maximum number of objects in each pool
+  static const unsigned int c_MaxPoolSize = 1 << 16;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MDatFileParser, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
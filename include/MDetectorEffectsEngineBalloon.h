@@ -34,6 +34,7 @@ using namespace std;
 // Nuclearizer libs:
 #include "MDepthCalibrator.h"
 #include "MReadOutAssembly.h"
+#include "MStripCalibrationPolynomials.h"
 
 // Forward declarations:
 
@@ -286,8 +287,8 @@ private:
 	//! Calibration map between read-out element and guard ring thresholds
 	map<MReadOutElementDoubleStrip, double> m_GuardRingThresholds;
  
-  //! Calibration map between read-out element and fitted function for energy calibration
-  map<MReadOutElementDoubleStrip, TF1*> m_EnergyCalibration;
+  //! Energy calibration polynomials (ADC -> energy) per read-out element, inverted in EnergyToADC
+  MStripCalibrationPolynomials m_EnergyPolynomials;
   //! Calibration map between read-out element and fitted function for energy resolution calibration
   map<MReadOutElementDoubleStrip, TF1*> m_ResolutionCalibration;
   
@@ -80,6 +80,12 @@ class MGUIOptionsDepthCalibration2024 : public MGUIOptions
   //! Check button if working with the Card Cage at UCSD
   TGCheckButton* m_UCSDOverride;
 
+  //! Check button to use the precomputed CTD->depth tables
+  TGCheckButton* m_UseDepthTables;
+
+  //! Check button to cross-check the precomputed CTD->depth tables against the exact calculation
+  TGCheckButton* m_CrossCheckDepthTables;
+
 
 #ifdef ___CLING___
  public:
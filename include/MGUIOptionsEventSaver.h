@@ -86,6 +86,11 @@ class MGUIOptionsEventSaver : public MGUIOptions
   //! Entry field for the time after which to split the file
   MGUIEEntry* m_SplitFileTime;
 
+  //! Checkbutton to write the files in the background
+  TGCheckButton* m_AsynchronousWriting;
+  //! Entry field for the number of compression threads
+  MGUIEEntry* m_NumberOfCompressionThreads;
+
 #ifdef ___CLING___
  public:
   ClassDef(MGUIOptionsEventSaver, 1) // basic class for dialog windows
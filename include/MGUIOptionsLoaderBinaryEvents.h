@@ -0,0 +1,88 @@
+/*
+ * MGUIOptionsLoaderBinaryEvents.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MGUIOptionsLoaderBinaryEvents__
+#define __MGUIOptionsLoaderBinaryEvents__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// ROOT libs:
+#include <TROOT.h>
+#include <TVirtualX.h>
+#include <TGWindow.h>
+#include <TObjArray.h>
+#include <TGFrame.h>
+#include <TGButton.h>
+#include <MString.h>
+#include <TGClient.h>
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MGUIEFileSelector.h"
+#include "MGUIERBList.h"
+#include "MGUIOptions.h"
+
+// Nuclearizer libs:
+#include "MModule.h"
+
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+class MGUIOptionsLoaderBinaryEvents : public MGUIOptions
+{
+  // public Session:
+ public:
+  //! Default constructor
+  MGUIOptionsLoaderBinaryEvents(MModule* Module);
+  //! Default destructor
+  virtual ~MGUIOptionsLoaderBinaryEvents();
+
+  //! Process all button, etc. messages
+  virtual bool ProcessMessage(long Message, long Parameter1, long Parameter2);
+
+  //! The creation part which gets overwritten
+  virtual void Create();
+
+  // protected methods:
+ protected:
+
+  //! Actions after the Apply or OK button has been pressed
+	virtual bool OnApply();
+
+
+  // protected members:
+ protected:
+
+  // private members:
+ private:
+  //! Select which file to load
+  MGUIEFileSelector* m_FileSelector;
+  //! Select the stage after which the events have been saved
+  MGUIERBList* m_CheckpointStage;
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MGUIOptionsLoaderBinaryEvents, 1) // basic class for dialog windows
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -31,6 +31,7 @@
 #include "MGUIEFileSelector.h"
 #include "MGUIOptions.h"
 #include "MGUIERBList.h"
+#include "MGUIEEntry.h"
 
 // Nuclearizer libs:
 #include "MModule.h"
@@ -74,6 +75,11 @@ class MGUIOptionsLoaderMeasurementsBinary : public MGUIOptions
   MGUIERBList* m_DataMode;
   MGUIERBList* m_AspectMode;
   MGUIERBList* m_CoincidenceMode;
+  MGUIERBList* m_ReadMode;
+  //! The number of files decoded in parallel
+  MGUIEEntry* m_NumberOfParallelFiles;
+  //! The number of threads decoding the dataframes
+  MGUIEEntry* m_NumberOfDecodingThreads;
 
 
 #ifdef ___CLING___
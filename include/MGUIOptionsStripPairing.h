@@ -30,6 +30,7 @@
 #include "MString.h"
 #include "MGUIEFileSelector.h"
 #include "MGUIERBList.h"
+#include "MGUIEEntry.h"
 #include "MGUIOptions.h"
 
 // Nuclearizer libs:
@@ -71,6 +72,8 @@ class MGUIOptionsStripPairing : public MGUIOptions
  private:
   //! Select the mode
   MGUIERBList* m_Mode;
+  //! The number of threads which pair the detectors of one event in parallel
+  MGUIEEntry* m_NPairingThreads;
 
 #ifdef ___CLING___
  public:
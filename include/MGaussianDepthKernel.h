@@ -0,0 +1,99 @@
+/*
+ * MGaussianDepthKernel.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MGaussianDepthKernel__
+#define __MGaussianDepthKernel__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! The instruction set levels the kernel can be dispatched to
+enum class MGaussianDepthKernelISA : unsigned int { c_Scalar = 0, c_AVX2 = 1, c_AVX512 = 2 };
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Fused, vectorized calculation of the Gaussian-weighted mean depth and depth sigma
+//! from a CTD->depth grid: Sum(w), Sum(w*z), Sum(w*z^2) are accumulated in a single pass
+class MGaussianDepthKernel
+{
+  // public interface:
+ public:
+  //! Default constructor - selects the best instruction set supported by this CPU
+  MGaussianDepthKernel();
+  //! Default destructor
+  virtual ~MGaussianDepthKernel();
+
+  //! Return true if the given instruction set is supported by the compiler and this CPU
+  static bool IsSupported(MGaussianDepthKernelISA ISA);
+  //! Return the best instruction set supported by this CPU
+  static MGaussianDepthKernelISA GetBestISA();
+  //! Return a human readable name of the instruction set
+  static MString GetISAName(MGaussianDepthKernelISA ISA);
+
+  //! Use the given instruction set - returns false (and does not change anything) if it is not supported
+  bool SetISA(MGaussianDepthKernelISA ISA);
+  //! Return the instruction set in use
+  MGaussianDepthKernelISA GetISA() const { return m_ISA; }
+
+  //! Calculate mean depth and depth sigma for a (stretched and offset) CTD with the given timing noise FWHM
+  //! Returns false if no grid point carries any probability
+  bool Calculate(const vector<double>& CTDs, const vector<double>& Depths, double CTD_s, double NoiseFWHM, double& MeanDepth, double& DepthSigma) const;
+
+  //! The maximum relative error of the vectorized exp approximation used for the weights
+  static const double c_MaxExpRelativeError;
+
+
+  // protected methods:
+ protected:
+
+
+  // private methods:
+ private:
+
+
+  // protected members:
+ protected:
+
+
+  // private members:
+ private:
+  //! The instruction set in use
+  MGaussianDepthKernelISA m_ISA;
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MGaussianDepthKernel, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -26,6 +26,7 @@
 #include "MStripHit.h"
 
 // Forward declarations:
+class MAsciiBuffer;
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -121,12 +122,18 @@ class MHit
   bool StreamDat(ostream& S, int Version = 1);
   //! Stream the content in MEGAlib's evta format 
   void StreamEvta(ostream& S);
+  //! Dump the content into a reusable character buffer (identical to the ostream version)
+  bool StreamDat(MAsciiBuffer& S, int Version = 1);
+  //! Stream the content in MEGAlib's evta format into a reusable character buffer (identical to the ostream version)
+  void StreamEvta(MAsciiBuffer& S);
   
   //! Parse some content from a line
   bool Parse(MString &Line, int Version = 1);
 
   // protected methods:
  protected:
+  //! Collect the origins for the evta format: only those existing both on x and y strips
+  void CollectEvtaOrigins(vector<int>& Origins);
   //MHit() {};
   //MHit(const MHit& NCTHit) {};
 
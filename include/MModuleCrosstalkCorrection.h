@@ -24,6 +24,7 @@
 // MEGAlib libs:
 #include "MGlobal.h"
 #include "MModule.h"
+#include "MStripCrosstalkSolver.h"
 
 
 // Forward declarations:
@@ -49,6 +50,11 @@ class MModuleCrosstalkCorrection : public MModule
   //! Get the calibration file name
   MString GetFileName() const { return m_FileName; }
 
+  //! Set the solver mode (MStripCrosstalkSolver::c_ModeBanded or the reference c_ModeDense)
+  void SetSolverMode(unsigned int Mode) { m_SolverMode = Mode; }
+  //! Get the solver mode
+  unsigned int GetSolverMode() const { return m_SolverMode; }
+
 
 
   //! Initialize the module
@@ -75,7 +81,7 @@ class MModuleCrosstalkCorrection : public MModule
   // private methods:
  private:
   // Method to make the cross-talk correction on a vector of strip hits
-  virtual void CorrectCrosstalk(vector<MStripHit*> StripHits, int det, unsigned int side);
+  virtual void CorrectCrosstalk(vector<MStripHit*>& StripHits, int det, unsigned int side);
 
 
   // protected members:
@@ -88,6 +94,15 @@ class MModuleCrosstalkCorrection : public MModule
   bool m_IsCalibrationLoaded[12][2][3];
   double m_CrosstalkCoeffs[12][2][3][2];
 
+  //! The solver mode
+  unsigned int m_SolverMode;
+  //! The solver of the cross-talk equations
+  MStripCrosstalkSolver m_Solver;
+  //! The strip IDs, measured and corrected energies of the strip hits of one detector side
+  vector<int> m_StripIDs;
+  vector<double> m_Energies;
+  vector<double> m_CorrectedEnergies;
+
 #ifdef ___CLING___
  public:
   ClassDef(MModuleCrosstalkCorrection, 0) // no description
@@ -28,6 +28,7 @@
 #include "MGlobal.h"
 #include "MModule.h"
 #include "MModuleEnergyCalibrationUniversal.h"
+#include "MGaussianDepthKernel.h"
 #include "MDStrip3D.h"
 #include "MDShapeBRIK.h"
 
@@ -78,6 +79,16 @@ class MModuleDepthCalibration2024 : public MModule
   //! Get whether the data came from the card cage at UCSD
   bool GetUCSDOverride() const {return m_UCSDOverride;}
 
+  //! Set whether to use the precomputed CTD->depth tables instead of the exact calculation
+  void SetUseDepthTables( bool Use ) {m_UseDepthTables = Use;}
+  //! Get whether to use the precomputed CTD->depth tables instead of the exact calculation
+  bool GetUseDepthTables() const {return m_UseDepthTables;}
+
+  //! Set whether to cross-check the precomputed CTD->depth tables against the exact calculation
+  void SetCrossCheckDepthTables( bool CrossCheck ) {m_CrossCheckDepthTables = CrossCheck;}
+  //! Get whether to cross-check the precomputed CTD->depth tables against the exact calculation
+  bool GetCrossCheckDepthTables() const {return m_CrossCheckDepthTables;}
+
 
   //! Read the XML configuration
   bool ReadXmlConfiguration(MXmlNode* Node);
@@ -93,47 +104,105 @@ class MModuleDepthCalibration2024 : public MModule
   //! Returns the strip with most energy from vector Strips, also gives back the energy fraction
   MStripHit* GetDominantStrip(std::vector<MStripHit*>& Strips, double& EnergyFraction);
   //! Retrieve the appropriate Depth values given the DetID
-	vector<double> GetDepth(int DetID);
+  const vector<double>& GetDepth(int DetID);
   //! Retrieve the appropriate CTD values given the DetID and Grade
-  vector<double> GetCTD(int DetID, int Grade);
-  //! Normal distribution
-  vector<double> norm_pdf(vector<double> x, double mu, double sigma);
+  const vector<double>& GetCTD(int DetID, int Grade);
+  //! Calculate mean depth and its standard deviation by weighting the depth grid with the CTD probability
+  bool CalculateDepthExact(const vector<double>& CTDs, const vector<double>& Depths, double CTD_s, double Noise, double& MeanDepth, double& DepthSigma);
+  //! Look up mean depth and its standard deviation in the precomputed tables - returns false if outside the tables
+  bool LookupDepthTable(int DetID, int Grade, double CTD_s, double Noise, double& MeanDepth, double& DepthSigma);
+  //! Build the CTD range cache and (if enabled) the depth tables for all loaded detectors and grades
+  void BuildDepthTables();
+  //! Determine the range of timing noise FWHM values the depth tables have to cover
+  void GetTimingNoiseRange(double& NoiseMin, double& NoiseMax);
 	//! Adds a Depth-to-CTD relation
 	bool AddDepthCTD(vector<double> depthvec, vector<vector<double>> ctdarr, int DetID, unordered_map<int, vector<double>>& DepthGrid, unordered_map<int,vector<vector<double>>>& CTDMap);
   //! Determine the Grade (geometry of charge sharing) of the Hit
   int GetHitGrade(MHit* H);
   //! Load in the specified coefficients file
   bool LoadCoeffsFile(MString FName);
-  //! Return the coefficients for a pixel
-  vector<double>* GetPixelCoeffs(int pixel_code);
+  //! Return the index of a pixel in the dense calibration tables, or -1 if it has no coefficients
+  int GetPixelIndex(int DetID, int XStripID, int YStripID);
+  //! Return the index of a strip in the dense TAC calibration tables, or -1 if it is out of range
+  int GetStripIndex(int DetID, int StripID) const;
+  //! Clear and size the dense per-pixel and per-strip calibration tables
+  void ResetCalibrationTables();
   //! Load the splines file
   bool LoadSplinesFile(MString FName);
   //! Load the TAC Calibration file
   bool LoadTACCalFile(MString FName);
-  //! Get the timing FWHM noise for the specified pixel and Energy
-  double GetTimingNoiseFWHM(int pixel_code, double Energy);
+  //! Get the timing FWHM noise for the specified pixel index and Energy
+  double GetTimingNoiseFWHM(int PixelIndex, double Energy);
 
 
   // private methods
   private:
 
 
+  // protected types:
+ protected:
+  //! The precomputed CTD->depth relation for one detector and grade
+  class DepthTable {
+   public:
+    DepthTable() : HasRelation(false), CTDMin(0), CTDMax(0), IsTabulated(false), 
+      NCTDBins(0), CTDStart(0), InvCTDBinWidth(0), NNoiseBins(0), LogNoiseStart(0), InvLogNoiseBinWidth(0) {}
+
+    //! True if a CTD->depth relation exists for this detector and grade
+    bool HasRelation;
+    //! The cached minimum and maximum of the CTD grid
+    double CTDMin;
+    double CTDMax;
+
+    //! True if the mean/sigma table below has been filled
+    bool IsTabulated;
+    //! The CTD axis of the table
+    unsigned int NCTDBins;
+    double CTDStart;
+    double InvCTDBinWidth;
+    //! The (logarithmic) noise axis of the table
+    unsigned int NNoiseBins;
+    double LogNoiseStart;
+    double InvLogNoiseBinWidth;
+    //! Pairs of mean depth and depth sigma at index 2*(NoiseBin*NCTDBins + CTDBin)
+    vector<float> Values;
+  };
+
+
   // protected members:
  protected:
 
-  unordered_map<int, vector<double>> m_Coeffs;
+  //! Maximum number of detectors in the dense calibration tables
+  static const int c_MaxDetectors = 16;
+  //! Maximum number of strips per side in the dense calibration tables
+  static const int c_MaxStrips = 64;
+
+  // Dense per-pixel calibration tables (structure of arrays), indexed by
+  // (DetID*c_MaxStrips + XStripID)*c_MaxStrips + YStripID
+  vector<double> m_PixelStretch;
+  vector<double> m_PixelOffset;
+  vector<double> m_PixelNoiseFWHM;
+  vector<double> m_PixelChi2;
+  vector<unsigned char> m_PixelHasCoeffs;
   double m_Coeffs_Energy;
-  unordered_map<int, unordered_map<int, vector<double>>> m_HVTACCal;
-  unordered_map<int, unordered_map<int, vector<double>>> m_LVTACCal;
+
+  // Dense per-strip TAC calibration tables, indexed by DetID*c_MaxStrips + StripID
+  // Strips without calibration have slope and offset 0, i.e. they look like missing timing
+  vector<double> m_HVTACSlope;
+  vector<double> m_HVTACOffset;
+  vector<double> m_LVTACSlope;
+  vector<double> m_LVTACOffset;
+
   MString m_CoeffsFile;
   MString m_SplinesFile;
   MString m_TACCalFile;
-  unordered_map<int, MString> m_DetectorNames;
-  unordered_map<int, double> m_Thicknesses;
-  unordered_map<int, int> m_NXStrips;
-  unordered_map<int, int> m_NYStrips;
-  unordered_map<int, double> m_XPitches;
-  unordered_map<int, double> m_YPitches;
+
+  // Per-detector geometry, indexed by DetID
+  MString m_DetectorNames[c_MaxDetectors];
+  double m_Thicknesses[c_MaxDetectors];
+  int m_NXStrips[c_MaxDetectors];
+  int m_NYStrips[c_MaxDetectors];
+  double m_XPitches[c_MaxDetectors];
+  double m_YPitches[c_MaxDetectors];
   uint64_t m_NoError;
   uint64_t m_Error1;
   uint64_t m_Error2;
@@ -148,6 +217,28 @@ class MModuleDepthCalibration2024 : public MModule
   // The CTD Map maps each detector (int) to a 2D array of CTD values.
   unordered_map<int, vector<vector<double>>> m_CTDMap;
   unordered_map<int, vector<double>> m_DepthGrid;
+
+  //! Number of grades with their own CTD->depth table
+  static const int c_NDepthTableGrades = 4;
+  //! Number of CTD bins of each depth table
+  static const unsigned int c_DepthTableCTDBins = 512;
+  //! Number of (logarithmic) timing noise bins of each depth table
+  static const unsigned int c_DepthTableNoiseBins = 32;
+  //! The CTD->depth tables indexed by DetID*c_NDepthTableGrades + Grade
+  vector<DepthTable> m_DepthTables;
+
+  //! The (vectorized) kernel for the exact CTD->depth calculation
+  MGaussianDepthKernel m_DepthKernel;
+
+  //! Use the depth tables instead of the exact calculation
+  bool m_UseDepthTables;
+  //! Cross-check the depth tables against the exact calculation
+  bool m_CrossCheckDepthTables;
+  //! Statistics of the cross-check
+  uint64_t m_NDepthTableChecks;
+  uint64_t m_NDepthTableMisses;
+  double m_MaxDepthTableMeanDeviation;
+  double m_MaxDepthTableSigmaDeviation;
   bool m_SplinesFileIsLoaded;
   bool m_CoeffsFileIsLoaded;
   bool m_TACCalFileIsLoaded;
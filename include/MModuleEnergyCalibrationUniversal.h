@@ -28,6 +28,7 @@
 // Neclearizer libe:
 #include "MModule.h"
 #include "MCalibratorEnergy.h"
+#include "MStripCalibrationPolynomials.h"
 #include "MGUIExpoEnergyCalibration.h"
 
 // Forward declarations:
@@ -92,6 +93,31 @@ class MModuleEnergyCalibrationUniversal : public MModule
 	//! Standalone function to return ADC of certain strip given energy
 	double GetADC(MReadOutElementDoubleStrip R, double energy);
 
+  //! Flags of the batch calibration: all calibrations were found, and the energy is not negative
+  static const unsigned char c_CalibrationOK = 0;
+  //! Flag of the batch calibration: the strip has no energy calibration (nothing else is done)
+  static const unsigned char c_NoEnergyCalibration = 1;
+  //! Flag of the batch calibration: the strip has no temperature calibration (the ADC value is not corrected)
+  static const unsigned char c_NoTemperatureCalibration = 2;
+  //! Flag of the batch calibration: the strip has no energy resolution calibration (the resolution is zero)
+  static const unsigned char c_NoResolutionCalibration = 4;
+  //! Flag of the batch calibration: the energy was negative above 100 ADC units (it is set to zero)
+  static const unsigned char c_NegativeEnergy = 8;
+
+  //! Return the strip key of the batch calibration, or -1 if the strip is not in the calibration tables
+  int GetCalibrationSlot(int DetectorID, bool IsPositiveStrip, int StripID) const { return m_EnergyPolynomials.GetSlot(DetectorID, IsPositiveStrip, StripID); }
+  //! Return the strip key of the batch calibration, or -1 if the strip is not in the calibration tables
+  int GetCalibrationSlot(const MReadOutElementDoubleStrip& R) const { return m_EnergyPolynomials.GetSlot(R); }
+
+  //! Calibrate N strip hits in one pass (temperature correction, energy, energy resolution), given their
+  //! strip keys (see GetCalibrationSlot) and ADC values, and, if the temperature correction is enabled,
+  //! the preamp temperatures (nullptr: no temperature correction).
+  //! Writes the (corrected) ADC values, energies, one-sigma energy resolutions, and the c_... flags
+  //! of each strip hit into the output arrays, each of which may be nullptr except the energies.
+  //! Each calibration table is evaluated once for all strip hits
+  void CalibrateEnergies(unsigned int N, const int* Slots, const double* ADCs, const double* PreampTemperatures,
+                         double* CorrectedADCs, double* Energies, double* EnergyResolutions, unsigned char* Flags);
+
 
   // protected methods:
  protected:
@@ -120,12 +146,25 @@ class MModuleEnergyCalibrationUniversal : public MModule
   //vector<vector<MCalibratorEnergy*> > m_Calibrators;
   //! Associated detector IDs
   vector<unsigned int> m_DetectorIDs;
-  //! Calibration map between read-out element and fitted function
-  map<MReadOutElementDoubleStrip, TF1*> m_Calibration;
-  //! Resolution Calibration map between read-out element and fitted function
-  map<MReadOutElementDoubleStrip, TF1*> m_ResolutionCalibration;
-  //! Temperature Calibration map between read-out element and fitted function
-  map<MReadOutElementDoubleStrip, TF1*> m_TemperatureCalibration;  
+  //! The energy calibration polynomials (ADC -> energy) per strip, including their inverses for GetADC
+  MStripCalibrationPolynomials m_EnergyPolynomials;
+  //! The energy resolution calibration polynomials (energy -> 1 sigma resolution) per strip, same slots as the energy calibration
+  MStripCalibrationPolynomials m_ResolutionPolynomials;
+  //! The temperature calibration polynomials (preamp temperature -> ADC scale) per strip, same slots as the energy calibration
+  MStripCalibrationPolynomials m_TemperaturePolynomials;
+
+  //! The input and output arrays of the batch calibration of one event, which only grow
+  vector<int> m_BatchSlots;
+  vector<double> m_BatchADCs;
+  vector<double> m_BatchTemperatures;
+  vector<double> m_BatchCorrectedADCs;
+  vector<double> m_BatchEnergies;
+  vector<double> m_BatchEnergyResolutions;
+  vector<unsigned char> m_BatchFlags;
+  //! The scratch arrays of CalibrateEnergies: the slots evaluated, the values of the outputs not requested and the temperature scales, and the flags if not requested
+  vector<int> m_EvaluationSlots;
+  vector<double> m_EvaluationValues;
+  vector<unsigned char> m_EvaluationFlags;
  
 #ifdef ___CLING___
  public:
@@ -29,6 +29,9 @@ using namespace std;
 
 // Nuclearizer libs:
 #include "MModule.h"
+#include "MBinaryEventBlock.h"
+#include "MBinaryFileWriter.h"
+#include "MAsciiBuffer.h"
 
 // Forward declarations:
 
@@ -78,6 +81,16 @@ class MModuleEventSaver : public MModule
   //! Set the time after which the file should be split
   void SetSplitFileTime(MTime SplitFileTime) { m_SplitFileTime = SplitFileTime; }
   
+  //! Return true if the files are written (and compressed) in the background
+  bool GetAsynchronousWriting() const { return m_AsynchronousWriting; }
+  //! Set whether the files are written (and compressed) in the background
+  void SetAsynchronousWriting(bool AsynchronousWriting) { m_AsynchronousWriting = AsynchronousWriting; }
+  
+  //! Return the number of threads compressing gzip'ed files in the background
+  unsigned int GetNumberOfCompressionThreads() const { return m_NumberOfCompressionThreads; }
+  //! Set the number of threads compressing gzip'ed files in the background
+  void SetNumberOfCompressionThreads(unsigned int NumberOfCompressionThreads) { m_NumberOfCompressionThreads = NumberOfCompressionThreads > 0 ? NumberOfCompressionThreads : 1; }
+  
   //! Set the start area of the far field simulation if there was any
   void SetStartAreaFarField(double Area) { m_StartAreaFarField = Area; } 
   //! Set the number if simulated events
@@ -105,15 +118,21 @@ class MModuleEventSaver : public MModule
   static const unsigned int c_EvtaFile = 2;
   static const unsigned int c_SimFile  = 3;
   static const unsigned int c_TraFile  = 4;
+  static const unsigned int c_BinaryFile = 5;
   
   // protected methods:
  protected:
   //! Start a new sub-file
   bool StartSubFile();
+  //! Open an output file with the current writing options
+  bool OpenFile(MBinaryFileWriter& File, MString FileName);
    
   //!
   void WriteHeader();
 
+  //! Write the collected events as one block to the binary file
+  bool WriteBinaryBlock();
+
   //!
   void DumpBasic(MReadOutAssembly* Event);
 
@@ -159,13 +178,27 @@ class MModuleEventSaver : public MModule
   //! If we split the file, this is the time in seconds after which we split
   MTime m_SplitFileTime;
   
+  //! Write the files in the background
+  bool m_AsynchronousWriting;
+  //! The number of threads compressing gzip'ed files in the background
+  unsigned int m_NumberOfCompressionThreads;
+  
   //! Main output stream for file
-  MFile m_Out;
+  MBinaryFileWriter m_Out;
   //! Sub-output stream if we split it into multiple files
-  MFile m_SubFileOut;
+  MBinaryFileWriter m_SubFileOut;
+  //! The buffer the events are formatted in - kept to reuse its memory
+  MAsciiBuffer m_EventBuffer;
   //! Start time in case we split the file in mutliples
   MTime m_SubFileStart;
 
+  //! The events collected for the next block of the binary format
+  MBinaryEventBlock m_BinaryBlock;
+  //! The serialized block - kept to reuse its memory
+  vector<uint8_t> m_BinaryBuffer;
+  //! The number of events per block of the binary format
+  static const unsigned int c_BinaryEventsPerBlock = 1024;
+
   //! The start area of far field simulations
   double m_StartAreaFarField;
   //! The numebr of simulated events
@@ -0,0 +1,134 @@
+/*
+ * MModuleLoaderBinaryEvents.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MModuleLoaderBinaryEvents__
+#define __MModuleLoaderBinaryEvents__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Nuclearizer libs:
+#include "MModuleLoaderMeasurements.h"
+#include "MBinaryEventBlock.h"
+#include "MBinaryFileReader.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Loads the binary event files (*.bev) written by the event saver, i.e. checkpoints of a pipeline.
+//! The events keep the analysis progress they had when they were saved, and this module stands in
+//! for the modules done before the checkpoint. The checkpoint stage is configured, since the module types
+//! have to be known when the pipeline is set up, before any file is opened - events which contradict it are an error
+class MModuleLoaderBinaryEvents : public MModuleLoaderMeasurements
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MModuleLoaderBinaryEvents();
+  //! Default destructor
+  virtual ~MModuleLoaderBinaryEvents();
+  
+  //! Create a new object of this class 
+  virtual MModuleLoaderBinaryEvents* Clone() { return new MModuleLoaderBinaryEvents(); }
+
+  //! The Open method has to be derived from MFileEvents to initialize the include file:
+  virtual bool Open(MString FileName, unsigned int Way);
+
+  //! Initialize the module
+  virtual bool Initialize();
+
+  //! Finalize the module
+  virtual void Finalize();
+
+  //! Main data analysis routine, which updates the event to a new level 
+  virtual bool AnalyzeEvent(MReadOutAssembly* Event);
+
+  //! Return the stage after which the events have been saved
+  unsigned int GetCheckpointStage() const { return m_CheckpointStage; }
+  //! Set the stage after which the events have been saved, which determines the modules this module stands in for
+  void SetCheckpointStage(unsigned int CheckpointStage);
+
+    //! Show the options GUI - only binary event files can be selected
+  virtual void ShowOptionsGUI();
+
+  //! Read the configuration data from an XML node
+  virtual bool ReadXmlConfiguration(MXmlNode* Node);
+  //! Create an XML node tree from the configuration
+  virtual MXmlNode* CreateXmlConfiguration();
+
+
+  //! The checkpoint stages: after the detector effects engine (event ordering, aspect, detector effects engine)
+  static const unsigned int c_CheckpointAfterDetectorEffectsEngine = 0;
+  //! ... after the strip pairing (additionally energy calibration and strip pairing)
+  static const unsigned int c_CheckpointAfterStripPairing = 1;
+
+
+  // protected methods:
+ protected:
+  //! Set the module types from the checkpoint stage
+  void SetCheckpointModuleTypes();
+  //! Append the next data of the file to the buffer - return false at the end of the file
+  bool FillBuffer();
+  //! Read the next block of events - return false at the end of the file or if the file is corrupt
+  bool ReadNextBlock();
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+
+
+  // private members:
+ private:
+  //! The reader of the file
+  MBinaryFileReader m_Reader;
+  //! The data read from the file, which has not been parsed yet (starting at m_BufferPosition)
+  vector<uint8_t> m_Buffer;
+  //! The position of the first not parsed byte in the buffer
+  size_t m_BufferPosition;
+  //! The last data read from the file
+  vector<uint8_t> m_ReadBuffer;
+  //! The current block of events
+  MBinaryEventBlock m_Block;
+  //! True if the block, which ends the file, has been read
+  bool m_IsEndOfFile;
+  //! The stage after which the events have been saved
+  unsigned int m_CheckpointStage;
+  
+  
+#ifdef ___CLING___
+ public:
+  ClassDef(MModuleLoaderBinaryEvents, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -18,11 +18,11 @@
 
 // Standard libs:
 #include <list>
+#include <deque>
 #include <fstream>
 using namespace std;
 
 // ROOT libs:
-#include "zlib.h"
 
 // MEGAlib libs:
 #include "MGlobal.h"
@@ -30,6 +30,8 @@ using namespace std;
 // Nuclearizer libs
 #include "MModule.h"
 #include "MBinaryFlightDataParser.h"
+#include "MBinaryFileReader.h"
+#include "MBinaryFileDecoder.h"
 #include "MGUIExpoAspectViewer.h"
 
 // Forward declarations:
@@ -55,6 +57,16 @@ class MModuleLoaderMeasurementsBinary : public MModule, public MBinaryFlightData
   MString GetFileName() const { return m_FileName; }
   //! Set the file name
   void SetFileName(const MString& Name) { m_FileName = Name; }
+
+  //! Return true if uncompressed files are memory mapped instead of read in blocks
+  bool GetUseMemoryMapping() const { return m_Reader.GetUseMemoryMapping(); }
+  //! Set if uncompressed files are memory mapped instead of read in blocks
+  void SetUseMemoryMapping(bool UseMemoryMapping) { m_Reader.SetUseMemoryMapping(UseMemoryMapping); }
+
+  //! Return the number of files of a file list, which are decoded in parallel
+  unsigned int GetNumberOfParallelFiles() const { return m_NumberOfParallelFiles; }
+  //! Set the number of files of a file list, which are decoded in parallel (1: one file after the other)
+  void SetNumberOfParallelFiles(unsigned int NumberOfParallelFiles) { m_NumberOfParallelFiles = NumberOfParallelFiles > 0 ? NumberOfParallelFiles : 1; }
  
   //! Return if the module is ready to analyze events
   virtual bool IsReady();
@@ -88,6 +100,11 @@ class MModuleLoaderMeasurementsBinary : public MModule, public MBinaryFlightData
 
   //! Open next file, return false on error
   bool OpenNextFile();
+
+  //! Start decoding the next files until the maximum number of files is decoded in parallel, return false on error
+  bool StartDecoders();
+  //! Stop all decoders
+  void StopDecoders();
   
   // private methods:
  private:
@@ -104,18 +121,21 @@ class MModuleLoaderMeasurementsBinary : public MModule, public MBinaryFlightData
 
   //! The file name
   MString m_FileName;
-  //! True if the current fiule is gzip'ed
-  bool m_IsZipped;
-  //! The current binary data stream uncompressed
-  ifstream m_In;
-  //! The basic file stream for zlib
-  gzFile m_ZipFile;
+  //! The reader of the current (plain or gzip'ed) binary data file
+  MBinaryFileReader m_Reader;
   //! A list of all binary data files
   vector<MString> m_BinaryFileNames;
   //! The currently open binary file name (-1 none is open)
   int m_OpenFileID;
   //! Flag indicating that file read is over
   bool m_FileIsDone;
+
+  //! The number of files decoded in parallel
+  unsigned int m_NumberOfParallelFiles;
+  //! The decoders of the files decoded in parallel, in file order
+  deque<MBinaryFileDecoder*> m_Decoders;
+  //! The block of the first decoder, which is currently parsed
+  MBinaryFlightDataParser::decodedblock m_CurrentBlock;
   
   
 #ifdef ___CLING___
@@ -17,6 +17,12 @@
 
 
 // Standard libs:
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
 
 // ROOT libs:
 
@@ -33,6 +39,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 
+//! Loads the read-out assemblies (*.roa) - a reader thread parses the file and converts the read-outs
+//! into strip hits ahead of the analysis, keeping a bounded queue of ready events
 class MModuleLoaderMeasurementsROA : public MModuleLoaderMeasurements
 {
   // public interface:
@@ -54,6 +62,9 @@ class MModuleLoaderMeasurementsROA : public MModuleLoaderMeasurements
   //! Initialize the module
   virtual void Finalize();
 
+  //! Return true if an event has been read ahead, or if the end of the file has been reached
+  virtual bool IsReady();
+
   //! Main data analysis routine, which updates the event to a new level 
   virtual bool AnalyzeEvent(MReadOutAssembly* Event);
 
@@ -68,6 +79,18 @@ class MModuleLoaderMeasurementsROA : public MModuleLoaderMeasurements
   //! Reads one event from file - return zero in case of no more events present or an Error occured
   bool ReadNextEvent(MReadOutAssembly* Event);
 
+  //! Start the reader thread
+  void StartReader();
+  //! Stop the reader thread and delete the events read ahead
+  void StopReader();
+  //! The loop of the reader thread
+  void RunReader();
+
+  //! Return an empty assembly from the pool
+  MReadOutAssembly* NewAssembly();
+  //! Clear the assembly and return it to the pool
+  void ReleaseAssembly(MReadOutAssembly* Event);
+
   // private methods:
  private:
 
@@ -90,6 +113,25 @@ class MModuleLoaderMeasurementsROA : public MModuleLoaderMeasurements
 
   //! The read-out file
   MFileReadOuts m_ROAFile;
+
+  //! The reader thread
+  thread m_ReaderThread;
+  //! Protects the queue, the pool, and the flags below
+  mutex m_Mutex;
+  //! Signals the analysis that an event (or the end of the file) is available
+  condition_variable m_EventAvailable;
+  //! Signals the reader thread that there is space in the queue (or that it has to stop)
+  condition_variable m_SpaceAvailable;
+  //! The events read ahead
+  deque<MReadOutAssembly*> m_Events;
+  //! Recycled assemblies
+  vector<MReadOutAssembly*> m_AssemblyPool;
+  //! True if the reader thread has read all events
+  bool m_IsEndOfFile;
+  //! True if the reader thread has to stop
+  bool m_StopReader;
+  //! The maximum number of events read ahead
+  static const unsigned int c_MaxQueuedEvents = 1024;
   
   
 #ifdef ___CLING___
@@ -32,6 +32,7 @@ using namespace std;
 #include "MBinaryFlightDataParser.h"
 #include "MGUIExpoAspectViewer.h"
 #include "MGUIExpoReceiver.h"
+#include "MAsciiBuffer.h"
 
 // Forward declarations:
 
@@ -157,6 +158,8 @@ class MModuleReceiverBalloon : public MModule, public MBinaryFlightDataParser
   
   //! Output stream for roa file
   ofstream m_Out;
+  //! The buffer the events are formatted in before they are written to the roa file
+  MAsciiBuffer m_OutBuffer;
 
   
 #ifdef ___CLING___
@@ -30,7 +30,7 @@ c) The algorithm then selects the next lowest weight of the remaining matrix ele
 *******
 
 INPUT:
-The program takes an MReadOutAssembly* as input. The first function, GetStripHits, fills the following member variables:
+The program takes an MReadOutAssembly* as input. The first function, MStripPairingEngine::Load(), fills the following (now fixed-size array) variables:
 
 vector<vector<int> > stripHits: a list of all the strip numbers that were hit
 vector<vector<float> > energy: a list of the energy corresponding to the strip hits
@@ -46,7 +46,7 @@ The energy of the combination is the sum of the energies of each adjacent strip.
 
 *****
 Multiple Hits on One Strip:
-The program first checks if the number of strip hits on the x strip is the same as that on the y strip. If the number of strip hits on x and y are not equal, the program considers the possibility of multiple hits on whichever side has less strip hits (done in CheckMultipleHits()).
+The program first checks if the number of strip hits on the x strip is the same as that on the y strip. If the number of strip hits on x and y are not equal, the program considers the possibility of multiple hits on whichever side has less strip hits.
 
 To consider this possibility, the program makes a list of all unordered pairs from stripsHit.at(axis) (including the strip sharing hits). These pairs are labeled by multiplying the smaller strip number by 100 and adding the result to the larger strip number (done in AddMultipleHits(axis)). For example, strip 112 is strip 1 combined with strip 12. Strip 1751 is strip 17 combined with charge sharing between strips 1 and 2.
 
@@ -60,7 +60,7 @@ Once a pair has been chosen, any other x or y strips that conflict with the x or
 
 This example also indicates another problem that must be resolved: strip numbers like 555 and 655 are not valid, because they mean the combination of strip 5 and strip sharing between 5 and 6, and the combination of strip 6 and strip sharing between 5 and 6, respectively. These "bad" strip combinations should be eliminated.
 
-In order to prevent conflicting strips from being chosen, matrices called the kill matrices are created to keep track of which strips "kill", or eliminate, other strips. There is one kill matrix for x and one for y. The kill matrix elements, indexed by strip numbers i and j, are 0 if strip i and strip j can both be chosen and non-zero if strip i and j cannot both be chosen. Each element of the kill matrices is the vector sum of the constituent strips (done in InitializeKillMatrices(), ExpandKillMatrix(axis), CheckForAdjacentStrips(), and AddMultipleHits(axis)). Note that the diagnoal elements of the kill matrices are always set to 1 when the kill matrices are initialized.
+In order to prevent conflicting strips from being chosen, matrices called the kill matrices are created to keep track of which strips "kill", or eliminate, other strips. There is one kill matrix for x and one for y. The kill matrix elements, indexed by strip numbers i and j, are 0 if strip i and strip j can both be chosen and non-zero if strip i and j cannot both be chosen. Each element of the kill matrices is the vector sum of the constituent strips (done in CheckForAdjacentStrips(), and AddMultipleHits(axis)). Note that the diagnoal elements of the kill matrices are always set to 1 when the kill matrices are initialized.
 
 After each pair is chosen, the program checks whether the kill matrix element (xStripChosen, anyOtherXStrip) is zero or non-zero. If it's non-zero, all weight matrix elements containing the not chosen strip are set to -1 (done in ConflictingStrips(xIndex, yIndex)).
 
@@ -68,7 +68,7 @@ The kill matrices are also used to get rid of "bad" strip combinations, such as
 
 With the mechanisms in place to get rid of bad combinations and eliminate conflicting strips, the list of final pairs can be calculated. The program searches for the lowest weight that is still a positive number and selects those strips as the first pair (done in FindMinWeight(), FindFinalPairs()). It then sets the weights of the selected strips to -1 and eliminates any conflicting strips (done in ConflictingStrips(xIndex,yIndex), FindFinalPairs()). This process is repeated until all the weights are -1.
 
-The program checks whether all strips were paired (done in CheckAllStripsWerePaired()). The function returns true if all strips were paired, and false otherwise. Situations where not all of the strips were paired can occur; for example, a noise hit, a dead strip, or a hit with energy close to the threshold energy. NOTE: It should probably add a flag or something if all strips weren't paired, but currently DOES NOT DO THIS!!
+Not all strips might get paired. Situations where not all of the strips were paired can occur; for example, a noise hit, a dead strip, or a hit with energy close to the threshold energy. NOTE: It should probably add a flag or something if all strips weren't paired, but currently DOES NOT DO THIS!!
 
  
 *****
@@ -79,16 +79,22 @@ The final pairs are then decoded: for example, if strip 55 is chosen, then the p
 *****
 Other things:
 Event Quality:
-The detector quality factor is the average of all the hit quality factors. The event quality factor is the average of all the detector quality factors. The event quality factor is added to the input MReadOutAssembly (done in CalculateDetectorQuality(), CalculateEventQuality()).
+The detector quality factor is the average of all the hit quality factors. The event quality factor is the average of all the detector quality factors. The event quality factor is added to the input MReadOutAssembly (done in MStripPairingEngine::Pair(), CalculateEventQuality()).
 
 
-CheckInitialEnergyDifference: STILL BEING WORKED OUT!!
- 
 
 *********
 
 
 Clio Sleator, 2014
+
+
+*****
+Implementation:
+All per-detector state and the functions named above (except WriteHits and CalculateEventQuality) live in MStripPairingEngine, which is reused for all detectors and events. It keeps the strip lists in fixed-capacity arrays sized for the multiplicity cuts, stores the kill matrices as a bitmask of the original strips per strip combination (an element is non-zero exactly if two combinations share an original strip, and a combination is bad exactly if it contains an original strip twice), and it does not allocate memory once its weight matrix has grown to the largest event. The results are identical to the original implementation. Each detector has its own engine, thus the detectors of one event can be paired in parallel on a small thread pool (XML tag "NumberOfPairingThreads", default 0: no threads); loading the strips and writing the hits stay on the calling thread.
+
+Optimal assignment mode:
+With Mode = 2 (XML tag "Mode"), the greedy search in each step of FindFinalPairs() is replaced by an exact assignment (done in MStripPairingEngine::FindOptimalPairs()). Among all sets of x-y pairs without conflicting strips, it chooses the one which leaves the least original strips unpaired, and among those the one with the lowest sum of weights. Since all pairs with the same original strips on both sides are interchangeable, only the best of them is kept, and the assignment is solved by dynamic programming over the bitmasks of the already paired original strips (at most 2^7 x 2^7 states). The weight matrix is traversed only once per step. The steps with charge sharing on three strips and with multiple hits are done exactly as in the greedy mode (Mode = 0, the default). Mode = 1 is the greedy search as well: older configurations stored it for "Daniel's 'greedy' algorithm", which was always run.
  */
 
 #ifndef __MModuleStripPairingGreedy__
@@ -117,6 +123,8 @@ Clio Sleator, 2014
 // Nuclearizer libs
 #include "MModule.h"
 #include "MGUIExpoStripPairing.h"
+#include "MStripPairingEngine.h"
+#include "MThreadPool.h"
 
 // Forward declarations:
 
@@ -153,61 +161,27 @@ class MModuleStripPairingGreedy : public MModule
   //!Main data analysis routine, which updates the event to a new level
   virtual bool AnalyzeEvent(MReadOutAssembly* Event);
 
-//other functions
-  int GetEventInfo(MReadOutAssembly*, int);
+  //! Write the hits of one detector into the event
   void WriteHits(MReadOutAssembly*, int);
-  void ClearMembers();  //clears member vectors in between detectors
-  bool CheckInitialEnergyDifference();
-  bool CheckForAdjacentStrips(); //checks if any adjacent strips were hit and if so, adds the possibility of charge sharing
-  bool CheckMultipleHits(); //checks to see if more x or more y strips were hit, if so, calls AddMuoltipleHits(int)
-  void AddMultipleHits(int); //adds possibility of multiple hits on one x (or y) strip by adding all possible combinations of y (or x) strips to vector of y (or x) hits
-	void ChargeSharingThreeStrips(int);
-	void AddThreeHits(int);
-  void InitializeBadCombinations(); //fill badCombinations vector with 0's
-  void CheckForBadCombinations(); //fills out badCombinations vector using information from kill matrix
-  void PrintXYStripsHit(); //prints out current list x and y strips that were hit, including combinations
-	void PrintXYStripsHitOrig();	//prints out original list of x and y strips that were hit, without combinations
-  float CalculateWeight(int, int); //calculate weight of one possible combination
-  void CalculateWeightMatrix(); //calculate the weight matrix
-  vector<int> FindMinWeight(); //find the minimum weight in the weight matrix
-  void ConflictingStrips(int, int); //once a pair is chosen, prevents the program from choosing the same strip again
-  float FindFinalPairs(); //finds the most likely pairs (or combinations) by creating and analyzing the weight matrix
-	void PrintFinalPairs();	//print final pairs
-  void InitializeWeightMatrix(); //fill weight matrix with 0's
-  void PrintWeightMatrix(); //print out all elements in the weight matrix
-  void InitializeKillMatrices(); //fill kill matrices with 0's
-  void ExpandKillMatrix(int); //add column and row to the kill matrices
-	void PrintKillMatrix(); //print out all elements in the kill matrix
-  int CountNegativeElements(); //count number of elements in the weight matrix that are negative (which means they are no longer valid to be chosen as the minimum weight)
-  vector<vector<vector<int> > > DecodeFinalPairs(); //put lists of final strip pairings in terms of numbers between 1 and 37
-  bool CheckAllStripsWerePaired(); //check that all strips are in the list of final pairs
-  float CalculateSigma();
-  void DetermineOption(bool);
-
-
-	int GetStripIndex(int, int);	//for a given strip ID, returns index in stripsHit vector
-  float GetEth(); //returns threshold energy
-  void SetStripsHit(vector<vector<int> >);
-  vector<vector<int> > GetStripsHit();
-  void SetFinalPairs(vector<vector<int> >);
-  void SetEnergy(vector<vector<float> >);
-  vector<vector<float> > GetEnergy();
-  void SetSigma(vector<vector<float> >);
-  vector<vector<float> > GetSigma();
-  vector<vector<float> > GetWeightMatrix();
-  vector<vector<int> > GetBadCombinations();
-  void SetBadCombinations(vector<vector<int> >);
-	int GetNBadCombinations(int);
 
 	//get the mode
 	unsigned int GetMode() const { return m_Mode; }
 	//set the mode
 	void SetMode(unsigned int Mode) { m_Mode = Mode; }
 
-  void CalculateDetectorQuality();
-  void CalculateEventQuality(MReadOutAssembly*, int);
+	//! Get the number of threads which pair the detectors of one event in parallel
+	unsigned int GetNumberOfPairingThreads() const { return m_NPairingThreads; }
+	//! Set the number of threads which pair the detectors of one event in parallel (0: no threads)
+	void SetNumberOfPairingThreads(unsigned int NThreads) { m_NPairingThreads = NThreads; }
+
+	//! Mode: Greedy search
+	static const unsigned int c_ModeGreedy = 0;
+	//! Mode: Greedy search, as stored for "Daniel's 'greedy' algorithm" by older configurations
+	static const unsigned int c_ModeGreedyDaniel = 1;
+	//! Mode: Exact minimum-weight assignment
+	static const unsigned int c_ModeOptimalAssignment = 2;
 
-	void dummy_func();
+  void CalculateEventQuality(MReadOutAssembly*, int);
 
   
   // protected methods:
@@ -235,44 +209,22 @@ class MModuleStripPairingGreedy : public MModule
   int m_NMatches; //Variable Match counter, used to events with a specific numbers of strips involved 
   int m_NBadMatches; //Counts the number of badly matched events
 
-  //for all of these vectors, vector.at(0) = vector of x information
-  //and vector.at(1) = vector of y information
-  //for example, stripsHit.at(0) = vector containing all of the x strips hit
-  //and energy.at(1) = vector containing all of the energies of the y strips hit
-  vector<vector<int> > stripsHit; //strip numbers that got a signal
-  vector<vector<float> > energy; //energy of the signal, corresponds to stripsHit
-  vector<vector<float> > sig; //error of energy measurement, corresponds to stripsHit
-
-  vector<int> nHits; //number of hits on x and y sides, changes to incorporate adjacent strips and multiple hits per strip
-  vector<int> nHitsOrig; //number of hits on x and y sides, stays at original number throughout the entire program
-	vector<int> nHitsAdj;	//number of pairs of adjacent strips hit
-	vector<int> nThreeHitsAdj;	//number of triples of three adj strips hit
-
-  vector<vector<int> > badCombinations; //badCombinations.at(axis).at(i) = 0 when i is a good combination, = 1 when i is a bad combination
-                    //a bad combination is one like 151, which is strip 1 combined with strip sharing between strips 1 and 2
-  vector<vector<vector<int> > > killMatrix; //is used to indicate which strip numbers cannot be chosen once a particular strip is selected
-  vector<vector<float> > weightMatrix; //matrix of all weights of all x and y combinations
-  vector<vector<int> > finalPairs; //list of final pairs that are chosen
-	vector<vector<float> > finalPairEnergy;
-	vector<vector<float> > finalPairRes;
-
-  vector<float> hitQualityFactor; //list of hit quality factors, which are the weights of each hit
-  vector<float> energyResolution; //energy resolution of the pairs
-  vector<float> hitEnergy;  //energy of hit
-
-	//keep track of hits where charge sharing occurred or
-	// strips were hit multiple times
-	vector<int> xStripHitMultipleTimes;
-	vector<int> yStripHitMultipleTimes;
-	vector<int> chargeSharing;
+  //! The number of detectors
+  static const int c_NDetectors = 12;
+  //! The pairing engines, one per detector, which hold all state of the pairing
+  MStripPairingEngine m_Engines[c_NDetectors];
+  //! The return value of MStripPairingEngine::Load() per detector
+  int m_LoadStatus[c_NDetectors];
+  //! The return value of MStripPairingEngine::Pair() per detector
+  bool m_Paired[c_NDetectors];
+  //! The detectors which need to be paired
+  int m_DetectorsToPair[c_NDetectors];
+  //! The number of threads which pair the detectors of one event in parallel
+  unsigned int m_NPairingThreads;
+  //! The threads which pair the detectors of one event in parallel
+  MThreadPool m_ThreadPool;
 
   vector<float> detectorQualityFactors;
-  vector<bool> noHits;
-
-	vector<vector<int> > xCombos;
-	vector<vector<int> > yCombos;
-
-  float Eth; //threshold energy = 30 keV for now
 
   // private members:
  private:
@@ -0,0 +1,108 @@
+/*
+ * MPacketKeyRecord.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MPacketKeyRecord__
+#define __MPacketKeyRecord__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Remembers the keys of the last N received packets to reject duplicates.
+//! Fixed-capacity open-addressed hash set (linear probing) with a ring buffer
+//! holding the insertion order: when full, the oldest key is forgotten.
+class MPacketKeyRecord
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MPacketKeyRecord(unsigned int Capacity = 10000);
+  //! Default destructor
+  virtual ~MPacketKeyRecord();
+
+  //! Forget all keys
+  void Clear();
+
+  //! Return true if the key is in the record
+  bool Contains(uint64_t Key) const;
+  //! Add the key and return true, or return false if it is already in the record
+  bool Insert(uint64_t Key);
+
+  //! Return the number of keys in the record
+  unsigned int GetSize() const { return m_Size; }
+  //! Return the maximum number of keys in the record
+  unsigned int GetCapacity() const { return m_Capacity; }
+
+
+  // protected methods:
+ protected:
+  //! Return the preferred slot of the key in the hash table
+  unsigned int Home(uint64_t Key) const { return (unsigned int) ((Key*0x9E3779B97F4A7C15ULL) >> m_Shift); }
+  //! Return the slot of the key or the empty slot where it would go
+  unsigned int Find(uint64_t Key) const;
+  //! Remove the key from the hash table (backward-shift deletion, no tombstones)
+  void Erase(uint64_t Key);
+
+
+  // private methods:
+ private:
+
+
+  // protected members:
+ protected:
+
+
+  // private members:
+ private:
+  //! The maximum number of keys
+  unsigned int m_Capacity;
+  //! The hash table: keys and occupation flags, its size is a power of two at least twice the capacity
+  vector<uint64_t> m_Table;
+  vector<unsigned char> m_Used;
+  //! The hash table size minus one
+  unsigned int m_Mask;
+  //! The shift to get the slot from the hashed key
+  unsigned int m_Shift;
+  //! The keys in insertion order
+  vector<uint64_t> m_Ring;
+  //! The position of the oldest key in the ring
+  unsigned int m_Oldest;
+  //! The number of keys
+  unsigned int m_Size;
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MPacketKeyRecord, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -32,6 +32,8 @@
 #include "MSimIA.h"
 
 // Forward declarations:
+class MBinaryEventBlock;
+class MAsciiBuffer;
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -148,6 +150,15 @@ class MReadOutAssembly : public MReadOutSequence
   //! Remove a strip hit
   void RemoveStripHit(unsigned int i);
 
+  //! Return the number of strip hits on one side (0: x strips, 1: y strips) of one detector
+  unsigned int GetNStripHits(int DetectorID, unsigned int Side);
+  //! Return the strip hits on one side (0: x strips, 1: y strips) of one detector:
+  //! GetNStripHits(DetectorID, Side) contiguous strip hits sorted by strip ID (hits of the same strip in the order they were added)
+  //! The pointer stays valid until a strip hit is added or removed
+  MStripHit** GetStripHits(int DetectorID, unsigned int Side);
+  //! Invalidate the detector/side/strip index of the strip hits - call after changing the detector, side, or strip of a strip hit
+  void InvalidateStripHitIndex() { m_StripHitIndexValid = false; }
+
   //! Return the number of T Only strip hits
   unsigned int GetNStripHitsTOnly() const { return m_StripHitsTOnly.size(); }
   //! Return strip hit i
@@ -157,6 +168,12 @@ class MReadOutAssembly : public MReadOutSequence
   //! Remove a strip hit
   void RemoveStripHitTOnly(unsigned int i);
 
+  //! Move all strip hits (and T Only strip hits if IncludeTOnly is true) of Other to the end of the lists of this assembly
+  //! In O(1) if this assembly has no strip hits yet
+  void StealStripHits(MReadOutAssembly* Other, bool IncludeTOnly = true);
+  //! Move the simulated interactions of the read-out sequence of Other to this assembly
+  void StealSimIAs(MReadOutAssembly* Other) { if (Other != this) { m_SimIAs.swap(Other->m_SimIAs); Other->m_SimIAs.clear(); } }
+
 
   //! Return the number of guardring hits
   unsigned int GetNGuardringHits() const { return m_GuardringHits.size(); }
@@ -277,7 +294,19 @@ class MReadOutAssembly : public MReadOutSequence
   void StreamEvta(ostream& S);
   //! Stream the content in MEGAlib's roa format 
   void StreamRoa(ostream& S, bool WithDescriptor = true);
+  //! Steam the content into a reusable character buffer (identical to the ostream version)
+  bool StreamDat(MAsciiBuffer& S, int Version = 1);
+  //! Stream the content in MEGAlib's evta format into a reusable character buffer (identical to the ostream version)
+  void StreamEvta(MAsciiBuffer& S);
+  //! Stream the content in MEGAlib's roa format into a reusable character buffer (identical to the ostream version)
+  void StreamRoa(MAsciiBuffer& S, bool WithDescriptor = true);
+  //! Append the content to a block of the binary event format
+  void StreamBinary(MBinaryEventBlock& Block);
+  //! Replace the content by the next event of a block of the binary event format
+  //! Return false if all events of the block have been read
+  bool ParseBinary(MBinaryEventBlock& Block);
   //! Build the next MReadoutAssemply from a .dat file
+  //! Line by line from an already opened file - whole files are read much faster with MDatFileParser
   bool GetNextFromDatFile(MFile &F);
   //! Use the info in m_Aspect to turn m_CL into an absolute UTC time
   bool ComputeAbsoluteTime();
@@ -289,12 +318,17 @@ class MReadOutAssembly : public MReadOutSequence
 
   // protected methods:
  protected:
+  //! Stream the first NBDs BD flags (in the order of IsBad()) into a reusable character buffer
+  void StreamBDs(MAsciiBuffer& S, unsigned int NBDs);
+  //! Discard the partly read event and the rest of a corrupt block of the binary event format - returns false
+  bool RejectBinaryBlock(MBinaryEventBlock& Block);
   //MReadOutAssembly() {};
   //MReadOutAssembly(const MReadOutAssembly& ReadOutAssembly) {};
 
   // private methods:
  private:
-
+  //! Sort the strip hits by detector, side and strip into the strip hit index
+  void BuildStripHitIndex();
 
 
   // protected members:
@@ -359,6 +393,16 @@ class MReadOutAssembly : public MReadOutSequence
   //! List of strip hits
   vector<MStripHit*> m_StripHits;
 
+  //! True if the strip hit index is up to date
+  bool m_StripHitIndexValid;
+  //! The strip hits sorted by detector, side and strip ID - strip hits with negative detector ID are not contained
+  vector<MStripHit*> m_StripHitIndex;
+  //! The start of the strip hits of detector d and side s in the index is at 2*d+s, the end at 2*d+s+1
+  vector<unsigned int> m_StripHitIndexStarts;
+  //! Scratch space of the counting sorts
+  vector<unsigned int> m_StripHitIndexCounts;
+  vector<MStripHit*> m_StripHitIndexScratch;
+
   //! List of strip hits with timing only
   vector<MStripHit*> m_StripHitsTOnly;
 
@@ -0,0 +1,115 @@
+/*
+ * MReadOutAssemblyQueue.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MReadOutAssemblyQueue__
+#define __MReadOutAssemblyQueue__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Nuclearizer libs
+#include "MReadOutAssembly.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! A time ordered queue of (not owned) read-out assemblies.
+//! It is a binary min-heap on the 48-bit clock value (CL): adding an event is O(log n)
+//! and the events are taken out in time order, without ever sorting the whole queue.
+//! Events with the same clock value are taken out in reverse order of their addition.
+class MReadOutAssemblyQueue
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MReadOutAssemblyQueue();
+  //! Default destructor - the events are not deleted
+  virtual ~MReadOutAssemblyQueue();
+
+  //! Add an event
+  void Push(MReadOutAssembly* Event);
+  //! Take out the earliest event - the queue must not be empty
+  MReadOutAssembly* Pop();
+  //! Return the earliest event without taking it out - the queue must not be empty
+  MReadOutAssembly* GetEarliest() const { return m_Heap.front().m_Event; }
+
+  //! Return the clock value of the earliest event - the queue must not be empty
+  uint64_t GetEarliestCL() const { return m_Heap.front().m_CL; }
+  //! Return the clock value of the latest event - the queue must not be empty
+  uint64_t GetLatestCL() const { return m_LatestCL; }
+
+  //! Return the number of events
+  unsigned int GetSize() const { return m_Heap.size(); }
+  //! Return true if there are no events
+  bool IsEmpty() const { return m_Heap.empty(); }
+  //! Forget all events - they are not deleted
+  void Clear();
+
+
+  // protected methods:
+ protected:
+  //! One entry of the heap
+  struct Entry {
+    //! The clock value of the event
+    uint64_t m_CL;
+    //! The sequence number of the addition, breaks ties between equal clock values
+    uint64_t m_Sequence;
+    //! The event
+    MReadOutAssembly* m_Event;
+  };
+
+  //! Return true if entry A has to be taken out before entry B
+  static bool IsEarlier(const Entry& A, const Entry& B) { return A.m_CL < B.m_CL || (A.m_CL == B.m_CL && A.m_Sequence > B.m_Sequence); }
+
+
+  // private methods:
+ private:
+
+
+  // protected members:
+ protected:
+
+
+  // private members:
+ private:
+  //! The heap, the earliest event is at the front
+  vector<Entry> m_Heap;
+  //! The latest clock value of all events added since the queue was empty the last time
+  uint64_t m_LatestCL;
+  //! The sequence number of the next addition
+  uint64_t m_Sequence;
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MReadOutAssemblyQueue, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,158 @@
+/*
+ * MStripCalibrationPolynomials.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MStripCalibrationPolynomials__
+#define __MStripCalibrationPolynomials__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+#include "MReadOutElementDoubleStrip.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! A dense table of calibration polynomials, one per strip, indexed by (detector, side, strip)
+//! The coefficients of all strips are stored in one flat array, and the polynomials are evaluated
+//! with Horner's rule - this replaces map look-ups and interpreted TF1 formulas
+class MStripCalibrationPolynomials
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MStripCalibrationPolynomials();
+  //! Default destructor
+  virtual ~MStripCalibrationPolynomials();
+
+  //! The maximum degree of a polynomial
+  static const unsigned int c_MaxDegree = 4;
+
+  //! Remove all polynomials and size the table for the given number of detectors and strips per side
+  void Reset(unsigned int NDetectors, unsigned int NStrips);
+
+  //! Set the polynomial c[0] + c[1]*x + ... + c[Degree]*x^Degree of the given strip
+  //! Returns false if the strip is outside the table or the degree is too high
+  bool Set(const MReadOutElementDoubleStrip& R, const double* Coefficients, unsigned int Degree);
+
+  //! Return the slot of the given strip, or -1 if it is outside the table
+  //! All tables with the same dimensions use the same slots
+  int GetSlot(int DetectorID, bool IsPositiveStrip, int StripID) const {
+    if (DetectorID < 0 || DetectorID >= m_NDetectors || StripID < 0 || StripID >= m_NStrips) return -1;
+    return (2*DetectorID + (IsPositiveStrip == true ? 0 : 1))*m_NStrips + StripID;
+  }
+  //! Return the slot of the given read-out element, or -1 if it is outside the table
+  int GetSlot(const MReadOutElementDoubleStrip& R) const { return GetSlot(R.GetDetectorID(), R.IsPositiveStrip(), R.GetStripID()); }
+
+  //! Return the number of slots
+  unsigned int GetNSlots() const { return m_Degree.size(); }
+  //! Return true if the slot is valid and has a polynomial
+  bool HasPolynomial(int Slot) const { return Slot >= 0 && m_Degree[Slot] >= 0; }
+  //! Return the degree of the polynomial in the slot (-1 if there is none) - the slot must be valid
+  int GetDegree(int Slot) const { return m_Degree[Slot]; }
+  //! Return the coefficients of the polynomial in the slot (zero-padded to c_MaxDegree) - the slot must be valid
+  const double* GetCoefficients(int Slot) const { return &m_Coefficients[Slot*c_NCoefficients]; }
+
+  //! Evaluate the polynomial of the slot at X - the slot must have a polynomial
+  double Evaluate(int Slot, double X) const {
+    const double* C = &m_Coefficients[Slot*c_NCoefficients];
+    int Degree = m_Degree[Slot];
+    double Y = C[Degree];
+    for (int d = Degree - 1; d >= 0; --d) Y = Y*X + C[d];
+    return Y;
+  }
+
+  //! Evaluate the polynomials of all given slots at once: Y[i] = P_Slots[i](X[i]), for finite X
+  //! All slots must be valid - slots without a polynomial give zero. The loop has a fixed length
+  //! (the highest degree in the table) and no branches, thus it can be vectorized
+  void Evaluate(const int* Slots, const double* X, double* Y, unsigned int N) const;
+
+  //! Build the inverses of all polynomials on [XMin, XMax] - call after the last Set()
+  //! Polynomials of degree one are inverted exactly, all others with a table of NPoints samples
+  void BuildInverse(double XMin, double XMax, unsigned int NPoints = 257);
+  //! Return the x in [XMin, XMax] with P(x) = Y for the polynomial of the slot - BuildInverse() must have been called
+  //! Values of Y outside the range of P on [XMin, XMax] give the x of the nearest extreme value
+  double Invert(int Slot, double Y) const;
+  //! Return the minimum of the polynomial of the slot on [XMin, XMax] (of the samples for non-monotone polynomials)
+  double GetMinimum(int Slot) const { return m_Minimum[Slot]; }
+  //! Return the maximum of the polynomial of the slot on [XMin, XMax] (of the samples for non-monotone polynomials)
+  double GetMaximum(int Slot) const { return m_Maximum[Slot]; }
+
+
+  // protected methods:
+ protected:
+  //! Evaluate the derivative of the polynomial of the slot at X
+  double EvaluateDerivative(int Slot, double X) const;
+
+
+  // private methods:
+ private:
+
+
+
+  // protected members:
+ protected:
+  //! The number of coefficients per slot
+  static const unsigned int c_NCoefficients = c_MaxDegree + 1;
+
+  //! The number of detectors
+  int m_NDetectors;
+  //! The number of strips per side
+  int m_NStrips;
+  //! The highest degree of all polynomials
+  int m_MaxDegree;
+
+  //! The zero-padded coefficients of all slots, indexed by Slot*c_NCoefficients + power
+  vector<double> m_Coefficients;
+  //! The degree of the polynomial per slot, or -1 if the slot has none
+  vector<signed char> m_Degree;
+
+  //! The range and the number of samples of the inverse tables
+  double m_InverseXMin;
+  double m_InverseXMax;
+  unsigned int m_InverseNPoints;
+  //! The samples P(x_k) at x_k = XMin + k*(XMax-XMin)/(NPoints-1) of all polynomials of degree two and higher
+  vector<float> m_InverseSamples;
+  //! The start of the samples of each slot in m_InverseSamples, or -1 if the slot has none
+  vector<int> m_InverseOffset;
+  //! +1 if the samples of the slot increase strictly, -1 if they decrease strictly, 0 otherwise
+  vector<signed char> m_InverseMonotony;
+  //! The minimum and maximum of the polynomial of each slot on [XMin, XMax]
+  vector<double> m_Minimum;
+  vector<double> m_Maximum;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MStripCalibrationPolynomials, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,104 @@
+/*
+ * MStripCrosstalkSolver.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MStripCrosstalkSolver__
+#define __MStripCrosstalkSolver__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Solves the linear system of the cross-talk correction of the strip hits of one side of one detector:
+//! (1 + B) E_corrected = E_measured + A, where B holds the cross-talk slopes of nearest and skip-1 neighbours
+//! and A the corresponding offsets. For distinct, sorted strips the matrix is symmetric and pentadiagonal.
+class MStripCrosstalkSolver
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MStripCrosstalkSolver();
+  //! Default destructor
+  virtual ~MStripCrosstalkSolver();
+
+  //! Solve with the banded LDL^T decomposition (falls back to the dense solver if not applicable)
+  static const unsigned int c_ModeBanded = 0;
+  //! Solve by inverting the full matrix with ROOT's TMatrixD - the reference implementation
+  static const unsigned int c_ModeDense = 1;
+
+  //! The maximum number of strips the banded solver handles on the stack
+  static const unsigned int c_MaxBandedStrips = 128;
+
+  //! Set the solver mode
+  void SetMode(unsigned int Mode) { m_Mode = Mode; }
+  //! Get the solver mode
+  unsigned int GetMode() const { return m_Mode; }
+
+  //! Set the cross-talk coefficients (offset and slope) of the nearest and the skip-1 neighbours
+  void SetCoefficients(double NearestOffset, double NearestSlope, double SkipOffset, double SkipSlope);
+
+  //! Correct the energies of N strip hits with strip IDs sorted in ascending order
+  void Solve(unsigned int N, const int* StripIDs, const double* Energies, double* CorrectedEnergies) const;
+  //! Correct the energies with the dense solver
+  void SolveDense(unsigned int N, const int* StripIDs, const double* Energies, double* CorrectedEnergies) const;
+  //! Correct the energies with the banded solver - closed form for two and three strips
+  //! Returns false (and does not touch CorrectedEnergies) if the strips are not distinct,
+  //! if there are too many of them, or if the matrix is not positive definite
+  bool SolveBanded(unsigned int N, const int* StripIDs, const double* Energies, double* CorrectedEnergies) const;
+
+
+  // protected methods:
+ protected:
+
+
+  // private methods:
+ private:
+
+
+  // protected members:
+ protected:
+
+
+  // private members:
+ private:
+  //! The solver mode
+  unsigned int m_Mode;
+  //! The cross-talk offset and slope of nearest neighbours
+  double m_NearestOffset;
+  double m_NearestSlope;
+  //! The cross-talk offset and slope of skip-1 neighbours
+  double m_SkipOffset;
+  double m_SkipSlope;
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MStripCrosstalkSolver, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -29,6 +29,7 @@
 #include "MStripHit.h"
 
 // Forward declarations:
+class MAsciiBuffer;
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -122,6 +123,10 @@ class MStripHit
   bool StreamDat(ostream& S, int Version = 1);
   //! Stream the content in MEGAlib's roa format 
   void StreamRoa(ostream& S);
+  //! Dump the content into a reusable character buffer (identical to the ostream version)
+  bool StreamDat(MAsciiBuffer& S, int Version = 1);
+  //! Stream the content in MEGAlib's roa format into a reusable character buffer (identical to the ostream version)
+  void StreamRoa(MAsciiBuffer& S);
   
   
   // protected methods:
@@ -0,0 +1,305 @@
+/*
+ * MStripPairingEngine.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MStripPairingEngine__
+#define __MStripPairingEngine__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Nuclearizer libs
+#include "MReadOutAssembly.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! The greedy strip pairing of one detector (see MModuleStripPairingGreedy.h for the algorithm)
+//! All state lives in fixed-capacity arrays sized for the worst case allowed by the strip
+//! multiplicity cuts, the kill matrices are replaced by bitmasks of the original strips,
+//! and the only dynamic buffer (the weight matrix) grows once and is then reused.
+//! Thus an engine which is reused for all detectors and events does not allocate memory.
+class MStripPairingEngine
+{
+  // public interface:
+ public:
+  //! Default constructor
+  MStripPairingEngine();
+  //! Default destructor
+  virtual ~MStripPairingEngine();
+
+  //! Maximum number of strip hits per side for which a detector is paired
+  static const int c_MaxStripsPerSide = 7;
+  //! Maximum number of strips on one side of a decoded hit
+  static const int c_MaxStripsPerHit = 4;
+
+  //! Pairing mode: Greedy search, which always takes the x-y pair with the lowest weight next
+  static const unsigned int c_ModeGreedy = 0;
+  //! Pairing mode: Exact minimum-weight assignment of the x and y strips
+  static const unsigned int c_ModeOptimalAssignment = 1;
+
+  //! Set the pairing mode
+  void SetMode(unsigned int Mode);
+  //! Get the pairing mode
+  unsigned int GetMode() const { return m_Mode; }
+
+  //! Get the strip hits of the given detector from the event:
+  //! Returns 1 if the detector can be paired, -1 if the number of strip hits is out of range,
+  //! -2 if it is out of range after removing strip hits with bad energies, and -3 if there are no strip hits
+  int Load(MReadOutAssembly* Event, int DetectorID);
+  //! Pair the loaded strips: greedy search or optimal assignment, which is repeated including charge
+  //! sharing on three strips, and two and three hits on one strip, as long as the chi-square is bad
+  //! Returns false if the greedy search did not converge
+  bool Pair();
+  //! Decode the final pairs into hits - returns false in case of a programming error
+  bool Decode();
+
+  //! Return the detector quality: The average of all hit quality factors
+  float GetDetectorQuality() const { return m_DetectorQuality; }
+
+  //! Return the number of decoded hits
+  unsigned int GetNHits() const { return m_NDecodedHits; }
+  //! Return the number of strips of the given hit on the x (Axis = 0) or y (Axis = 1) side
+  unsigned int GetNStrips(unsigned int Hit, unsigned int Axis) const { return m_DecodedHits[Hit].m_NStrips[Axis]; }
+  //! Return the strip ID of the given strip of the given hit on the x (Axis = 0) or y (Axis = 1) side
+  int GetStripID(unsigned int Hit, unsigned int Axis, unsigned int Strip) const { return m_DecodedHits[Hit].m_StripIDs[Axis][Strip]; }
+  //! Return true if the x strip of this hit has been hit multiple times
+  bool GetStripHitMultipleTimesX(unsigned int Hit) const { return m_DecodedHits[Hit].m_MultipleTimesX; }
+  //! Return true if the y strip of this hit has been hit multiple times
+  bool GetStripHitMultipleTimesY(unsigned int Hit) const { return m_DecodedHits[Hit].m_MultipleTimesY; }
+  //! Return true if charge sharing occured in this hit
+  bool GetChargeSharing(unsigned int Hit) const { return m_DecodedHits[Hit].m_ChargeSharing; }
+  //! Return the hit quality factor of the given hit
+  float GetHitQuality(unsigned int Hit) const { return m_HitQualityFactor[Hit]; }
+  //! Return the energy of the given hit
+  float GetHitEnergy(unsigned int Hit) const { return m_HitEnergy[Hit]; }
+  //! Return the energy resolution of the given hit
+  float GetHitEnergyResolution(unsigned int Hit) const { return m_EnergyResolution[Hit]; }
+
+  //! Print the current list of x and y strips including all combinations
+  void PrintXYStripsHit() const;
+  //! Print the final pairs
+  void PrintFinalPairs() const;
+  //! Print the weight matrix
+  void PrintWeightMatrix() const;
+
+
+  // protected methods:
+ protected:
+  //! Reset all counters
+  void Clear();
+  //! Add a strip hit to the strips of one side, unless its energy or resolution is zero, infinite, or NaN
+  void AddStrip(int Axis, MStripHit* SH);
+  //! Store a strip combination at the given index - it inherits the strips of its constituents
+  void AddCombination(int Axis, int Index, int Label, float Energy, float Sigma, int FirstIndex, int SecondIndex, int ThirdIndex = -1);
+  //! Add the possibility of charge sharing between adjacent strips
+  void CheckForAdjacentStrips();
+  //! Add the possibility of charge sharing between three adjacent strips
+  void ChargeSharingThreeStrips(int Axis);
+  //! Add the possibility of two hits on one strip of the other side
+  void AddMultipleHits(int Axis);
+  //! Add the possibility of three hits on one strip of the other side
+  void AddThreeHits(int Axis);
+  //! Calculate the weight matrix
+  void CalculateWeightMatrix();
+  //! Find the final pairs depending on the mode and return their chi-square
+  //! Returns false if the search did not converge
+  bool FindFinalPairs(float& ChiSquare);
+  //! Do the greedy search and return the chi-square of the final pairs
+  //! Returns false if the search did not converge
+  bool FindGreedyPairs(float& ChiSquare);
+  //! Find the pairs which leave the least original strips unpaired, and among those the ones
+  //! with the lowest sum of weights, and return their chi-square
+  void FindOptimalPairs(float& ChiSquare);
+  //! Solve the optimal assignment for the not yet paired strips recursively and return the index
+  //! of its state - the original x and y strips which are already paired are given as bitmasks
+  unsigned int SolveAssignment(unsigned int XPaired, unsigned int YPaired);
+  //! Save the final pairs of a greedy search
+  void SaveFinalPairs(int Pass);
+  //! Restore the final pairs of an earlier greedy search
+  void RestoreFinalPairs(int Pass);
+  //! Split a strip label into its strip IDs
+  void DecodeLabel(int Label, int* StripIDs, int& NStripIDs, bool& TwoHits, bool& ThreeHits, bool& ChargeSharing) const;
+  //! Add a decoded hit
+  void AddDecodedHit(const int* XStripIDs, int NXStripIDs, const int* YStripIDs, int NYStripIDs, bool MultipleTimesX, bool MultipleTimesY, bool ChargeSharing);
+  //! Update the hit record at the given index and insert the records of the additional hits after it
+  bool SplitHitRecord(int Index, const float* Energies, const float* Resolutions, int NHits);
+  //! For a given strip label return the (last) index in the strip list, or -1 if it is not found
+  int GetStripIndex(int Axis, int Label) const;
+
+
+  // private methods:
+ private:
+
+
+  // protected members:
+ protected:
+  //! Maximum number of charge-sharing combinations of two adjacent strips per side
+  static const int c_MaxAdjacentStrips = c_MaxStripsPerSide - 1;
+  //! Maximum number of charge-sharing combinations of three adjacent strips per side
+  static const int c_MaxThreeAdjacentStrips = c_MaxStripsPerSide - 2;
+  //! Maximum number of single and charge-sharing strips per side
+  static const int c_MaxSingleStrips = c_MaxStripsPerSide + c_MaxAdjacentStrips;
+  //! Maximum number of two-hit combinations per side
+  static const int c_MaxTwoHits = c_MaxSingleStrips*(c_MaxSingleStrips - 1)/2;
+  //! Maximum number of three-hit combinations per side
+  static const int c_MaxThreeHits = c_MaxSingleStrips*c_MaxTwoHits;
+  //! Maximum number of strips and strip combinations per side
+  static const int c_MaxEntries = c_MaxSingleStrips + c_MaxThreeAdjacentStrips + c_MaxTwoHits + c_MaxThreeHits;
+  //! Maximum number of strips and strip combinations per side without the three-hit combinations
+  static const int c_MaxEntriesWithoutThreeHits = c_MaxEntries - c_MaxThreeHits;
+  //! Maximum number of pairs of one greedy search: one per original strip plus
+  //! the fall-back pair (0, 0), which is chosen if no valid weight is left
+  static const int c_MaxPairsPerPass = c_MaxStripsPerSide + 1;
+  //! Maximum number of greedy searches per detector
+  static const int c_MaxPasses = 4;
+  //! Maximum number of decoded hits
+  static const int c_MaxDecodedHits = 3*c_MaxPairsPerPass;
+  //! Maximum number of hit quality, energy and resolution records
+  static const int c_MaxHitRecords = c_MaxPasses*c_MaxPairsPerPass + 2*c_MaxPairsPerPass;
+
+  //! Number of possible bitmasks of the original strips of one side
+  static const int c_NMasks = 1 << c_MaxStripsPerSide;
+
+  //! The lowest weight of all x-y pairs with the given two bitmasks of original strips
+  class MaskPair {
+   public:
+    //! The weight, or -1 if there is no valid pair
+    float m_Weight;
+    //! The indices of the x and y strip or combination
+    short m_XIndex;
+    short m_YIndex;
+  };
+
+  //! The solution of the assignment problem for the not yet paired strips
+  class AssignmentState {
+   public:
+    //! The assignment counter when this state was solved - it is invalid otherwise
+    unsigned int m_Stamp;
+    //! The number of original strips which remain unpaired
+    unsigned char m_NUnpaired;
+    //! The bitmasks of the x and y strips of the next pair - the y mask is zero if the x strip stays unpaired
+    unsigned char m_XMask;
+    unsigned char m_YMask;
+    //! The sum of the weights of all pairs
+    float m_Weight;
+  };
+
+  //! A decoded hit
+  class DecodedHit {
+   public:
+    //! The strip IDs on the x (0) and y (1) side
+    int m_StripIDs[2][c_MaxStripsPerHit];
+    //! The number of strips on the x (0) and y (1) side
+    unsigned int m_NStrips[2];
+    //! Flags for strips hit multiple times, and for charge sharing
+    bool m_MultipleTimesX;
+    bool m_MultipleTimesY;
+    bool m_ChargeSharing;
+  };
+
+  // The strips and strip combinations on the x (0) and y (1) side: The strip IDs or the
+  // combination labels (50+n, 5000+n, 100*a+b, 10000*a+b), their energy and resolution,
+  // the bitmask of the original strips they contain, and whether they contain a strip twice
+  int m_StripsHit[2][c_MaxEntries];
+  float m_Energy[2][c_MaxEntries];
+  float m_Sigma[2][c_MaxEntries];
+  unsigned char m_KillMask[2][c_MaxEntries];
+  bool m_BadCombination[2][c_MaxEntries];
+
+  //! Number of strips and combinations per side
+  int m_NHits[2];
+  //! Number of original strips per side
+  int m_NHitsOrig[2];
+  //! Number of pairs of adjacent strips per side
+  int m_NHitsAdj[2];
+  //! Number of triples of adjacent strips per side
+  int m_NThreeHitsAdj[2];
+
+  //! The pairing mode
+  unsigned int m_Mode;
+
+  //! The weight matrix (row-major, m_NHits[0] x m_NHits[1]) - only grows
+  vector<float> m_WeightMatrix;
+
+  //! The best x-y pairs per combination of bitmasks (c_NMasks x c_NMasks), only used for the optimal assignment
+  vector<MaskPair> m_MaskPairs;
+  //! The distinct bitmasks of the x (0) and y (1) side
+  unsigned char m_Masks[2][c_NMasks];
+  //! The number of distinct bitmasks of the x (0) and y (1) side
+  int m_NMasks[2];
+  //! The x bitmasks by their lowest original strip
+  unsigned char m_XMasksByStrip[c_MaxStripsPerSide][c_NMasks];
+  //! The number of x bitmasks by their lowest original strip
+  int m_NXMasksByStrip[c_MaxStripsPerSide];
+  //! The y bitmasks which have a valid pair with the given x bitmask
+  unsigned char m_YMasksByXMask[c_NMasks][c_NMasks];
+  //! The number of y bitmasks which have a valid pair with the given x bitmask
+  int m_NYMasksByXMask[c_NMasks];
+  //! The bitmasks of all original x (0) and y (1) strips
+  unsigned int m_AllStrips[2];
+  //! The solved assignment states, indexed by the bitmasks of the paired x and y strips (c_NMasks x c_NMasks)
+  vector<AssignmentState> m_AssignmentStates;
+  //! The assignment counter, which invalidates all states of the previous assignment
+  unsigned int m_AssignmentStamp;
+
+  //! The final pairs (x and y label) of the current greedy search
+  int m_FinalPairs[c_MaxPairsPerPass][2];
+  //! The number of final pairs
+  int m_NFinalPairs;
+  //! The final pairs of the first three greedy searches
+  int m_SavedFinalPairs[c_MaxPasses-1][c_MaxPairsPerPass][2];
+  //! The number of final pairs of the first three greedy searches
+  int m_NSavedFinalPairs[c_MaxPasses-1];
+
+  // Hit quality factors, energies and energy resolutions of all greedy searches
+  float m_HitQualityFactor[c_MaxHitRecords];
+  float m_HitEnergy[c_MaxHitRecords];
+  float m_EnergyResolution[c_MaxHitRecords];
+  //! The number of records in the three arrays above
+  int m_NHitRecords;
+
+  //! The detector quality
+  float m_DetectorQuality;
+
+  //! The decoded hits
+  DecodedHit m_DecodedHits[c_MaxDecodedHits];
+  //! The number of decoded hits
+  unsigned int m_NDecodedHits;
+
+
+  // private members:
+ private:
+
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MStripPairingEngine, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,119 @@
+/*
+ * MThreadPool.h
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ * Please see the source-file for the copyright-notice.
+ *
+ */
+
+
+#ifndef __MThreadPool__
+#define __MThreadPool__
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Standard libs:
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+using namespace std;
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MGlobal.h"
+
+// Forward declarations:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! A small pool of worker threads which execute the iterations of a loop in parallel
+//! The threads are started once and then wait for work, thus the pool can be used
+//! for short loops, e.g. once per event
+class MThreadPool
+{
+  // public interface:
+ public:
+  //! Default constructor - the pool has no threads
+  MThreadPool();
+  //! Default destructor - stops all threads
+  virtual ~MThreadPool();
+
+  //! Set the number of worker threads - with zero threads all work is done on the calling thread
+  void SetNumberOfThreads(unsigned int NThreads);
+  //! Get the number of worker threads
+  unsigned int GetNumberOfThreads() const { return m_Threads.size(); }
+
+  //! Call Task(i) for all i in [0, NTasks) on the worker threads and the calling thread,
+  //! and return when all calls are done. Must not be called from multiple threads at once.
+  void ParallelFor(unsigned int NTasks, const function<void(unsigned int)>& Task);
+
+
+  // protected methods:
+ protected:
+  //! The loop of a worker thread, which starts while the given loop is the current one
+  void Run(unsigned long Generation);
+  //! Execute tasks until none is left
+  void Work();
+  //! Stop and join all threads
+  void Stop();
+
+
+  // private methods:
+ private:
+  //! No copy constructor
+  MThreadPool(const MThreadPool&) = delete;
+  //! No copying itself
+  MThreadPool& operator=(const MThreadPool&) = delete;
+
+
+  // protected members:
+ protected:
+  //! The worker threads
+  vector<thread> m_Threads;
+
+  //! Protects all members below except the task counter
+  mutex m_Mutex;
+  //! Signals the workers that new work (or the stop request) is available
+  condition_variable m_WorkAvailable;
+  //! Signals the calling thread that all workers are done
+  condition_variable m_WorkDone;
+
+  //! The current task
+  const function<void(unsigned int)>* m_Task;
+  //! The number of calls of the current task
+  unsigned int m_NTasks;
+  //! The next call of the current task
+  atomic<unsigned int> m_NextTask;
+  //! Incremented for each loop, so that the workers recognize new work
+  unsigned long m_Generation;
+  //! The number of workers which are still working on the current loop
+  unsigned int m_NBusy;
+  //! True if the threads have to stop
+  bool m_Stop;
+
+
+  // private members:
+ private:
+
+
+#ifdef ___CLING___
+ public:
+  ClassDef(MThreadPool, 0) // no description
+#endif
+
+};
+
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,88 @@
+/*
+ * MAsciiBuffer.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MAsciiBuffer
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MAsciiBuffer.h"
+
+// Standard libs:
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MAsciiBuffer)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MAsciiBuffer::MAsciiBuffer() : m_Precision(6), m_AppendBuffer(m_Data), m_Stream(&m_AppendBuffer)
+{
+  // Construct an instance of MAsciiBuffer - the precision is the one of a new ostream
+
+  m_Data.reserve(4096);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MAsciiBuffer::~MAsciiBuffer()
+{
+  // Delete this instance of MAsciiBuffer
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MAsciiBuffer& MAsciiBuffer::operator<<(double Value)
+{
+  // An ostream without floatfield flags formats like printf's %g - and so does to_chars with chars_format::general
+  // A negative precision is the default one, and a precision of zero is treated as one by both
+
+  char Text[64];
+  int Precision = (m_Precision < 0) ? 6 : m_Precision;
+  to_chars_result Result = to_chars(Text, Text + sizeof(Text), Value, chars_format::general, Precision);
+  if (Result.ec == errc()) {
+    m_Data.append(Text, Result.ptr - Text);
+  } else {
+    // Only very large precisions do not fit
+    m_Stream.precision(m_Precision);
+    m_Stream<<Value;
+  }
+
+  return *this;
+}
+
+
+// MAsciiBuffer.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
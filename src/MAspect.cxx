@@ -34,6 +34,7 @@ using namespace std;
 
 // MEGAlib libs:
 #include "MStreams.h"
+#include "MAsciiBuffer.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -214,5 +215,50 @@ void MAspect::StreamEvta(ostream& S)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MAspect::StreamDat(MAsciiBuffer& S, int Version)
+{
+  //! Dump the content into a reusable character buffer (identical to the ostream version)
+
+  // As setprecision, this sticks for all following numbers
+  S.SetPrecision(8);
+  S<<"BR "<<m_BRMS<<'\n';
+  S<<"AF "<<m_AttFlag<<'\n';
+  S<<"GM "<<m_GPS_or_magnetometer<<'\n';     
+  S<<"HD "<<m_Heading<<'\n';
+  S<<"PI "<<m_Pitch<<'\n';
+  S<<"RL "<<m_Roll<<'\n';
+  S<<"LT "<<m_Latitude<<'\n';
+  S<<"LN "<<m_Longitude<<'\n';
+  S<<"AL "<<m_Altitude<<'\n';
+  S<<"GX "<<m_GalacticPointingXAxisLongitude<<' '<<m_GalacticPointingXAxisLatitude<<'\n';
+  S<<"GZ "<<m_GalacticPointingZAxisLongitude<<' '<<m_GalacticPointingZAxisLatitude<<'\n';
+  S<<"HX "<<m_HorizonPointingXAxisAzimuthNorth<<' '<<m_HorizonPointingXAxisElevation<<'\n';
+  S<<"HZ "<<m_HorizonPointingZAxisAzimuthNorth<<' '<<m_HorizonPointingZAxisElevation<<'\n';
+  S<<"OR "<<m_Heading<<' '<<m_Pitch<<' '<<m_Roll<<'\n';
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MAspect::StreamEvta(MAsciiBuffer& S)
+{
+  // Stream the content in MEGAlib's evta format into a reusable character buffer (identical to the ostream version)
+       
+  // As setprecision, this sticks for all following numbers
+  S.SetPrecision(8);
+  S<<"GX "<<m_GalacticPointingXAxisLongitude<<' '<<m_GalacticPointingXAxisLatitude<<'\n';
+  S<<"GZ "<<m_GalacticPointingZAxisLongitude<<' '<<m_GalacticPointingZAxisLatitude<<'\n';
+  S<<"HX "<<m_HorizonPointingXAxisAzimuthNorth<<' '<<m_HorizonPointingXAxisElevation<<'\n';
+  S<<"HZ "<<m_HorizonPointingZAxisAzimuthNorth<<' '<<m_HorizonPointingZAxisElevation<<'\n';
+  S<<"CC AS "<<m_Latitude<<' '<<m_Longitude<<' '<<m_Heading<<' '<<m_Pitch<<' '<<m_Roll<<' '<<m_UTCTime<<'\n';
+}
+
+
 // MAspect.cxx: the end...
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,276 @@
+/*
+ * MBinaryEventBlock.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MBinaryEventBlock
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MBinaryEventBlock.h"
+
+// Standard libs:
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MBinaryEventBlock)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! The magic of a file and of a block
+static const char* g_BinaryEventFileMagic = "NBEV";
+static const char* g_BinaryEventBlockMagic = "NBEB";
+//! The length of a block header
+static const size_t g_BinaryEventBlockHeaderLength = 20;
+//! The length of a column header
+static const size_t g_BinaryEventColumnHeaderLength = 12;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryEventBlock::MBinaryEventBlock() : m_NEvents(0), m_NReadEvents(0)
+{
+  // Construct an instance of MBinaryEventBlock
+
+  m_Columns.resize(c_NColumns);
+  m_Positions.resize(c_NColumns, 0);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryEventBlock::~MBinaryEventBlock()
+{
+  // Delete this instance of MBinaryEventBlock
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryEventBlock::Clear()
+{
+  // Remove all events
+
+  for (unsigned int c = 0; c < c_NColumns; ++c) {
+    m_Columns[c].clear();
+    m_Positions[c] = 0;
+  }
+  m_NEvents = 0;
+  m_NReadEvents = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryEventBlock::NextEvent()
+{
+  // Start reading the next event
+
+  if (m_NReadEvents >= m_NEvents) return false;
+  ++m_NReadEvents;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryEventBlock::AddString(unsigned int Column, const MString& String)
+{
+  // Append a string to a column: its length followed by its characters
+
+  uint32_t Length = String.Length();
+  Add<uint32_t>(Column, Length);
+
+  vector<uint8_t>& C = m_Columns[Column];
+  C.insert(C.end(), String.Data(), String.Data() + Length);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MString MBinaryEventBlock::GetString(unsigned int Column)
+{
+  // Read the next string of a column
+
+  uint32_t Length = Get<uint32_t>(Column);
+
+  const vector<uint8_t>& C = m_Columns[Column];
+  size_t& Position = m_Positions[Column];
+  if (Position + Length > C.size()) {
+    Position = C.size();
+    return "";
+  }
+
+  MString String(string((const char*) &C[Position], Length));
+  Position += Length;
+
+  return String;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryEventBlock::WriteFileHeader(vector<uint8_t>& Out)
+{
+  // Append the file header to Out
+
+  Out.insert(Out.end(), g_BinaryEventFileMagic, g_BinaryEventFileMagic + 4);
+  uint32_t Version = c_Version;
+  size_t Start = Out.size();
+  Out.resize(Start + sizeof(Version));
+  CopyLittleEndian(&Out[Start], &Version, sizeof(Version));
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryEventBlock::CheckFileHeader(const uint8_t* Data, size_t Length)
+{
+  // Check the file header
+
+  if (Length < GetFileHeaderLength()) return false;
+  if (memcmp(Data, g_BinaryEventFileMagic, 4) != 0) return false;
+
+  uint32_t Version;
+  CopyLittleEndian(&Version, Data + 4, sizeof(Version));
+  if (Version == 0 || Version > c_Version) {
+    if (g_Verbosity >= c_Error) cout<<"MBinaryEventBlock: Unsupported version of the binary event file: "<<Version<<endl;
+    return false;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryEventBlock::Write(vector<uint8_t>& Out) const
+{
+  // Append this block to Out - empty columns are not written
+
+  uint64_t Length = 0;
+  uint32_t NColumns = 0;
+  for (unsigned int c = 0; c < c_NColumns; ++c) {
+    if (m_Columns[c].size() == 0) continue;
+    Length += g_BinaryEventColumnHeaderLength + m_Columns[c].size();
+    ++NColumns;
+  }
+  uint32_t NEvents = m_NEvents;
+
+  size_t Start = Out.size();
+  Out.resize(Start + g_BinaryEventBlockHeaderLength + Length);
+  uint8_t* Pos = &Out[Start];
+
+  memcpy(Pos, g_BinaryEventBlockMagic, 4); Pos += 4;
+  CopyLittleEndian(Pos, &Length, sizeof(Length)); Pos += sizeof(Length);
+  CopyLittleEndian(Pos, &NEvents, sizeof(NEvents)); Pos += sizeof(NEvents);
+  CopyLittleEndian(Pos, &NColumns, sizeof(NColumns)); Pos += sizeof(NColumns);
+
+  for (uint32_t c = 0; c < c_NColumns; ++c) {
+    uint64_t Size = m_Columns[c].size();
+    if (Size == 0) continue;
+    CopyLittleEndian(Pos, &c, sizeof(c)); Pos += sizeof(c);
+    CopyLittleEndian(Pos, &Size, sizeof(Size)); Pos += sizeof(Size);
+    memcpy(Pos, &m_Columns[c][0], Size); Pos += Size;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryEventBlock::GetBlockLength(const uint8_t* Data, size_t Length, size_t& BlockLength)
+{
+  // Determine the length of the block starting at Data
+
+  BlockLength = 0;
+  if (Length < 4) return true;
+  if (memcmp(Data, g_BinaryEventBlockMagic, 4) != 0) return false;
+  if (Length < g_BinaryEventBlockHeaderLength) return true;
+
+  uint64_t ColumnsLength;
+  CopyLittleEndian(&ColumnsLength, Data + 4, sizeof(ColumnsLength));
+  BlockLength = g_BinaryEventBlockHeaderLength + ColumnsLength;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryEventBlock::Read(const uint8_t* Data, size_t Length)
+{
+  // Read the block
+
+  Clear();
+
+  size_t BlockLength;
+  if (GetBlockLength(Data, Length, BlockLength) == false || BlockLength == 0 || BlockLength > Length) return false;
+
+  uint32_t NEvents;
+  uint32_t NColumns;
+  CopyLittleEndian(&NEvents, Data + 12, sizeof(NEvents));
+  CopyLittleEndian(&NColumns, Data + 16, sizeof(NColumns));
+
+  const uint8_t* Pos = Data + g_BinaryEventBlockHeaderLength;
+  const uint8_t* End = Data + BlockLength;
+  for (uint32_t c = 0; c < NColumns; ++c) {
+    if (End - Pos < (long) g_BinaryEventColumnHeaderLength) return false;
+    uint32_t ID;
+    uint64_t Size;
+    CopyLittleEndian(&ID, Pos, sizeof(ID)); Pos += sizeof(ID);
+    CopyLittleEndian(&Size, Pos, sizeof(Size)); Pos += sizeof(Size);
+    if (Size > (uint64_t) (End - Pos)) return false;
+    // Columns of newer versions of the format are skipped
+    if (ID < c_NColumns) {
+      m_Columns[ID].assign(Pos, Pos + Size);
+    }
+    Pos += Size;
+  }
+
+  m_NEvents = NEvents;
+
+  return true;
+}
+
+
+// MBinaryEventBlock.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
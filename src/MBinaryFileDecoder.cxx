@@ -0,0 +1,222 @@
+/*
+ * MBinaryFileDecoder.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MBinaryFileDecoder
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MBinaryFileDecoder.h"
+
+// Standard libs:
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MBinaryFileDecoder)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFileDecoder::MBinaryFileDecoder() : m_MaxQueuedBlocks(64), m_IsDone(false), m_Error(false), m_Stop(false)
+{
+  // Construct an instance of MBinaryFileDecoder
+
+  m_Parser.SetDecodeOnly(true);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFileDecoder::~MBinaryFileDecoder()
+{
+  // Delete this instance of MBinaryFileDecoder
+
+  Stop();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileDecoder::Start(const MString& FileName)
+{
+  // Open the file and start decoding it
+
+  Stop();
+
+  m_FileName = FileName;
+  if (m_Reader.Open(m_FileName) == false) return false;
+
+  m_IsDone = false;
+  m_Error = false;
+  m_Stop = false;
+  m_Thread = thread(&MBinaryFileDecoder::Run, this);
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFileDecoder::Stop()
+{
+  // Stop decoding and delete all decoded blocks, which have not been handed out
+
+  if (m_Thread.joinable() == true) {
+    {
+      unique_lock<mutex> Lock(m_Mutex);
+      m_Stop = true;
+    }
+    m_SpaceAvailable.notify_all();
+    m_Thread.join();
+  }
+
+  for (auto& Block: m_Queue) {
+    Clear(Block);
+  }
+  m_Queue.clear();
+
+  m_Reader.Close();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFileDecoder::Run()
+{
+  // The loop of the decoding thread
+
+  const uint8_t* Data = NULL;
+  size_t Length = 0;
+  bool Stopped = false;
+  while (m_Reader.ReadSpan(Data, Length) == true) {
+    // A memory mapped file stays valid until the reader is closed, thus the parser can work on it in place
+    m_Parser.ParseData(Data, Length, m_Reader.IsMapped());
+    if (Push() == false) {
+      Stopped = true;
+      break;
+    }
+  }
+
+  if (Stopped == false) {
+    m_Parser.FinishDecoding();
+    Push();
+  }
+
+  {
+    unique_lock<mutex> Lock(m_Mutex);
+    if (m_Reader.HasError() == true) m_Error = true;
+    m_IsDone = true;
+  }
+  m_BlockAvailable.notify_one();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileDecoder::Push()
+{
+  // Hand the content of the parser's decoded block to the consumer
+
+  MBinaryFlightDataParser::decodedblock Block;
+  m_Parser.TakeDecodedBlock(Block);
+
+  {
+    unique_lock<mutex> Lock(m_Mutex);
+    m_SpaceAvailable.wait(Lock, [this] { return m_Stop == true || m_Queue.size() < m_MaxQueuedBlocks; });
+    // When we stop, Stop() deletes the queued blocks
+    m_Queue.push_back(move(Block));
+    if (m_Stop == true) return false;
+  }
+  m_BlockAvailable.notify_one();
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileDecoder::Next(MBinaryFlightDataParser::decodedblock& Block)
+{
+  // Return the next decoded block
+
+  Clear(Block);
+
+  unique_lock<mutex> Lock(m_Mutex);
+  m_BlockAvailable.wait(Lock, [this] { return m_Queue.empty() == false || m_IsDone == true; });
+  if (m_Queue.empty() == true) return false;
+
+  Block = move(m_Queue.front());
+  m_Queue.pop_front();
+  Lock.unlock();
+  m_SpaceAvailable.notify_one();
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileDecoder::HasError()
+{
+  // Return true if reading the file failed
+
+  unique_lock<mutex> Lock(m_Mutex);
+  return m_Error;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFileDecoder::Clear(MBinaryFlightDataParser::decodedblock& Block)
+{
+  // Delete the events of a decoded block
+
+  for (auto& Frame: Block.Frames) {
+    for (auto E: Frame.Events) {
+      delete E;
+    }
+  }
+  Block.Frames.clear();
+  Block.OtherPackets.clear();
+  Block.Head.clear();
+  Block.Tail.clear();
+}
+
+
+// MBinaryFileDecoder.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
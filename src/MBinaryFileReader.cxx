@@ -0,0 +1,331 @@
+/*
+ * MBinaryFileReader.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MBinaryFileReader
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MBinaryFileReader.h"
+
+// Standard libs:
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MBinaryFileReader)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFileReader::MBinaryFileReader() : m_BlockSize(1000000), m_MaxQueuedBlocks(8), m_IsOpen(false), m_IsZipped(false), m_ZipFile(NULL), m_EndOfFile(false), m_Error(false), m_UseMemoryMapping(false), m_IsMapped(false), m_MappedData(NULL), m_MappedSize(0), m_MappedPosition(0), m_Stop(false)
+{
+  // Construct an instance of MBinaryFileReader
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFileReader::~MBinaryFileReader()
+{
+  // Delete this instance of MBinaryFileReader
+
+  Close();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileReader::Open(const MString& FileName)
+{
+  // Open the file and start reading ahead
+
+  Close();
+
+  m_IsZipped = FileName.EndsWith(".gz");
+
+  if (m_IsZipped == false && m_UseMemoryMapping == true) {
+    int FileDescriptor = open(FileName, O_RDONLY);
+    if (FileDescriptor < 0) return false;
+    struct stat Status;
+    if (fstat(FileDescriptor, &Status) == 0) {
+      m_MappedSize = Status.st_size;
+      if (m_MappedSize > 0) {
+        void* Map = mmap(NULL, m_MappedSize, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+        if (Map != MAP_FAILED) {
+          // Let the kernel read ahead aggressively
+          madvise(Map, m_MappedSize, MADV_SEQUENTIAL);
+          m_MappedData = (const uint8_t*) Map;
+          m_IsMapped = true;
+        }
+      } else {
+        m_IsMapped = true;
+      }
+    }
+    // The mapping stays valid after closing the file
+    close(FileDescriptor);
+
+    if (m_IsMapped == true) {
+      m_MappedPosition = 0;
+      m_IsOpen = true;
+      m_EndOfFile = false;
+      m_Error = false;
+      return true;
+    }
+    // If the file cannot be mapped, we read it as usual
+  }
+
+  if (m_IsZipped == false) {
+    m_In.clear();
+    m_In.open(FileName, ios::binary);
+    if (m_In.is_open() == false) return false;
+  } else {
+    m_ZipFile = gzopen(FileName, "rb");
+    if (m_ZipFile == NULL) return false;
+    // A larger internal buffer means fewer, larger reads from disk
+    gzbuffer(m_ZipFile, 1 << 18);
+  }
+
+  m_IsOpen = true;
+  m_EndOfFile = false;
+  m_Error = false;
+  m_Stop = false;
+
+  if (m_MaxQueuedBlocks > 0) {
+    m_Thread = thread(&MBinaryFileReader::Run, this);
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFileReader::Close()
+{
+  // Stop reading and close the file
+
+  if (m_Thread.joinable() == true) {
+    {
+      unique_lock<mutex> Lock(m_Mutex);
+      m_Stop = true;
+    }
+    m_SpaceAvailable.notify_all();
+    m_Thread.join();
+  }
+
+  // Keep the storage of the queued blocks for the next file
+  while (m_Queue.empty() == false) {
+    m_FreeBlocks.push_back(move(m_Queue.front()));
+    m_Queue.pop_front();
+  }
+
+  if (m_In.is_open() == true) m_In.close();
+  m_In.clear();
+  if (m_ZipFile != NULL) {
+    gzclose(m_ZipFile);
+    m_ZipFile = NULL;
+  }
+  if (m_MappedData != NULL) {
+    munmap((void*) m_MappedData, m_MappedSize);
+    m_MappedData = NULL;
+  }
+  m_MappedSize = 0;
+  m_MappedPosition = 0;
+  m_IsMapped = false;
+
+  m_IsOpen = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileReader::ReadBlock(vector<uint8_t>& Block, bool& Error)
+{
+  // Read the next block from the file
+
+  Block.resize(m_BlockSize);
+
+  size_t Read = 0;
+  if (m_IsZipped == false) {
+    m_In.read((char*) &Block[0], m_BlockSize);
+    Read = m_In.gcount();
+    if (m_In.bad() == true) {
+      Error = true;
+    }
+  } else {
+    // gzread might return less than requested before the end of the file (e.g. at the end of a gzip member)
+    while (Read < m_BlockSize) {
+      int N = gzread(m_ZipFile, &Block[Read], m_BlockSize - Read);
+      if (N < 0) {
+        int ErrorCode = 0;
+        const char* Message = gzerror(m_ZipFile, &ErrorCode);
+        cout<<"MBinaryFileReader: Error: Unable to decompress the file: "<<Message<<endl;
+        Error = true;
+        break;
+      }
+      if (N == 0) break;
+      Read += N;
+    }
+  }
+
+  Block.resize(Read);
+
+  return Read > 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFileReader::Run()
+{
+  // The loop of the read-ahead thread
+
+  while (true) {
+    vector<uint8_t> Block;
+    {
+      unique_lock<mutex> Lock(m_Mutex);
+      m_SpaceAvailable.wait(Lock, [this] { return m_Stop == true || m_Queue.size() < m_MaxQueuedBlocks; });
+      if (m_Stop == true) return;
+      if (m_FreeBlocks.empty() == false) {
+        Block.swap(m_FreeBlocks.back());
+        m_FreeBlocks.pop_back();
+      }
+    }
+
+    bool Error = false;
+    bool HasData = ReadBlock(Block, Error);
+
+    {
+      unique_lock<mutex> Lock(m_Mutex);
+      if (Error == true) m_Error = true;
+      if (HasData == true) {
+        m_Queue.push_back(move(Block));
+      } else {
+        m_EndOfFile = true;
+      }
+    }
+    m_BlockAvailable.notify_one();
+
+    if (HasData == false) return;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileReader::Read(vector<uint8_t>& Block)
+{
+  // Return the next block of the file
+
+  if (m_IsOpen == false) {
+    Block.clear();
+    return false;
+  }
+
+  if (m_IsMapped == true) {
+    const uint8_t* Data;
+    size_t Length;
+    ReadSpan(Data, Length);
+    Block.assign(Data, Data + Length);
+    return Length > 0;
+  }
+
+  if (m_MaxQueuedBlocks == 0) {
+    bool Error = false;
+    bool HasData = ReadBlock(Block, Error);
+    if (Error == true) m_Error = true;
+    return HasData;
+  }
+
+  unique_lock<mutex> Lock(m_Mutex);
+  if (Block.capacity() > 0) {
+    m_FreeBlocks.push_back(move(Block));
+  }
+  Block.clear();
+
+  m_BlockAvailable.wait(Lock, [this] { return m_Queue.empty() == false || m_EndOfFile == true; });
+  if (m_Queue.empty() == true) return false;
+
+  Block.swap(m_Queue.front());
+  m_Queue.pop_front();
+  Lock.unlock();
+  m_SpaceAvailable.notify_one();
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileReader::ReadSpan(const uint8_t*& Data, size_t& Length)
+{
+  // Return the next block of the file as a span
+
+  if (m_IsMapped == true) {
+    Length = min((size_t) m_BlockSize, m_MappedSize - m_MappedPosition);
+    Data = m_MappedData + m_MappedPosition;
+    m_MappedPosition += Length;
+    return Length > 0;
+  }
+
+  bool HasData = Read(m_SpanBlock);
+  Data = m_SpanBlock.data();
+  Length = m_SpanBlock.size();
+
+  return HasData;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileReader::HasError()
+{
+  // Return true if reading or decompressing the file failed
+
+  unique_lock<mutex> Lock(m_Mutex);
+  return m_Error;
+}
+
+
+// MBinaryFileReader.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,333 @@
+/*
+ * MBinaryFileWriter.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MBinaryFileWriter
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MBinaryFileWriter.h"
+
+// Standard libs:
+#include <climits>
+#include <algorithm>
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MBinaryFileWriter)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFileWriter::MBinaryFileWriter() : m_IsOpen(false), m_IsZipped(false), m_ZipFile(NULL), m_Error(false),
+  m_Asynchronous(false), m_NCompressionThreads(1), m_BufferSize(1 << 22), m_FirstJob(0), m_NextCompressionJob(0), m_Stop(false)
+{
+  // Construct an instance of MBinaryFileWriter
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MBinaryFileWriter::~MBinaryFileWriter()
+{
+  // Delete this instance of MBinaryFileWriter
+
+  Close();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileWriter::Open(const MString& FileName)
+{
+  // Open the file
+
+  Close();
+
+  m_IsZipped = FileName.EndsWith(".gz");
+  m_Error = false;
+
+  if (m_Asynchronous == true) {
+    // The gzip members are created by the compression threads
+    m_Out.clear();
+    m_Out.open(FileName, ios::binary | ios::trunc);
+    if (m_Out.is_open() == false) return false;
+
+    m_Buffer.clear();
+    m_Buffer.reserve(m_BufferSize);
+    m_FirstJob = 0;
+    m_NextCompressionJob = 0;
+    m_Stop = false;
+    if (m_IsZipped == true) {
+      for (unsigned int t = 0; t < m_NCompressionThreads; ++t) {
+        m_CompressionThreads.push_back(thread(&MBinaryFileWriter::RunCompression, this));
+      }
+    }
+    m_WriterThread = thread(&MBinaryFileWriter::RunWriter, this);
+  } else if (m_IsZipped == false) {
+    m_Out.clear();
+    m_Out.open(FileName, ios::binary | ios::trunc);
+    if (m_Out.is_open() == false) return false;
+  } else {
+    m_ZipFile = gzopen(FileName, "wb");
+    if (m_ZipFile == NULL) return false;
+    gzbuffer(m_ZipFile, 1 << 18);
+  }
+
+  m_IsOpen = true;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileWriter::Write(const uint8_t* Data, size_t Length)
+{
+  // Write Length bytes
+
+  if (m_IsOpen == false) return false;
+
+  if (m_Asynchronous == true && m_WriterThread.joinable() == true) {
+    // Fill the buffers exactly, so that each fits into one deflate call
+    while (Length > 0) {
+      size_t Chunk = min(Length, m_BufferSize - m_Buffer.size());
+      m_Buffer.insert(m_Buffer.end(), Data, Data + Chunk);
+      Data += Chunk;
+      Length -= Chunk;
+      if (m_Buffer.size() >= m_BufferSize) Submit();
+    }
+    return HasError() == false;
+  }
+
+  if (m_IsZipped == false) {
+    m_Out.write((const char*) Data, Length);
+    if (m_Out.good() == false) m_Error = true;
+  } else {
+    // gzwrite takes at most an unsigned int
+    while (Length > 0) {
+      unsigned int Chunk = (unsigned int) min(Length, (size_t) INT_MAX);
+      if (gzwrite(m_ZipFile, Data, Chunk) != (int) Chunk) {
+        int ErrorCode = 0;
+        const char* Message = gzerror(m_ZipFile, &ErrorCode);
+        cout<<"MBinaryFileWriter: Error: Unable to compress the data: "<<Message<<endl;
+        m_Error = true;
+        break;
+      }
+      Data += Chunk;
+      Length -= Chunk;
+    }
+  }
+
+  return m_Error == false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileWriter::HasError()
+{
+  // Return true if writing failed
+
+  lock_guard<mutex> Lock(m_Mutex);
+  return m_Error;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFileWriter::Submit()
+{
+  // Hand the current buffer to the background threads - wait if they are too far behind
+
+  if (m_Buffer.size() == 0) return;
+
+  unique_lock<mutex> Lock(m_Mutex);
+  m_SpaceAvailable.wait(Lock, [this](){ return m_Jobs.size() < 2*m_CompressionThreads.size() + 2; });
+
+  writejob* Job = nullptr;
+  if (m_FreeJobs.size() > 0) {
+    Job = m_FreeJobs.back();
+    m_FreeJobs.pop_back();
+  } else {
+    Job = new writejob();
+  }
+  // The current buffer goes to the job, and we continue with the buffer of the recycled job
+  Job->m_Data.swap(m_Buffer);
+  Job->m_IsReady = (m_IsZipped == false);
+  m_Jobs.push_back(Job);
+  m_Buffer.clear();
+
+  if (m_IsZipped == true) {
+    m_JobAvailable.notify_one();
+  } else {
+    m_JobReady.notify_one();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFileWriter::RunCompression()
+{
+  // The loop of a compression thread
+
+  unique_lock<mutex> Lock(m_Mutex);
+  while (true) {
+    m_JobAvailable.wait(Lock, [this](){ return m_Stop == true || m_NextCompressionJob < m_FirstJob + m_Jobs.size(); });
+    if (m_NextCompressionJob >= m_FirstJob + m_Jobs.size()) break;
+
+    // The writer only removes ready jobs, thus the job stays valid
+    writejob* Job = m_Jobs[m_NextCompressionJob - m_FirstJob];
+    ++m_NextCompressionJob;
+
+    Lock.unlock();
+    bool OK = Compress(Job->m_Data, Job->m_Compressed);
+    Lock.lock();
+
+    if (OK == false) {
+      cout<<"MBinaryFileWriter: Error: Unable to compress the data"<<endl;
+      m_Error = true;
+    }
+    Job->m_IsReady = true;
+    m_JobReady.notify_all();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFileWriter::RunWriter()
+{
+  // The loop of the writer thread - writes the jobs in order
+
+  unique_lock<mutex> Lock(m_Mutex);
+  while (true) {
+    m_JobReady.wait(Lock, [this](){ return (m_Jobs.size() > 0 && m_Jobs.front()->m_IsReady == true) || (m_Stop == true && m_Jobs.size() == 0); });
+    if (m_Jobs.size() == 0) break;
+
+    writejob* Job = m_Jobs.front();
+    m_Jobs.pop_front();
+    ++m_FirstJob;
+    bool Error = m_Error;
+
+    // After an error the data is discarded, but the jobs are still drained
+    Lock.unlock();
+    if (Error == false) {
+      const vector<uint8_t>& Data = (m_IsZipped == true) ? Job->m_Compressed : Job->m_Data;
+      m_Out.write((const char*) Data.data(), Data.size());
+      Error = (m_Out.good() == false);
+    }
+    Lock.lock();
+
+    if (Error == true) m_Error = true;
+    m_FreeJobs.push_back(Job);
+    m_SpaceAvailable.notify_one();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileWriter::Compress(const vector<uint8_t>& Data, vector<uint8_t>& Compressed)
+{
+  // Compress Data into a complete gzip member (the buffers are smaller than 4 GB)
+
+  z_stream Stream;
+  Stream.zalloc = Z_NULL;
+  Stream.zfree = Z_NULL;
+  Stream.opaque = Z_NULL;
+  // 15 + 16: maximum window and a gzip header & trailer
+  if (deflateInit2(&Stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+
+  Compressed.resize(deflateBound(&Stream, Data.size()));
+  Stream.next_in = (Bytef*) Data.data();
+  Stream.avail_in = Data.size();
+  Stream.next_out = Compressed.data();
+  Stream.avail_out = Compressed.size();
+
+  int Status = deflate(&Stream, Z_FINISH);
+  Compressed.resize(Stream.total_out);
+  deflateEnd(&Stream);
+
+  return Status == Z_STREAM_END;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFileWriter::Close()
+{
+  // Close the file
+
+  if (m_WriterThread.joinable() == true) {
+    // Write the remaining data and stop the background threads
+    Submit();
+    {
+      lock_guard<mutex> Lock(m_Mutex);
+      m_Stop = true;
+    }
+    m_JobAvailable.notify_all();
+    m_JobReady.notify_all();
+    for (thread& T: m_CompressionThreads) T.join();
+    m_CompressionThreads.clear();
+    m_WriterThread.join();
+
+    for (writejob* Job: m_FreeJobs) delete Job;
+    m_FreeJobs.clear();
+  }
+
+  if (m_Out.is_open() == true) {
+    m_Out.close();
+    if (m_Out.fail() == true) m_Error = true;
+  }
+  m_Out.clear();
+  if (m_ZipFile != NULL) {
+    if (gzclose(m_ZipFile) != Z_OK) m_Error = true;
+    m_ZipFile = NULL;
+  }
+
+  m_IsOpen = false;
+
+  return m_Error == false;
+}
+
+
+// MBinaryFileWriter.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -31,6 +31,7 @@
 // Standard libs:
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <time.h>
 using namespace std;
 
@@ -56,19 +57,10 @@ ClassImp(MBinaryFlightDataParser)
 #endif
 
 
-
-
-
 ////////////////////////////////////////////////////////////////////////////////
 
 
-bool MReadOutAssemblyTimeCompare(MReadOutAssembly* E1, MReadOutAssembly* E2);
-
-
-////////////////////////////////////////////////////////////////////////////////
-
-
-MBinaryFlightDataParser::MBinaryFlightDataParser() : TIRecord(1000)
+MBinaryFlightDataParser::MBinaryFlightDataParser() : TIRecord(1000), m_PacketRecord(10000)
 {
 	// Construct an instance of MBinaryFlightDataParser
 
@@ -86,6 +78,10 @@ MBinaryFlightDataParser::MBinaryFlightDataParser() : TIRecord(1000)
 	LastTimestamps.clear();
 	LastTimestamps.resize(12, 0);
 	dx = 0;
+	m_SData = NULL;
+	m_SSize = 0;
+	m_SExternal = false;
+	m_ReleasePacket = false;
 	m_EventTimeWindow = 60 * 10000000;
 	m_ComptonWindow = 2;
 	LoadStripMap();
@@ -98,12 +94,20 @@ MBinaryFlightDataParser::MBinaryFlightDataParser() : TIRecord(1000)
 	m_NumComptonBytes = 0;
 	m_NumBytesReceived = 0;
 	m_LostBytes = 0;
+	m_NumResyncs = 0;
+	m_ResyncSkippedBytes = 0;
 	m_IgnoreAspect = false;
 	m_LastDSOUnixTime = 0xffffffff;
 	m_LastAspectID = 0xffff;
 	m_AspectReconstructor = nullptr;
 	m_CoincidenceEnabled = true;
 	m_HousekeepingFileName = "Housekeeping.hkp";
+	m_DecodeOnly = false;
+	m_FoundPacket = false;
+	m_DecodedBlock.StartsStream = true;
+	m_DecodedBlock.NumResyncs = 0;
+	m_DecodedBlock.ResyncSkippedBytes = 0;
+	m_NDecodingThreads = 0;
 }
 
 
@@ -118,6 +122,17 @@ MBinaryFlightDataParser::~MBinaryFlightDataParser()
 		delete E;
 	}
 	m_Events.clear();
+	for (auto& F: m_DecodedBlock.Frames) {
+		for (auto E: F.Events) {
+			delete E;
+		}
+	}
+	m_DecodedBlock.Frames.clear();
+	ClearStagedDataframes();
+	for (auto E: m_AssemblyPool) {
+		delete E;
+	}
+	m_AssemblyPool.clear();
 }
 
 
@@ -148,7 +163,13 @@ bool MBinaryFlightDataParser::Initialize()
   m_NumComptonBytes = 0;
   m_NumBytesReceived = 0;
   m_LostBytes = 0;
+  m_NumResyncs = 0;
+  m_ResyncSkippedBytes = 0;
+  m_PacketRecord.Clear();
   
+  m_ThreadPool.SetNumberOfThreads(m_NDecodingThreads);
+  ClearStagedDataframes();
+
   m_LastDSOUnixTime = 0xffffffff;
   m_LastAspectID = 0xffff;
 
@@ -156,12 +177,16 @@ bool MBinaryFlightDataParser::Initialize()
     delete E;
   }
   m_Events.clear();
-  for (auto E: m_EventsBuf) {
-    delete E;
+  while (m_EventsBuf.IsEmpty() == false) {
+    delete m_EventsBuf.Pop();
   }
-  m_EventsBuf.clear();
   
   m_SBuf.clear();
+  m_SData = m_SBuf.data();
+  m_SSize = 0;
+  m_SExternal = false;
+  dx = 0;
+  m_ReleasePacket = false;
   
   m_LastDateTimeString = "";
   m_LastCorrectedClk = 0;
@@ -243,7 +268,57 @@ bool MReadOutAssemblyReverseSort(MReadOutAssembly* E1, MReadOutAssembly* E2) {
 ////////////////////////////////////////////////////////////////////////////////
 
 
-bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received) 
+bool MBinaryFlightDataParser::ParseData(const vector<uint8_t>& Received) 
+{
+	return ParseData( Received.size() > 0 ? &Received[0] : NULL, Received.size(), false );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::ClearSBuf(unsigned int Keep)
+{
+	//drop all searched bytes but the last Keep ones
+
+	if( m_SExternal == true ){
+		//just move the window, this keeps it contiguous with the next data
+		m_SData += m_SSize - Keep;
+		m_SSize = Keep;
+	} else {
+		if( Keep > 0 ){
+			m_SBuf.erase( m_SBuf.begin(), m_SBuf.end() - Keep );
+		} else {
+			m_SBuf.clear();
+		}
+		m_SData = m_SBuf.data();
+		m_SSize = m_SBuf.size();
+	}
+	dx = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::DetachExternalData()
+{
+	//copy the not yet processed external bytes into m_SBuf
+
+	if( m_SExternal == false ) return;
+
+	m_SBuf.assign( m_SData + dx, m_SData + m_SSize );
+	dx = 0;
+	m_SExternal = false;
+	m_SData = m_SBuf.data();
+	m_SSize = m_SBuf.size();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataParser::ParseData(const uint8_t* Received, size_t Length, bool IsPersistent)
 {
 	uint8_t Type;
 	vector <MReadOutAssembly*> NewEvents;
@@ -263,16 +338,49 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 
 	SyncWord.push_back(0xEB);
 	SyncWord.push_back(0x90);
-	m_NumBytesReceived += Received.size();
+	//in decode-only mode keep the start of the stream: the bytes before its first packet might complete
+	//a packet of the previous stream, which is at most 1360 bytes long
+	if( m_DecodeOnly == true && m_FoundPacket == false && m_StreamHead.size() < 1360 ){
+		m_StreamHead.insert( m_StreamHead.end(), Received, Received + min( Length, 1360 - m_StreamHead.size() ) );
+	}
+
+	m_NumBytesReceived += Length;
 	if (g_Verbosity >= c_Info) cout<<"BinaryFlightDataParser: NumBytesReceived "<<m_NumBytesReceived<<endl;
 
-	//apend the received data to m_SBuf
-	//might want to reserve space here
-	m_SBuf.insert( m_SBuf.end(), Received.begin(), Received.end() );
+	//drop the packets we have already processed -- only the leftover bytes are moved --
+	if( dx > 0 ){
+		if( m_SExternal == true ){
+			m_SData += dx;
+			m_SSize -= dx;
+		} else {
+			m_SBuf.erase( m_SBuf.begin(), m_SBuf.begin() + dx );
+		}
+		dx = 0;
+	}
+
+	//persistent data is searched in place: as long as it continues the previous persistent data
+	//the search window just grows, otherwise the leftover bytes are copied into m_SBuf
+	if( m_SExternal == true && (IsPersistent == false || Received != m_SData + m_SSize) ){
+		DetachExternalData();
+	}
+	if( m_SExternal == true ){
+		m_SSize += Length;
+	} else if( m_SBuf.size() == 0 && IsPersistent == true && Length > 0 ){
+		m_SExternal = true;
+		m_SData = Received;
+		m_SSize = Length;
+	} else {
+		//apend the received data to m_SBuf
+		if( Length > 0 ) m_SBuf.insert( m_SBuf.end(), Received, Received + Length );
+		m_SData = m_SBuf.data();
+		m_SSize = m_SBuf.size();
+	}
 	//FindNextPacket handles all the resyncing etc...
 
-	vector<uint8_t> NextPacket;
-	while (FindNextPacket( NextPacket )) {
+	//NextPacket points into the search window and is only valid until the next call of FindNextPacket
+	const uint8_t* NextPacket;
+	unsigned int NextPacketLength;
+	while (FindNextPacket( NextPacket, NextPacketLength )) {
 		Type = NextPacket[2] & 0x0f;
 		
 		uint64_t PacketKey = ((uint64_t)NextPacket[3] << 40) | 
@@ -282,21 +390,28 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 									((uint64_t)NextPacket[7] << 8) | 
 									Type;
 
-		if(m_PacketRecord.count(PacketKey) == 1){
-			//cout << "duplicate compton packet, ID:" << Dataframe->PacketCounter << " UNIXT:" << Dataframe->UnixTime << endl;
+		//in decode-only mode, the parser which continues with the decoded block rejects the duplicates
+		if( m_DecodeOnly == true ){
+			if( m_FoundPacket == false ){
+				m_FoundPacket = true;
+				//the search window always ends with the last received byte
+				size_t Offset = m_NumBytesReceived - ((m_SData + m_SSize) - NextPacket);
+				m_DecodedBlock.Head.assign( m_StreamHead.begin(), m_StreamHead.begin() + min( Offset, m_StreamHead.size() ) );
+				m_StreamHead.clear();
+			}
+			DecodePacket( NextPacket, NextPacketLength, Type, PacketKey );
 			continue;
-		} else {
-			m_PacketRecord[PacketKey] = (NextPacket[2] & 0x80) >> 7; //mapped value of zero -> normal data, or openport A. mapped value of one -> openport B
 		}
 
-		//trim the packet record
-		while(m_PacketRecord.size() > 10000){
-			m_PacketRecord.erase(m_PacketRecord.begin());
+		//the record remembers the last 10000 packets, the oldest ones are forgotten first
+		if(m_PacketRecord.Insert(PacketKey) == false){
+			//cout << "duplicate compton packet, ID:" << Dataframe->PacketCounter << " UNIXT:" << Dataframe->UnixTime << endl;
+			continue;
 		}
 
 		if (g_Verbosity >= c_Info) {
-			//printf("FNP: %u - %lu, dx = %d, bufsize = %lu\n",Type, NextPacket.size(), dx, m_SBuf.size());
-			cout<<"FNP: "<<hex<<Type<<" - "<<NextPacket.size()<<", dx = "<<dx<<", bufsize = "<<m_SBuf.size()<<endl;
+			//printf("FNP: %u - %u, dx = %d, bufsize = %lu\n",Type, NextPacketLength, dx, m_SSize);
+			cout<<"FNP: "<<hex<<Type<<" - "<<NextPacketLength<<", dx = "<<dx<<", bufsize = "<<m_SSize<<endl;
 		}
 
 
@@ -304,17 +419,22 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 			case 0x00:
 				//raw dataframe
 				if( m_DataSelectionMode == MBinaryFlightDataParserDataModes::c_Raw ){
-					Dataframe = new dataframe();
-					ParseErr = RawDataframe2Struct( NextPacket, Dataframe );
-					if( ParseErr >= 0 ){
-						ConvertToMReadOutAssemblys( Dataframe, &NewEvents );
-						//CCId = Dataframe->CCId;
+					if( m_ThreadPool.GetNumberOfThreads() > 0 ){
+						//decoded by the thread pool after all packets have been found
+						StageDataframe( NextPacket, NextPacketLength, Type, PacketKey );
 					} else {
-						if (g_Verbosity >= c_Error) cout<<"BinaryFlightDataParser: ParseERR"<<endl;
+						Dataframe = new dataframe();
+						ParseErr = RawDataframe2Struct( NextPacket, NextPacketLength, Dataframe );
+						if( ParseErr >= 0 ){
+							ConvertToMReadOutAssemblys( Dataframe, &NewEvents );
+							//CCId = Dataframe->CCId;
+						} else {
+							if (g_Verbosity >= c_Error) cout<<"BinaryFlightDataParser: ParseERR"<<endl;
+						}
+						//cout<<"made "<<NewEvents.size()<<" MReadOutAssemblys"<<endl;
+						delete Dataframe;
 					}
-					//cout<<"made "<<NewEvents.size()<<" MReadOutAssemblys"<<endl;
-					delete Dataframe;
-					m_NumRawDataBytes += NextPacket.size();
+					m_NumRawDataBytes += NextPacketLength;
 					//cout<<"NumRawDataBytes "<<m_NumRawDataBytes<<endl;
 					m_NumRawDataframes++;
 
@@ -323,26 +443,31 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 			case 0x01:
 				//compton dataframe
 				if( m_DataSelectionMode == MBinaryFlightDataParserDataModes::c_Compton ){
-					Dataframe = new dataframe();
-					if( ComptonDataframe2Struct( NextPacket, Dataframe ) ){
-						ConvertToMReadOutAssemblys( Dataframe, &NewEvents );
+					if( m_ThreadPool.GetNumberOfThreads() > 0 ){
+						//decoded by the thread pool after all packets have been found
+						StageDataframe( NextPacket, NextPacketLength, Type, PacketKey );
 					} else {
-						if (g_Verbosity >= c_Error) cout<<"BinaryFlightDataParser: Parsing error"<<endl;
+						Dataframe = new dataframe();
+						if( ComptonDataframe2Struct( NextPacket, NextPacketLength, Dataframe ) ){
+							ConvertToMReadOutAssemblys( Dataframe, &NewEvents );
+						} else {
+							if (g_Verbosity >= c_Error) cout<<"BinaryFlightDataParser: Parsing error"<<endl;
+						}
+						size_t NEvents = Dataframe->Events.size();
+						
+						/*
+						printf("!@# ID:%u UNIXT:%u (%u,%f) <---> (%u,%f)\n",Dataframe->PacketCounter,
+								                                              Dataframe->UnixTime,
+																							 Dataframe->Events[0].EventID,
+																							 ((double)NewEvents[0]->GetCL())*1E-7,
+																							 Dataframe->Events[NEvents-1].EventID,
+																							 ((double)NewEvents[NEvents-1]->GetCL())*1E-7);
+																							 */
+
+						delete Dataframe;
 					}
-					size_t NEvents = Dataframe->Events.size();
-					
-					/*
-					printf("!@# ID:%u UNIXT:%u (%u,%f) <---> (%u,%f)\n",Dataframe->PacketCounter,
-							                                              Dataframe->UnixTime,
-																						 Dataframe->Events[0].EventID,
-																						 ((double)NewEvents[0]->GetCL())*1E-7,
-																						 Dataframe->Events[NEvents-1].EventID,
-																						 ((double)NewEvents[NEvents-1]->GetCL())*1E-7);
-																						 */
-
-					delete Dataframe;
 					m_NumComptonDataframes++;
-					m_NumComptonBytes += NextPacket.size();
+					m_NumComptonBytes += NextPacketLength;
 
 				}
 				break;
@@ -351,7 +476,7 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 				if (g_Verbosity >= c_Info) cout<<"got aspect packet!"<<endl;
 				if (m_AspectMode != MBinaryFlightDataParserAspectModes::c_Neither) {
 	
-					ProcessAspect( NextPacket );
+					ProcessAspect( NextPacket, NextPacketLength );
 
 					//Print info into housekeeping file 
         	                      if (m_Housekeeping.is_open() == true) {
@@ -372,7 +497,7 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 				if (g_Verbosity >= c_Info) cout<<"got livetime packet!"<<endl;
 				//wait to get a gcu_hkp packet to use the unix time most sig bit
 				if (m_NumGCUHkpPackets > 0) {
-					ParseLivetime(&CCLivetimePacket,&NextPacket[0]);
+					ParseLivetime(&CCLivetimePacket,const_cast<uint8_t*>(NextPacket));
 					//Print CC livetime info into housekeeping file
 					if (m_Housekeeping.is_open() == true) {
 						m_Housekeeping<<"LT\nTI "<<((GCUUnixTimeMSB << 24) | CCLivetimePacket.UnixTime)<<"\nID "<<CCLivetimePacket.PacketCounter<<"\nDU 1";;
@@ -392,7 +517,7 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 				//gcu hkp packet
 
 				if (g_Verbosity >= c_Info) cout<<"got GCU housekeeping packet!"<<endl;
-				GCUHkpPacket = ParseGCUHousekeepingPacket(&NextPacket[0]);
+				GCUHkpPacket = ParseGCUHousekeepingPacket(const_cast<uint8_t*>(NextPacket));
 				GCUUnixTimeMSB = GCUHkpPacket->UnixTimeMSB;
 
 				//Calculate shield rate
@@ -409,7 +534,7 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 			case 0x0b:
 				//preamp temperatures
 				if (g_Verbosity >= c_Info) cout<<"got settings packet!"<<endl;
-				SettingsPacket = ParseGCUSettingsPacket(&NextPacket[0]);
+				SettingsPacket = ParseGCUSettingsPacket(const_cast<uint8_t*>(NextPacket));
 				//Order of PreampTemps are defined as Det0 DC, Det0 AC, Det1 DC, Det1, AC...etc
 				m_PreampTemps[0] = SettingsPacket->RpiTemp_Brd2_Ch0;
 				m_PreampTemps[1] = SettingsPacket->RpiTemp_Brd2_Ch3;
@@ -500,21 +625,7 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 					m_EventsBuf.push_back(E);
 				}
 				*/
-				if(m_EventsBuf.size() > 0){
-					if(E->GetCL() < (m_EventsBuf.front()->GetCL() >> 1)){ //event time jumped back too far
-						cout << "event time back-skip: this CL = " << E->GetCL() << ", front CL = " << m_EventsBuf.front()->GetCL() << ", back CL = " << m_EventsBuf.back()->GetCL() << endl;
-						while(m_EventsBuf.size() > 0){
-							MReadOutAssembly* Ev = m_EventsBuf.front(); m_EventsBuf.pop_front();
-							delete Ev;
-						}
-						m_EventsBuf.push_back(E);
-					} else {
-						deque<MReadOutAssembly*>::iterator I = lower_bound(m_EventsBuf.begin(), m_EventsBuf.end(), E, MReadOutAssemblyReverseSort);
-						m_EventsBuf.insert(I, E);
-					}
-				} else {
-					m_EventsBuf.push_back(E);
-				}
+				AddToEventsBuf(E);
 
 			}
 			NewEvents.clear();
@@ -530,6 +641,41 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 		}
 	}
 
+	//the staged dataframes are decoded in parallel, their events are added in packet order
+	if( m_StagedFrames.size() > 0 ){
+		DecodeStagedDataframes();
+	}
+
+	return ProcessEventsBuf();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::AddToEventsBuf(MReadOutAssembly* E)
+{
+	//insert the event into the time ordered (but unmerged) events buffer
+
+	if(m_EventsBuf.IsEmpty() == false){
+		if(E->GetCL() < (m_EventsBuf.GetEarliestCL() >> 1)){ //event time jumped back too far
+			cout << "event time back-skip: this CL = " << E->GetCL() << ", front CL = " << m_EventsBuf.GetEarliestCL() << ", back CL = " << m_EventsBuf.GetLatestCL() << endl;
+			while(m_EventsBuf.IsEmpty() == false){
+				ReleaseAssembly(m_EventsBuf.Pop());
+			}
+		}
+	}
+	//the queue keeps the events in time order, O(log n) per event
+	m_EventsBuf.Push(E);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataParser::ProcessEventsBuf(void)
+{
+	//move the events, which left the time window, into the final events list and return true if the first one can be analyzed
+
 	CheckEventsBuf();
 
 	if( m_AspectMode != MBinaryFlightDataParserAspectModes::c_Neither){
@@ -585,43 +731,300 @@ bool MBinaryFlightDataParser::ParseData(vector<uint8_t> Received)
 
 }
 
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::DecodePacket(const uint8_t* Packet, unsigned int Length, uint8_t Type, uint64_t PacketKey)
+{
+	//decode a selected dataframe, keep the bytes of all other packets for the parser which continues with the block
+
+	if( Type == 0x00 || Type == 0x01 ){
+		if( (Type == 0x00 && m_DataSelectionMode != MBinaryFlightDataParserDataModes::c_Raw) || 
+				(Type == 0x01 && m_DataSelectionMode != MBinaryFlightDataParserDataModes::c_Compton) ){
+			return;
+		}
+
+		m_DecodedBlock.Frames.emplace_back();
+		decodedframe& Frame = m_DecodedBlock.Frames.back();
+		Frame.PacketKey = PacketKey;
+		Frame.Type = Type;
+		Frame.Length = Length;
+
+		DecodeDataframe( Packet, Length, Type, Frame.Events, true );
+	} else {
+		m_DecodedBlock.OtherPackets.insert( m_DecodedBlock.OtherPackets.end(), Packet, Packet + Length );
+	}
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataParser::DecodeDataframe(const uint8_t* Packet, unsigned int Length, uint8_t Type, vector<MReadOutAssembly*>& Events, bool UsePool)
+{
+	//decode a raw or Compton dataframe into its events - without the pool this can run on any thread
+
+	dataframe Dataframe;
+	bool Decoded;
+	if( Type == 0x00 ){
+		Decoded = RawDataframe2Struct( Packet, Length, &Dataframe ) >= 0;
+	} else {
+		Decoded = ComptonDataframe2Struct( Packet, Length, &Dataframe );
+	}
+	if( Decoded ){
+		ConvertToMReadOutAssemblys( &Dataframe, &Events, UsePool );
+	} else {
+		if (g_Verbosity >= c_Error) cout<<"BinaryFlightDataParser: Parsing error"<<endl;
+	}
+
+	return Decoded;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::StageDataframe(const uint8_t* Packet, unsigned int Length, uint8_t Type, uint64_t PacketKey)
+{
+	//copy the dataframe, since the search window might be compacted before it is decoded
+
+	m_StagedFrames.emplace_back();
+	decodedframe& Frame = m_StagedFrames.back();
+	Frame.PacketKey = PacketKey;
+	Frame.Type = Type;
+	Frame.Length = Length;
+
+	m_StagedOffsets.push_back( m_StagedBytes.size() );
+	m_StagedBytes.insert( m_StagedBytes.end(), Packet, Packet + Length );
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::DecodeStagedDataframes()
+{
+	//decode the staged dataframes on the thread pool, then add their events in packet order
+	//the events buffer is only touched here, thus the time ordering is the same as without threads
+
+	m_ThreadPool.ParallelFor( m_StagedFrames.size(), [this](unsigned int i) {
+		decodedframe& Frame = m_StagedFrames[i];
+		DecodeDataframe( &m_StagedBytes[m_StagedOffsets[i]], Frame.Length, Frame.Type, Frame.Events, false );
+	});
+
+	for( auto& Frame: m_StagedFrames ){
+		for( auto E: Frame.Events ){
+			AddToEventsBuf(E);
+		}
+		Frame.Events.clear();
+	}
+	m_StagedFrames.clear();
+	m_StagedOffsets.clear();
+	m_StagedBytes.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::ClearStagedDataframes()
+{
+	//delete the staged dataframes and their events
+
+	for (auto& F: m_StagedFrames) {
+		for (auto E: F.Events) {
+			delete E;
+		}
+	}
+	m_StagedFrames.clear();
+	m_StagedOffsets.clear();
+	m_StagedBytes.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::TakeDecodedBlock(decodedblock& Block)
+{
+	//hand out everything decoded since the last call
+
+	for (auto& F: Block.Frames) {
+		for (auto E: F.Events) {
+			ReleaseAssembly(E);
+		}
+	}
+	Block.Frames.clear();
+	Block.OtherPackets.clear();
+
+	Block.Head.clear();
+	Block.Tail.clear();
+
+	swap(Block, m_DecodedBlock);
+	m_DecodedBlock.StartsStream = false;
+	Block.NumResyncs = m_NumResyncs;
+	Block.ResyncSkippedBytes = m_ResyncSkippedBytes;
+	m_NumResyncs = 0;
+	m_ResyncSkippedBytes = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::FinishDecoding()
+{
+	//after a resync the next packet is only found by the next call of ParseData, thus parse until nothing changes anymore
+
+	size_t Unparsed;
+	do {
+		Unparsed = m_SSize - dx;
+		ParseData( NULL, 0, false );
+	} while( m_SSize - dx < Unparsed );
+
+	//the rest might be completed by the next stream
+	m_DecodedBlock.Tail.assign( m_SData + dx, m_SData + m_SSize );
+	ClearSBuf();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MBinaryFlightDataParser::ParseDecodedBlock(decodedblock& Block)
+{
+	//continue with a block decoded ahead as if its data had been received now
+
+	if( Block.StartsStream == true ){
+		//a packet split between two streams is completed with the bytes before the first packet of the new stream,
+		//anything else left over from the previous stream cannot be completed anymore
+		DetachExternalData();
+		if( m_SSize > dx && Block.Head.size() > 0 ){
+			ParseData( Block.Head.data(), Block.Head.size(), false );
+		}
+		if( m_SSize > dx ){
+			m_LostBytes += m_SSize - dx;
+		}
+		ClearSBuf();
+	}
+
+	//the other packets (aspect, housekeeping, etc.) are parsed as usual
+	if( Block.OtherPackets.size() > 0 ){
+		ParseData( Block.OtherPackets.data(), Block.OtherPackets.size(), false );
+	}
+	//the unparsed bytes at the end of the stream are kept for the next stream
+	if( Block.Tail.size() > 0 ){
+		ParseData( Block.Tail.data(), Block.Tail.size(), false );
+	}
+	m_NumResyncs += Block.NumResyncs;
+	m_ResyncSkippedBytes += Block.ResyncSkippedBytes;
+
+	//reject the duplicated dataframes
+	vector<pair<uint64_t, pair<unsigned int, unsigned int>>> Heap; //CL, frame, event
+	for( unsigned int f = 0; f < Block.Frames.size(); ++f ){
+		decodedframe& Frame = Block.Frames[f];
+		m_NumBytesReceived += Frame.Length;
+		if( m_PacketRecord.Insert( Frame.PacketKey ) == false ){
+			for( auto E: Frame.Events ){
+				ReleaseAssembly(E);
+			}
+			Frame.Events.clear();
+			continue;
+		}
+		if( Frame.Type == 0x00 ){
+			m_NumRawDataBytes += Frame.Length;
+			m_NumRawDataframes++;
+		} else {
+			m_NumComptonDataframes++;
+			m_NumComptonBytes += Frame.Length;
+		}
+		if( Frame.Events.size() > 0 ){
+			Heap.push_back( make_pair( Frame.Events[0]->GetCL(), make_pair( f, 0U ) ) );
+		}
+	}
+
+	//k-way merge of the time ordered events of all dataframes, thus they reach the events buffer in time order
+	auto Later = [](const pair<uint64_t, pair<unsigned int, unsigned int>>& A, const pair<uint64_t, pair<unsigned int, unsigned int>>& B) { return A.first > B.first; };
+	make_heap( Heap.begin(), Heap.end(), Later );
+	while( Heap.size() > 0 ){
+		pop_heap( Heap.begin(), Heap.end(), Later );
+		unsigned int f = Heap.back().second.first;
+		unsigned int e = Heap.back().second.second;
+		AddToEventsBuf( Block.Frames[f].Events[e] );
+		if( ++e < Block.Frames[f].Events.size() ){
+			Heap.back() = make_pair( Block.Frames[f].Events[e]->GetCL(), make_pair( f, e ) );
+			push_heap( Heap.begin(), Heap.end(), Later );
+		} else {
+			Heap.pop_back();
+		}
+	}
+
+	//the events are now owned by the events buffer
+	Block.Frames.clear();
+	Block.OtherPackets.clear();
+	Block.Head.clear();
+	Block.Tail.clear();
+
+	return ProcessEventsBuf();
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 
-bool MBinaryFlightDataParser::FindNextPacket(vector<uint8_t>& NextPacket , unsigned int * idx){
+bool MBinaryFlightDataParser::FindNextPacket(const uint8_t*& NextPacket, unsigned int& NextPacketLength, unsigned int * idx){
 
-	//return true if a complete packet was found, return packet in NextPacket
-	//return false if a complete packet was not found.  also copy the leftover bytes
-	//back to the beginning
+	//return true if a complete packet was found, NextPacket then points to it in the search window
+	//and stays valid until the next call of FindNextPacket or ParseData (no copy)
+	//return false if a complete packet was not found.  ParseData moves the leftover bytes
+	//back to the beginning before appending new data
 
-	//idx is the value of dx that points to the beginning of the packet in m_SBuf
+	//idx is the value of dx that points to the beginning of the packet in the search window
 
 	//assert: search buf is either synced or empty
 
 	uint16_t Len;
 	//bool FoundPacket;
 	//FoundPacket = false;
-	NextPacket.clear();
+	NextPacket = NULL;
+	NextPacketLength = 0;
 
-	if( (dx + 2) > m_SBuf.size() ){
+	//the packet handed out last time has been processed, now we can release its bytes
+	if( m_ReleasePacket == true ){
+		m_ReleasePacket = false;
+
+		if( dx == m_SSize ){
+			//no leftover bytes, just clear the buffer
+			ClearSBuf();
+		}
+
+		if( m_SSize > 10000000 ){
+			//clear out buffer
+			cout<<"lost !!! dx = "<<dx<<" size = "<<m_SSize<<endl;
+			m_LostBytes += m_SSize - dx;
+			ClearSBuf();
+		}
+	}
+
+	if( (dx + 2) > m_SSize ){
 		//not enough bytes to check for sync
 		return false;
 	}
 
-	while( !(m_SBuf[dx] == 0xeb && m_SBuf[dx+1] == 0x90) ){
-		ResyncSBuf();
-		if( m_SBuf.size() == 0 ){
+	if( !(m_SData[dx] == 0xeb && m_SData[dx+1] == 0x90) ){
+		if( ResyncSBuf() == false ){
 			return false;
 		}
 	}
 
 	//we are synced and the buffer is not empty
-	if( (dx + 10) > m_SBuf.size() ){
+	if( (dx + 10) > m_SSize ){
 		//not enough bytes to compute len
 		return false;
 	}
 
-	Len = ((uint16_t)m_SBuf[dx+8]<<8) | ((uint16_t)m_SBuf[dx+9]);
+	Len = ((uint16_t)m_SData[dx+8]<<8) | ((uint16_t)m_SData[dx+9]);
 	if( Len > 1360 ){
 		//got a weird value, could be a spurious eb90, Resync() and exit
 		ResyncSBuf();
@@ -631,23 +1034,24 @@ bool MBinaryFlightDataParser::FindNextPacket(vector<uint8_t>& NextPacket , unsig
 	// Skip ahead beyond syncword and resync
 	if (Len == 0) {
 		dx += 2; 
+		//the sync word is skipped as well
+		m_ResyncSkippedBytes += 2;
 		ResyncSBuf();
 		return false;
 	}
 
-	if( (dx + Len) > m_SBuf.size() ){
+	if( (dx + Len) > m_SSize ){
 		//we don't have the complete packet
 		//this should happen often since TCP will give us a bunch of bytes w/o boundaries 
-		//move the data up so as to clear out the packets we have already processed
-		m_SBuf.assign( m_SBuf.begin() + dx, m_SBuf.end() );
-		dx = 0;
+		//ParseData moves the data up so as to clear out the packets we have already processed
 		return false;
 	}
 
 	//FoundPacket = true;
 
-	//we have a complete packet, extract it
-	NextPacket.assign( m_SBuf.begin() + dx, m_SBuf.begin() + dx + Len);
+	//we have a complete packet, hand it out
+	NextPacket = m_SData + dx;
+	NextPacketLength = Len;
 	//store the location of beginning of this packet
 	if( idx != NULL ){
 		*idx = dx;
@@ -655,19 +1059,8 @@ bool MBinaryFlightDataParser::FindNextPacket(vector<uint8_t>& NextPacket , unsig
 	//increment the index...we should be pointing at the next 0xeb 
 	dx += Len;
 
-	if( dx == m_SBuf.size() ){
-		//no leftover bytes, just clear the buffer
-		dx = 0;
-		m_SBuf.clear();
-	}
-
-	if( m_SBuf.size() > 10000000 ){
-		//clear out buffer
-		cout<<"lost !!! dx = "<<dx<<" size = "<<m_SBuf.size()<<endl;
-		m_LostBytes += m_SBuf.size() - dx;
-		dx = 0;
-		m_SBuf.clear();
-	}
+	//the bytes of this packet are released at the next call
+	m_ReleasePacket = true;
 
 	return true;
 
@@ -680,41 +1073,68 @@ bool MBinaryFlightDataParser::FindNextPacket(vector<uint8_t>& NextPacket , unsig
 bool MBinaryFlightDataParser::ResyncSBuf(void){
 
 
-	//this method makes sure that either m_SBuf[dx] = 0xeb and m_SBuf[dx+1] = 0x90
-	//or that the buffer is empty and dx = 0;
+	//this method makes sure that either m_SData[dx] = 0xeb and m_SData[dx+1] = 0x90
+	//or that the buffer is empty (or only holds a trailing 0xeb) and dx = 0;
 
 	//start from the +1th element when searching for 0xeb, or check if the current
 	//Buf[dx] is eb, and if it is then + 1
+	//the candidates are found with memchr, which scans many bytes at once, and
+	//a candidate is only accepted if its length field (if already received) is valid
 
-	if (g_Verbosity >= c_Info) cout<<"BinaryFlightDataParser: Resyncing input stream! Buffer size: "<<m_SBuf.size()<<", position in buffer: "<<dx<<endl;
+	if (g_Verbosity >= c_Info) cout<<"BinaryFlightDataParser: Resyncing input stream! Buffer size: "<<m_SSize<<", position in buffer: "<<dx<<endl;
 
 	bool FoundSync;
 
-	if( m_SBuf.size() == 0 ){
+	if( m_SSize == 0 ){
 		dx = 0;
 		FoundSync = false;
 		return FoundSync;
 	}
 
+	++m_NumResyncs;
+	unsigned int Start = dx;
+
 	//we might be pointing at a spurious 0xeb 0x90, rare case... add 1 so that
-	//the for loop below doesn't think its on a valid sync word
-	if (m_SBuf[dx] == 0xeb) ++dx;
+	//the search below doesn't think its on a valid sync word
+	if (m_SData[dx] == 0xeb) ++dx;
 
 	FoundSync = false;
-	for(unsigned i = dx; i < m_SBuf.size()-1; ++i) { // m_SBuf is not allowed to be 0 so we are OK
-		if( m_SBuf[i] == 0xeb ){
-			if( m_SBuf[i+1] == 0x90 ){
+	const uint8_t* Begin = m_SData;
+	const uint8_t* End = Begin + m_SSize;
+	const uint8_t* Candidate = Begin + dx;
+	while( Candidate < End - 1 ){
+		Candidate = (const uint8_t*) memchr(Candidate, 0xeb, (End - 1) - Candidate);
+		if( Candidate == NULL ) break;
+		if( Candidate[1] == 0x90 ){
+			//check the length field if we have it, otherwise FindNextPacket will do it later
+			if( Candidate + 10 > End ){
 				FoundSync = true;
-				dx = i;
+			} else {
+				uint16_t Len = ((uint16_t)Candidate[8]<<8) | ((uint16_t)Candidate[9]);
+				if( Len > 0 && Len <= 1360 ){
+					FoundSync = true;
+				}
+			}
+			if( FoundSync == true ){
+				dx = Candidate - Begin;
 				break;
 			}
 		}
+		++Candidate;
 	}
 
 	if( !FoundSync ){
-		m_SBuf.clear();
-		dx = 0;
-	} 
+		//keep a trailing 0xeb, its 0x90 might arrive with the next block
+		if( m_SData[m_SSize-1] == 0xeb && m_SSize - Start > 1 ){
+			m_ResyncSkippedBytes += m_SSize - Start - 1;
+			ClearSBuf(1);
+		} else {
+			m_ResyncSkippedBytes += m_SSize - Start;
+			ClearSBuf();
+		}
+	} else {
+		m_ResyncSkippedBytes += dx - Start;
+	}
 
 	return FoundSync;
 
@@ -729,14 +1149,14 @@ bool MBinaryFlightDataParser::FlushEventsBuf(void){
 	//int MergedEventCounter = 0;
 
 	//don't check m_EventTimeWindow, we are flushing the buffer
-	while( m_EventsBuf.size() > 0){
-		MReadOutAssembly * FirstEvent = m_EventsBuf.front(); m_EventsBuf.pop_front();
+	while( m_EventsBuf.IsEmpty() == false){
+		MReadOutAssembly * FirstEvent = m_EventsBuf.Pop();
 		deque<MReadOutAssembly*> EventList;
 		EventList.push_back(FirstEvent);
 		//now check if the next events are within the compton window
-		while( m_EventsBuf.size() > 0 ){
-			if( (m_EventsBuf[0]->GetCL() - FirstEvent->GetCL()) <= m_ComptonWindow ){
-				EventList.push_back( m_EventsBuf.front() ); m_EventsBuf.pop_front();
+		while( m_EventsBuf.IsEmpty() == false ){
+			if( (m_EventsBuf.GetEarliestCL() - FirstEvent->GetCL()) <= m_ComptonWindow ){
+				EventList.push_back( m_EventsBuf.Pop() );
 			} else {
 				break;
 			}
@@ -749,7 +1169,7 @@ bool MBinaryFlightDataParser::FlushEventsBuf(void){
 		m_Events.push_back( NewMergedEvent );
 	}
 
-	if( m_EventsBuf.size() == 0 ) return true; else return false;
+	if( m_EventsBuf.IsEmpty() == true ) return true; else return false;
 }
 
 
@@ -768,25 +1188,25 @@ bool MBinaryFlightDataParser::CheckEventsBuf(void){
 		Window = m_EventTimeWindow;
 	}
 
-	if( m_EventsBuf.size() > 0 ){
-		if (m_EventsBuf.back()->GetCL() - m_EventsBuf.front()->GetCL() < 100000 && 
-				m_EventsBuf.size() > 500) {
+	if( m_EventsBuf.IsEmpty() == false ){
+		if (m_EventsBuf.GetLatestCL() - m_EventsBuf.GetEarliestCL() < 100000 && 
+				m_EventsBuf.GetSize() > 500) {
 			cout<<"Something is strange: I have more than 500 events and all are within the time window of 10 milli-seconds"<<endl;
 		}    
 	}
 
 	//pop good events
-	while(m_EventsBuf.size() > 0){
-		if(m_EventsBuf.back()->GetCL() - m_EventsBuf.front()->GetCL() >= Window ){
-			MReadOutAssembly * FirstEvent = m_EventsBuf.front(); m_EventsBuf.pop_front();
+	while(m_EventsBuf.IsEmpty() == false){
+		if(m_EventsBuf.GetLatestCL() - m_EventsBuf.GetEarliestCL() >= Window ){
+			MReadOutAssembly * FirstEvent = m_EventsBuf.Pop();
 			deque<MReadOutAssembly*> EventList;
 			EventList.push_back(FirstEvent);
 
 			if( m_CoincidenceEnabled ){
 				//now check if the next events are within the compton window
-				while( m_EventsBuf.size() > 0 ){
-					if( (m_EventsBuf[0]->GetCL() - FirstEvent->GetCL()) <= m_ComptonWindow ){
-						EventList.push_back( m_EventsBuf.front() ); m_EventsBuf.pop_front();
+				while( m_EventsBuf.IsEmpty() == false ){
+					if( (m_EventsBuf.GetEarliestCL() - FirstEvent->GetCL()) <= m_ComptonWindow ){
+						EventList.push_back( m_EventsBuf.Pop() );
 					} else {
 						break;
 					}
@@ -797,7 +1217,7 @@ bool MBinaryFlightDataParser::CheckEventsBuf(void){
 			//now push this merged event onto the internal events deque
 			NewMergedEvent->SetID( ++m_EventIDCounter );
 			m_Events.push_back(NewMergedEvent);
-			//if( m_EventsBuf.size() == 0 ) break;
+			//if( m_EventsBuf.IsEmpty() == true ) break;
 		} else {
 			break;
 		}
@@ -810,6 +1230,40 @@ bool MBinaryFlightDataParser::CheckEventsBuf(void){
 ////////////////////////////////////////////////////////////////////////////////
 
 
+MReadOutAssembly* MBinaryFlightDataParser::NewAssembly()
+{
+	//return an empty MReadOutAssembly, a recycled one if we have one
+
+	if( m_AssemblyPool.size() == 0 ){
+		return new MReadOutAssembly();
+	}
+
+	MReadOutAssembly* Assembly = m_AssemblyPool.back();
+	m_AssemblyPool.pop_back();
+	return Assembly;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MBinaryFlightDataParser::ReleaseAssembly(MReadOutAssembly* Assembly)
+{
+	//clear the MReadOutAssembly (this deletes its remaining hits) and keep it for reuse
+
+	if( m_AssemblyPool.size() >= c_MaxAssemblyPoolSize ){
+		delete Assembly;
+		return;
+	}
+
+	Assembly->Clear();
+	m_AssemblyPool.push_back(Assembly);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 MReadOutAssembly * MBinaryFlightDataParser::MergeEvents( deque<MReadOutAssembly*> * EventList ){
 
 	//assert: there is at least one event in event list
@@ -819,17 +1273,10 @@ MReadOutAssembly * MBinaryFlightDataParser::MergeEvents( deque<MReadOutAssembly*
 	//events into this base event
 	BaseEvent = EventList->front(); EventList->pop_front();
 	for( auto E: *EventList ){
-		while( E->GetNStripHits() > 0){
-			BaseEvent->AddStripHit( E->GetStripHit(0) );
-			E->RemoveStripHit(0);
-		}
-		while( E->GetNStripHitsTOnly() > 0){
-			BaseEvent->AddStripHitTOnly( E->GetStripHitTOnly(0) );
-			E->RemoveStripHitTOnly(0);
-		}
-		//now we should free the memory for the MReadOutAssembly that we just copied the 
-		//strip hit from
-		delete E;
+		BaseEvent->StealStripHits( E );
+		//now we can recycle the MReadOutAssembly that we just moved the 
+		//strip hits from
+		ReleaseAssembly( E );
 	}
 
 	return BaseEvent;
@@ -844,9 +1291,8 @@ void MBinaryFlightDataParser::Finalize()
 {
 	// Close the tranceiver 
   
-  while (m_EventsBuf.begin() != m_EventsBuf.end()) {
-    delete m_EventsBuf.front();
-    m_EventsBuf.pop_front();
+  while (m_EventsBuf.IsEmpty() == false) {
+    delete m_EventsBuf.Pop();
   }
 	while (m_Events.begin() != m_Events.end()) {
 		delete m_Events.front();
@@ -855,6 +1301,10 @@ void MBinaryFlightDataParser::Finalize()
 
 	m_Housekeeping.close();
 	cout<<"HOUSEKEEPING FILE CLOSED"<<endl;
+
+	if( m_NumResyncs > 0 ){
+		cout<<"BinaryFlightDataParser: Resynced the input stream "<<m_NumResyncs<<" times and skipped "<<m_ResyncSkippedBytes<<" bytes"<<endl;
+	}
 	return;
 }
 
@@ -862,7 +1312,7 @@ void MBinaryFlightDataParser::Finalize()
 ////////////////////////////////////////////////////////////////////////////////
 
 
-int MBinaryFlightDataParser::RawDataframe2Struct( vector<uint8_t> Buf, dataframe * DataOut)
+int MBinaryFlightDataParser::RawDataframe2Struct( const uint8_t* Buf, unsigned int BufSize, dataframe * DataOut)
 {
 	//return a dataframe struct
 	//a subsequent funtion should dtake the returned dataframe and return a vector of MReadOutAssemblys
@@ -889,11 +1339,11 @@ int MBinaryFlightDataParser::RawDataframe2Struct( vector<uint8_t> Buf, dataframe
 		return -1;
 	}
 
-	if( Buf.size() != 1360 ){
+	if( BufSize != 1360 ){
 		cout<<"dataframe must be 1360 bytes! returning -1..."<<endl;
 		return -1;
 	} else {
-		Length = Buf.size();
+		Length = BufSize;
 	}
 
 	//check that we get the first 0xae 0xe0 in the right place
@@ -1139,7 +1589,7 @@ loop_exit:
 ///////////////////////////////////////////////////////////////////////
 
 
-bool MBinaryFlightDataParser::ConvertToMReadOutAssemblys( dataframe * DataIn, vector<MReadOutAssembly*> * CEvents)
+bool MBinaryFlightDataParser::ConvertToMReadOutAssemblys( dataframe * DataIn, vector<MReadOutAssembly*> * CEvents, bool UsePool)
 {
 	bool PosSide;
 	MReadOutAssembly * NewEvent;
@@ -1180,7 +1630,8 @@ bool MBinaryFlightDataParser::ConvertToMReadOutAssemblys( dataframe * DataIn, ve
 	//positive side -> AC -> boards 0-3 -> Y
 
 	for( auto E: DataIn->Events ){
-		NewEvent = new MReadOutAssembly();
+		//the pool is not thread safe
+		NewEvent = UsePool ? NewAssembly() : new MReadOutAssembly();
 		for( auto T: E.Triggers ){
 			StripHit = new MStripHit();
 			StripHit->SetDetectorID(m_CCMap[T.CCId]);
@@ -1353,29 +1804,11 @@ void MBinaryFlightDataParser::LoadStripMap(void){
 
 ///////////////////////////////////////////////////////////////////
 
-bool MBinaryFlightDataParser::SortEventsBuf(void){
-
-	std::sort(m_EventsBuf.begin(), m_EventsBuf.end(), MReadOutAssemblyTimeCompare);
-	return true;
-
-}
-
-///////////////////////////////////////////////////////////////////
-
-bool MReadOutAssemblyTimeCompare(MReadOutAssembly * E1, MReadOutAssembly * E2){
-
-	//sort based on 48 bit clock value
-	if( E1->GetCL() < E2->GetCL() ) return true; else return false;
-
-}
-
-///////////////////////////////////////////////////////////////////
-
-bool MBinaryFlightDataParser::ProcessAspect( vector<uint8_t> & NextPacket ){
+bool MBinaryFlightDataParser::ProcessAspect( const uint8_t* NextPacket, unsigned int Length ){
 
 	//look for '$'
 
-	int Len = NextPacket.size();
+	int Len = Length;
 	int wx = 0; // skip to first byte
 	bool NotEnoughBytes = false;
 	int i;
@@ -1427,7 +1860,7 @@ bool MBinaryFlightDataParser::ProcessAspect( vector<uint8_t> & NextPacket ){
 					//check that we have enough bytes in the buffer for this
 					if( (wx + DSOLen) <= Len ){
 						vector<uint8_t> DSOMsg;
-						DSOMsg.assign( NextPacket.begin() + wx, NextPacket.begin() + wx + DSOLen );
+						DSOMsg.assign( NextPacket + wx, NextPacket + wx + DSOLen );
 						MAspectPacket DSOPacket;
 						DecodeDSO( DSOMsg, DSOPacket );//transfer info from DSO msg into an MAspectPacket
 						DSOPacket.PPSClk |= UpperClkBytes;
@@ -1470,7 +1903,7 @@ bool MBinaryFlightDataParser::ProcessAspect( vector<uint8_t> & NextPacket ){
 								//from the last DSO message processed, since this will have happened in the future.
 								vector<uint8_t> MagMsg;
 								MAspectPacket MagPacket;
-								MagMsg.assign( NextPacket.begin() + wx, NextPacket.begin() + wx + MagLen );
+								MagMsg.assign( NextPacket + wx, NextPacket + wx + MagLen );
 								DecodeMag( MagMsg, MagPacket );
 
 								//copy over all necessary parameters to MagPacket from m_LastDSOPacket
@@ -1983,10 +2416,10 @@ bool MBinaryFlightDataParser::DecodeMag(vector<uint8_t>& MagString, MAspectPacke
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 
-bool MBinaryFlightDataParser::ComptonDataframe2Struct( vector<uint8_t>& Buf, dataframe * DataOut ){
+bool MBinaryFlightDataParser::ComptonDataframe2Struct( const uint8_t* Buf, unsigned int Length, dataframe * DataOut ){
 
 	size_t wx = 0;
-	size_t BufSize = Buf.size();
+	size_t BufSize = Length;
 	int EvCnt = 0;
 
 	if( DataOut == NULL ){
@@ -0,0 +1,690 @@
+/*
+ * MDatFileParser.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MDatFileParser
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MDatFileParser.h"
+
+// Standard libs:
+#include <charconv>
+#include <cstring>
+#include <string>
+
+// ROOT libs:
+
+// MEGAlib libs:
+#include "MFile.h"
+#include "MVector.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MDatFileParser)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! A BD flag: its name in the BD line and its setter
+struct MDatFileParserBDFlag {
+  const char* m_Name;
+  void (MReadOutAssembly::*m_Set)(bool, MString);
+};
+//! The BD flags in the order of MReadOutAssembly::IsBad()
+static const MDatFileParserBDFlag g_BDFlags[] = {
+  { "AspectIncomplete", &MReadOutAssembly::SetAspectIncomplete },
+  { "TimeIncomplete", &MReadOutAssembly::SetTimeIncomplete },
+  { "EnergyCalibrationIncomplete_BadStrip", &MReadOutAssembly::SetEnergyCalibrationIncomplete_BadStrip },
+  { "EnergyCalibrationIncomplete", &MReadOutAssembly::SetEnergyCalibrationIncomplete },
+  { "EnergyResolutionCalibrationIncomplete", &MReadOutAssembly::SetEnergyResolutionCalibrationIncomplete },
+  { "StripPairingIncomplete", &MReadOutAssembly::SetStripPairingIncomplete },
+  { "LLDEvent", &MReadOutAssembly::SetLLDEvent },
+  { "DepthCalibrationIncomplete", &MReadOutAssembly::SetDepthCalibrationIncomplete },
+  { "DepthCalibration_OutofRange", &MReadOutAssembly::SetDepthCalibration_OutofRange } };
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! Skip blanks and - in evta hits - semicolons
+static inline const char* SkipSeparators(const char* Pos, const char* End)
+{
+  while (Pos < End && (*Pos == ' ' || *Pos == '\t' || *Pos == ';')) ++Pos;
+  return Pos;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MDatFileParser::MDatFileParser() : m_HasPendingEvent(false), m_PendingInclude(""), m_NBadLines(0), m_Error(false)
+{
+  // Construct an instance of MDatFileParser
+
+  m_Main.m_Position = 0;
+  m_Main.m_EndOfFile = false;
+  m_Included.m_Position = 0;
+  m_Included.m_EndOfFile = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MDatFileParser::~MDatFileParser()
+{
+  // Delete this instance of MDatFileParser
+
+  Close();
+
+  for (MReadOutAssembly* Event: m_EventPool) delete Event;
+  for (MStripHit* StripHit: m_StripHitPool) delete StripHit;
+  for (MHit* Hit: m_HitPool) delete Hit;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MDatFileParser::Open(const MString& FileName)
+{
+  // Open the file
+
+  Close();
+
+  m_HasPendingEvent = false;
+  m_PendingInclude = "";
+  m_NBadLines = 0;
+  m_Error = false;
+
+  MString Name = FileName;
+  MFile::ExpandFileName(Name);
+
+  // Included files are given relative to the main file
+  string Directory = Name.Data();
+  size_t Slash = Directory.rfind('/');
+  Directory = (Slash != string::npos) ? Directory.substr(0, Slash + 1) : "";
+  m_Directory = MString(Directory);
+
+  if (Open(m_Main, Name) == false) {
+    if (g_Verbosity >= c_Error) cout<<"MDatFileParser: Unable to open file "<<Name<<endl;
+    return false;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MDatFileParser::Open(source& Source, const MString& FileName)
+{
+  // Open a source
+
+  Close(Source);
+
+  return Source.m_Reader.Open(FileName);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MDatFileParser::Close()
+{
+  // Close the file
+
+  Close(m_Included);
+  Close(m_Main);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MDatFileParser::Close(source& Source)
+{
+  // Close a source - the storage of its buffers is kept
+
+  Source.m_Reader.Close();
+  Source.m_Buffer.clear();
+  Source.m_Position = 0;
+  Source.m_EndOfFile = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MDatFileParser::ReadLine(source& Source, const char*& Begin, const char*& End)
+{
+  // Return the next line of a source - it stays valid until the next line of this source is read
+
+  vector<uint8_t>& Buffer = Source.m_Buffer;
+
+  while (true) {
+    if (Source.m_Position < Buffer.size()) {
+      const char* Data = (const char*) Buffer.data();
+      const char* Line = Data + Source.m_Position;
+      const char* NewLine = (const char*) memchr(Line, '\n', Buffer.size() - Source.m_Position);
+      // The last line of a file does not need to end with a new line
+      if (NewLine != nullptr || Source.m_EndOfFile == true) {
+        Begin = Line;
+        End = (NewLine != nullptr) ? NewLine : Data + Buffer.size();
+        Source.m_Position = End - Data + 1;
+        if (End > Begin && *(End - 1) == '\r') --End;
+        return true;
+      }
+    }
+
+    if (Source.m_EndOfFile == true) return false;
+
+    // Keep the incomplete last line, and append the next block
+    if (Source.m_Position >= Buffer.size()) {
+      Buffer.clear();
+    } else {
+      Buffer.erase(Buffer.begin(), Buffer.begin() + Source.m_Position);
+    }
+    Source.m_Position = 0;
+
+    if (Source.m_Reader.Read(Source.m_Block) == false) {
+      Source.m_EndOfFile = true;
+      if (Source.m_Reader.HasError() == true) {
+        if (g_Verbosity >= c_Error) cout<<"MDatFileParser: Unable to read the file"<<endl;
+        m_Error = true;
+      }
+    } else if (Buffer.size() == 0) {
+      // No copy if the last block ended with a complete line
+      Buffer.swap(Source.m_Block);
+    } else {
+      Buffer.insert(Buffer.end(), Source.m_Block.begin(), Source.m_Block.end());
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MDatFileParser::NextLine(const char*& Begin, const char*& End)
+{
+  // Return the next line of the included file, or of the main file
+
+  if (m_Included.m_Reader.IsOpen() == true) {
+    if (ReadLine(m_Included, Begin, End) == true) return true;
+
+    Close(m_Included);
+    // A truncated sub file has no "EN" line, thus make sure its last event is completed
+    static const char* EndLine = "EN";
+    Begin = EndLine;
+    End = EndLine + 2;
+    return true;
+  }
+
+  return ReadLine(m_Main, Begin, End);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MDatFileParser::Include(MString FileName)
+{
+  // Open the file included by an "IN" line
+
+  if (m_Included.m_Reader.IsOpen() == true) {
+    if (g_Verbosity >= c_Error) cout<<"MDatFileParser: Included files cannot include other files: "<<FileName<<endl;
+    return;
+  }
+
+  if (FileName.Length() == 0) return;
+  if (FileName.Data()[0] != '/') {
+    FileName = m_Directory + FileName;
+  }
+
+  if (Open(m_Included, FileName) == false) {
+    if (g_Verbosity >= c_Error) cout<<"MDatFileParser: Unable to open the included file "<<FileName<<endl;
+    m_Error = true;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MDatFileParser::ReadNext(MReadOutAssembly* Event)
+{
+  // Read the next event into Event
+
+  Recycle(Event);
+
+  if (m_PendingInclude.Length() > 0) {
+    Include(m_PendingInclude);
+    m_PendingInclude = "";
+  }
+
+  // The "SE" line of this event might have completed the last one
+  bool HasEvent = m_HasPendingEvent;
+  m_HasPendingEvent = false;
+  bool HasClock = false;
+
+  const char* Begin = nullptr;
+  const char* End = nullptr;
+  while (NextLine(Begin, End) == true) {
+    // All lines we are interested in start with a two letter keyword followed by a blank
+    size_t Length = End - Begin;
+    if (Length < 2 || (Length > 2 && Begin[2] != ' ')) continue;
+
+    const char* Pos = Begin + 2;
+    char K0 = Begin[0];
+    char K1 = Begin[1];
+
+    if (K0 == 'S' && K1 == 'E') {
+      if (HasEvent == true) {
+        m_HasPendingEvent = true;
+        return true;
+      }
+      HasEvent = true;
+      continue;
+    } else if (K0 == 'E' && K1 == 'N') {
+      if (HasEvent == true) return true;
+      continue;
+    } else if (K0 == 'I' && K1 == 'N') {
+      Pos = SkipSeparators(Pos, End);
+      MString FileName(string(Pos, End - Pos));
+      if (HasEvent == true) {
+        m_PendingInclude = FileName;
+        return true;
+      }
+      Include(FileName);
+      continue;
+    }
+
+    // Skip the header
+    if (HasEvent == false) continue;
+
+    bool IsGood = true;
+    if (K0 == 'S' && K1 == 'H') {
+      IsGood = ParseStripHit(Pos, End, Event);
+    } else if (K0 == 'H' && K1 == 'T') {
+      IsGood = ParseHit(Pos, End, Event);
+    } else if (K0 == 'I' && K1 == 'D') {
+      unsigned long ID = 0;
+      IsGood = ParseNumber(Pos, End, ID);
+      if (IsGood == true) Event->SetID(ID);
+    } else if (K0 == 'C' && K1 == 'L') {
+      MTime Time;
+      IsGood = ParseTime(Pos, End, Time);
+      if (IsGood == true) {
+        Event->SetTime(Time);
+        HasClock = true;
+      }
+    } else if (K0 == 'T' && K1 == 'I') {
+      MTime Time;
+      IsGood = ParseTime(Pos, End, Time);
+      if (IsGood == true) {
+        Event->SetTimeUTC(Time);
+        // Older files only have the "TI" line
+        if (HasClock == false) Event->SetTime(Time);
+      }
+    } else if (K0 == 'B' && K1 == 'D') {
+      IsGood = ParseBD(Pos, End, Event);
+    }
+    // All other lines (aspect, simulation, "CC") are ignored as in GetNextFromDatFile()
+
+    if (IsGood == false) ++m_NBadLines;
+  }
+
+  return HasEvent;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MReadOutAssembly* MDatFileParser::Next()
+{
+  // Return the next event from the pool
+
+  MReadOutAssembly* Event = nullptr;
+  if (m_EventPool.size() > 0) {
+    Event = m_EventPool.back();
+    m_EventPool.pop_back();
+  } else {
+    Event = new MReadOutAssembly();
+  }
+
+  if (ReadNext(Event) == false) {
+    Release(Event);
+    return nullptr;
+  }
+
+  return Event;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MDatFileParser::Release(MReadOutAssembly* Event)
+{
+  // Hand an event back to the pool
+
+  if (Event == nullptr) return;
+
+  Recycle(Event);
+  if (m_EventPool.size() < c_MaxPoolSize) {
+    m_EventPool.push_back(Event);
+  } else {
+    delete Event;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MDatFileParser::ParseStripHit(const char* Pos, const char* End, MReadOutAssembly* Event)
+{
+  // Parse "SH <det> <l|h> <strip> <triggered> <timing> <uncorrected ADC> <ADC> <energy> <resolution>"
+
+  int DetectorID = 0;
+  if (ParseNumber(Pos, End, DetectorID) == false) return false;
+
+  Pos = SkipSeparators(Pos, End);
+  if (Pos == End) return false;
+  // "l" (low voltage) is written by StreamDat(), "p" (positive) by older versions
+  bool IsLowVoltage = (*Pos == 'l' || *Pos == 'p');
+  ++Pos;
+
+  int StripID = 0;
+  int HasTriggered = 0;
+  double Timing = 0;
+  double UncorrectedADCUnits = 0;
+  double ADCUnits = 0;
+  double Energy = 0;
+  double EnergyResolution = 0;
+  if (ParseNumber(Pos, End, StripID) == false || ParseNumber(Pos, End, HasTriggered) == false ||
+      ParseNumber(Pos, End, Timing) == false || ParseNumber(Pos, End, UncorrectedADCUnits) == false ||
+      ParseNumber(Pos, End, ADCUnits) == false || ParseNumber(Pos, End, Energy) == false ||
+      ParseNumber(Pos, End, EnergyResolution) == false) {
+    return false;
+  }
+
+  MStripHit* StripHit = NewStripHit();
+  StripHit->SetDetectorID(DetectorID);
+  StripHit->IsLowVoltageStrip(IsLowVoltage);
+  StripHit->SetStripID(StripID);
+  StripHit->HasTriggered(HasTriggered != 0);
+  StripHit->SetTiming(Timing);
+  StripHit->SetUncorrectedADCUnits(UncorrectedADCUnits);
+  StripHit->SetADCUnits(ADCUnits);
+  StripHit->SetEnergy(Energy);
+  StripHit->SetEnergyResolution(EnergyResolution);
+
+  Event->AddStripHit(StripHit);
+  // In version 2 of the dat format the strip hits follow the hit they belong to
+  if (Event->GetNHits() > 0) {
+    Event->GetHit(Event->GetNHits() - 1)->AddStripHit(StripHit);
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MDatFileParser::ParseHit(const char* Pos, const char* End, MReadOutAssembly* Event)
+{
+  // Parse "HT <x> <y> <z> <energy>" (dat) or "HT 3;<x>;<y>;<z>;<energy>;<dx>;<dy>;<dz>;<denergy>[;<origin>...]" (evta)
+
+  double X = 0, Y = 0, Z = 0, Energy = 0;
+  if (memchr(Pos, ';', End - Pos) == nullptr) {
+    if (ParseNumber(Pos, End, X) == false || ParseNumber(Pos, End, Y) == false ||
+        ParseNumber(Pos, End, Z) == false || ParseNumber(Pos, End, Energy) == false) {
+      return false;
+    }
+
+    MHit* Hit = NewHit();
+    Hit->SetPosition(MVector(X, Y, Z));
+    Hit->SetEnergy(Energy);
+    Event->AddHit(Hit);
+
+    return true;
+  }
+
+  int DetectorType = 0;
+  double dX = 0, dY = 0, dZ = 0, dEnergy = 0;
+  if (ParseNumber(Pos, End, DetectorType) == false ||
+      ParseNumber(Pos, End, X) == false || ParseNumber(Pos, End, Y) == false ||
+      ParseNumber(Pos, End, Z) == false || ParseNumber(Pos, End, Energy) == false ||
+      ParseNumber(Pos, End, dX) == false || ParseNumber(Pos, End, dY) == false ||
+      ParseNumber(Pos, End, dZ) == false || ParseNumber(Pos, End, dEnergy) == false) {
+    return false;
+  }
+
+  MHit* Hit = NewHit();
+  Hit->SetPosition(MVector(X, Y, Z));
+  Hit->SetEnergy(Energy);
+  Hit->SetPositionResolution(MVector(dX, dY, dZ));
+  Hit->SetEnergyResolution(dEnergy);
+
+  int Origin = 0;
+  vector<int> Origins;
+  while (ParseNumber(Pos, End, Origin) == true) {
+    Origins.push_back(Origin);
+  }
+  if (Origins.size() > 0) Hit->AddOrigins(Origins);
+
+  Event->AddHit(Hit);
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MDatFileParser::ParseBD(const char* Pos, const char* End, MReadOutAssembly* Event)
+{
+  // Parse "BD <name> [(<text>)]"
+
+  // As in GetNextFromDatFile(), any BD line marks the event as filtered out
+  Event->SetFilteredOut(true);
+
+  Pos = SkipSeparators(Pos, End);
+  const char* NameEnd = Pos;
+  while (NameEnd < End && *NameEnd != ' ') ++NameEnd;
+  size_t Length = NameEnd - Pos;
+
+  MString Text("");
+  const char* TextBegin = SkipSeparators(NameEnd, End);
+  if (End - TextBegin >= 2 && *TextBegin == '(' && *(End - 1) == ')') {
+    Text = MString(string(TextBegin + 1, End - TextBegin - 2));
+  }
+
+  for (const MDatFileParserBDFlag& Flag: g_BDFlags) {
+    if (strlen(Flag.m_Name) == Length && memcmp(Flag.m_Name, Pos, Length) == 0) {
+      (Event->*Flag.m_Set)(true, Text);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+template <class T> bool MDatFileParser::ParseNumber(const char*& Pos, const char* End, T& Value)
+{
+  // Parse a number after optional blanks and advance Pos
+
+  Pos = SkipSeparators(Pos, End);
+  from_chars_result Result = from_chars(Pos, End, Value);
+  if (Result.ec != errc()) return false;
+  Pos = Result.ptr;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MDatFileParser::ParseTime(const char*& Pos, const char* End, MTime& Time)
+{
+  // Parse a time "seconds.nanoseconds" as written by MTime - without the detour via a double
+
+  Pos = SkipSeparators(Pos, End);
+  bool IsNegative = (Pos < End && *Pos == '-');
+
+  long int Seconds = 0;
+  if (ParseNumber(Pos, End, Seconds) == false) return false;
+
+  long int NanoSeconds = 0;
+  if (Pos < End && *Pos == '.') {
+    ++Pos;
+    int NDigits = 0;
+    while (Pos < End && *Pos >= '0' && *Pos <= '9') {
+      // Digits beyond nanoseconds are ignored
+      if (NDigits < 9) {
+        NanoSeconds = 10*NanoSeconds + (*Pos - '0');
+        ++NDigits;
+      }
+      ++Pos;
+    }
+    for (; NDigits < 9; ++NDigits) NanoSeconds *= 10;
+  }
+  if (IsNegative == true) NanoSeconds = -NanoSeconds;
+
+  Time.Set(Seconds, NanoSeconds);
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MStripHit* MDatFileParser::NewStripHit()
+{
+  // Return an empty strip hit from the pool
+
+  if (m_StripHitPool.size() > 0) {
+    MStripHit* StripHit = m_StripHitPool.back();
+    m_StripHitPool.pop_back();
+    return StripHit;
+  }
+
+  return new MStripHit();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MHit* MDatFileParser::NewHit()
+{
+  // Return an empty hit from the pool
+
+  if (m_HitPool.size() > 0) {
+    MHit* Hit = m_HitPool.back();
+    m_HitPool.pop_back();
+    return Hit;
+  }
+
+  return new MHit();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MDatFileParser::ReleaseStripHit(MStripHit* StripHit)
+{
+  // Clear a strip hit and move it to the pool
+
+  if (m_StripHitPool.size() < c_MaxPoolSize) {
+    StripHit->Clear();
+    m_StripHitPool.push_back(StripHit);
+  } else {
+    delete StripHit;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MDatFileParser::ReleaseHit(MHit* Hit)
+{
+  // Clear a hit and move it to the pool
+
+  if (m_HitPool.size() < c_MaxPoolSize) {
+    Hit->Clear();
+    m_HitPool.push_back(Hit);
+  } else {
+    delete Hit;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MDatFileParser::Recycle(MReadOutAssembly* Event)
+{
+  // Move the strip hits and hits of the event to the pools and clear the event
+  // The event owns them, thus they are detached from the back before the event is cleared
+
+  for (unsigned int i = Event->GetNStripHits(); i > 0; --i) {
+    MStripHit* StripHit = Event->GetStripHit(i - 1);
+    Event->RemoveStripHit(i - 1);
+    ReleaseStripHit(StripHit);
+  }
+  for (unsigned int i = Event->GetNStripHitsTOnly(); i > 0; --i) {
+    MStripHit* StripHit = Event->GetStripHitTOnly(i - 1);
+    Event->RemoveStripHitTOnly(i - 1);
+    ReleaseStripHit(StripHit);
+  }
+  for (unsigned int i = Event->GetNHits(); i > 0; --i) {
+    MHit* Hit = Event->GetHit(i - 1);
+    Event->RemoveHit(i - 1);
+    ReleaseHit(Hit);
+  }
+
+  // Everything else (aspect, simulated hits, guard ring hits, flags) is reset as usual
+  Event->Clear();
+}
+
+
+// MDatFileParser.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -98,10 +98,6 @@ MDetectorEffectsEngineBalloon::~MDetectorEffectsEngineBalloon()
   
   if (m_OwnGeometry == true) delete m_Geometry;
   
-  for (auto& C: m_EnergyCalibration) {
-    delete C.second;
-  }
-  
   for (auto& C: m_ResolutionCalibration) {
     delete C.second;
   }
@@ -1566,12 +1562,12 @@ bool MDetectorEffectsEngineBalloon::GetNextEvent(MReadOutAssembly* Event)
       
       // (2) Dump event to file in ROA format
       if (m_SaveToFile == true) {
-        m_Roa<<"SE"<<endl;
-        m_Roa<<"ID "<<SimEvent->GetID()<<endl;
+        m_Roa<<"SE"<<'\n';
+        m_Roa<<"ID "<<SimEvent->GetID()<<'\n';
         //m_Roa<<"ID "<<++RunningID<<endl;
-        m_Roa<<"TI "<<SimEvent->GetTime() << endl;
+        m_Roa<<"TI "<<SimEvent->GetTime()<<'\n';
         for (unsigned int i = 0; i < IAs.size(); ++i) {
-          m_Roa<<IAs[i]->ToSimString()<<endl;
+          m_Roa<<IAs[i]->ToSimString()<<'\n';
         }
         for (MDEEStripHit Hit: MergedStripHits){
           m_Roa<<"UH "<<Hit.m_ROE.GetDetectorID()<<" "<<Hit.m_ROE.GetStripID()<<" "<<(Hit.m_ROE.IsPositiveStrip() ? "p" : "n")<<" "<<Hit.m_ADC<<" "<<Hit.m_Timing<<" "<<Hit.m_PreampTemp;
@@ -1582,7 +1578,7 @@ bool MDetectorEffectsEngineBalloon::GetNextEvent(MReadOutAssembly* Event)
             Origins += Origin;
           }
           if (Origins == "") Origins += "-";
-          m_Roa<<" "<<Origins<<endl;
+          m_Roa<<" "<<Origins<<'\n';
         }
       }
       
@@ -1674,21 +1670,21 @@ int MDetectorEffectsEngineBalloon::EnergyToADC(MDEEStripHit& Hit, double mean_en
   //then, convert energy to ADC
   double ADC_double = 0;
   
-  //get the fit function
-  TF1* Fit = m_EnergyCalibration[Hit.m_ROE];
+  //get the calibration polynomial
+  int Slot = m_EnergyPolynomials.GetSlot(Hit.m_ROE);
   
-  if (Fit != 0) {
-    // find roots - while considering the limits of the fit function
+  if (m_EnergyPolynomials.HasPolynomial(Slot) == true) {
+    // find roots - while considering the limits of the calibration polynomial
     double MaxEnergy = 10000.0;
-    if (energy >= MaxEnergy || energy > Fit->GetMaximum(0, 8191)) {
-      //cout<<"Info: Setting AD units to max (8191): E="<<energy<<" vs. E_max="<<Fit->GetMaximum(0, 8191)<<endl;
+    if (energy >= MaxEnergy || energy > m_EnergyPolynomials.GetMaximum(Slot)) {
+      //cout<<"Info: Setting AD units to max (8191): E="<<energy<<" vs. E_max="<<m_EnergyPolynomials.GetMaximum(Slot)<<endl;
       ADC_double = 8191; 
-    } else if (energy <= 0 || energy < Fit->GetMinimum(0, 8191)) {
-      //cout<<"Info: Setting AD units to min (0): E="<<energy<<" vs. E_min"<<Fit->GetMinimum(0, 8191)<<endl;
+    } else if (energy <= 0 || energy < m_EnergyPolynomials.GetMinimum(Slot)) {
+      //cout<<"Info: Setting AD units to min (0): E="<<energy<<" vs. E_min"<<m_EnergyPolynomials.GetMinimum(Slot)<<endl;
       ADC_double = 0.0;
     } else {
-      ADC_double = Fit->GetX(energy, 0., MaxEnergy);
-      //cout<<"energy:"<<energy<<"(ad: "<<ADC_double<<") vs. E_min="<<Fit->GetMinimum()<<"   E_max="<<Fit->GetMaximum()<<endl;
+      ADC_double = m_EnergyPolynomials.Invert(Slot, energy);
+      //cout<<"energy:"<<energy<<"(ad: "<<ADC_double<<") vs. E_min="<<m_EnergyPolynomials.GetMinimum(Slot)<<"   E_max="<<m_EnergyPolynomials.GetMaximum(Slot)<<endl;
     }
   }
   
@@ -2066,6 +2062,15 @@ bool MDetectorEffectsEngineBalloon::ParseEnergyCalibrationFile()
       }
   }
   
+  // Size the calibration polynomials to the read-out elements in the file
+  unsigned int NDetectors = 0;
+  unsigned int NStrips = 0;
+  for (auto& E: CM_ROEToLine) {
+    NDetectors = max(NDetectors, (unsigned int) E.first.GetDetectorID() + 1);
+    NStrips = max(NStrips, (unsigned int) E.first.GetStripID() + 1);
+  }
+  m_EnergyPolynomials.Reset(NDetectors, NStrips);
+  
   for (auto CM: CM_ROEToLine){
     
     //only use calibration if we have 3 data points
@@ -2091,15 +2096,8 @@ bool MDetectorEffectsEngineBalloon::ParseEnergyCalibrationFile()
       double a2 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
       double a3 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
       
-      //from fit parameters, define function
-      TF1* melinatorfit = new TF1("poly3","[0]+[1]*x+[2]*x^2+[3]*x^3",0.,8162.);
-      melinatorfit->FixParameter(0,a0);
-      melinatorfit->FixParameter(1,a1);
-      melinatorfit->FixParameter(2,a2);
-      melinatorfit->FixParameter(3,a3);
-      
-      //Define the map by saving the fit function I just created as a map to the current ReadOutElement
-      m_EnergyCalibration[CM.first] = melinatorfit;
+      double Coefficients[] = { a0, a1, a2, a3 };
+      m_EnergyPolynomials.Set(CM.first, Coefficients, 3);
       
     } else if (CalibratorType == "poly4"){
       double a0 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
@@ -2108,19 +2106,14 @@ bool MDetectorEffectsEngineBalloon::ParseEnergyCalibrationFile()
       double a3 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
       double a4 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
       
-      //from fit parameters, define function
-      TF1* melinatorfit = new TF1("poly4","[0]+[1]*x+[2]*x^2+[3]*x^3+[4]*x^4",0.,8162.);
-      melinatorfit->FixParameter(0,a0);
-      melinatorfit->FixParameter(1,a1);
-      melinatorfit->FixParameter(2,a2);
-      melinatorfit->FixParameter(3,a3);	
-      melinatorfit->FixParameter(4,a4);
-      
-      //Define the map by saving the fit function I just created as a map to the current ReadOutElement
-      m_EnergyCalibration[CM.first] = melinatorfit;
+      double Coefficients[] = { a0, a1, a2, a3, a4 };
+      m_EnergyPolynomials.Set(CM.first, Coefficients, 4);
     }
   }
   
+  // The inverses are needed by EnergyToADC
+  m_EnergyPolynomials.BuildInverse(0., 8191.);
+  
   for (auto CR: CR_ROEToLine){
     
     unsigned int Pos = 5;
@@ -89,6 +89,16 @@ void MGUIOptionsDepthCalibration2024::Create()
   TGLayoutHints* Label4Layout = new TGLayoutHints(kLHintsTop | kLHintsCenterX | kLHintsExpandX, 10, 10, 10, 10);
   m_OptionsFrame->AddFrame(m_UCSDOverride, Label4Layout);
 
+  m_UseDepthTables = new TGCheckButton(m_OptionsFrame, "Use precomputed CTD->depth tables (faster)", 2);
+  m_UseDepthTables->SetOn(dynamic_cast<MModuleDepthCalibration2024*>(m_Module)->GetUseDepthTables());
+  TGLayoutHints* Label5Layout = new TGLayoutHints(kLHintsTop | kLHintsCenterX | kLHintsExpandX, 10, 10, 10, 10);
+  m_OptionsFrame->AddFrame(m_UseDepthTables, Label5Layout);
+
+  m_CrossCheckDepthTables = new TGCheckButton(m_OptionsFrame, "Cross-check the CTD->depth tables against the exact calculation", 3);
+  m_CrossCheckDepthTables->SetOn(dynamic_cast<MModuleDepthCalibration2024*>(m_Module)->GetCrossCheckDepthTables());
+  TGLayoutHints* Label6Layout = new TGLayoutHints(kLHintsTop | kLHintsCenterX | kLHintsExpandX, 10, 10, 10, 10);
+  m_OptionsFrame->AddFrame(m_CrossCheckDepthTables, Label6Layout);
+
   PostCreate();
 }
 
@@ -135,6 +145,8 @@ bool MGUIOptionsDepthCalibration2024::OnApply()
   dynamic_cast<MModuleDepthCalibration2024*>(m_Module)->SetSplinesFileName(m_SplinesFileSelector->GetFileName());
   dynamic_cast<MModuleDepthCalibration2024*>(m_Module)->SetTACCalFileName(m_TACCalFileSelector->GetFileName());
   dynamic_cast<MModuleDepthCalibration2024*>(m_Module)->SetUCSDOverride(m_UCSDOverride->IsOn());
+  dynamic_cast<MModuleDepthCalibration2024*>(m_Module)->SetUseDepthTables(m_UseDepthTables->IsOn());
+  dynamic_cast<MModuleDepthCalibration2024*>(m_Module)->SetCrossCheckDepthTables(m_CrossCheckDepthTables->IsOn());
 
   return true;
 }
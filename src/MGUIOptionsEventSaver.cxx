@@ -72,7 +72,9 @@ void MGUIOptionsEventSaver::Create()
   m_Mode->Add("*.roa file to use with melinator");
   m_Mode->Add("*.dat file containing all information");
   m_Mode->Add("*.evta file to use with revan");
-  m_Mode->SetSelected(dynamic_cast<MModuleEventSaver*>(m_Module)->GetMode());
+  m_Mode->Add("*.bev binary event file to continue the analysis with the binary event loader");
+  unsigned int Mode = dynamic_cast<MModuleEventSaver*>(m_Module)->GetMode();
+  m_Mode->SetSelected(Mode == MModuleEventSaver::c_BinaryFile ? 3 : Mode);
   m_Mode->Create();
   m_OptionsFrame->AddFrame(m_Mode, LabelLayout);
 
@@ -82,6 +84,7 @@ void MGUIOptionsEventSaver::Create()
   m_FileSelector->SetFileType("roa file (read-out assemlies)", "*.roa");
   m_FileSelector->SetFileType("dat file (all info)", "*.dat");
   m_FileSelector->SetFileType("evta file (evta file)", "*.evta");
+  m_FileSelector->SetFileType("bev file (binary events)", "*.bev");
   m_OptionsFrame->AddFrame(m_FileSelector, LabelLayout);
 
   m_SaveBadEvents = new TGCheckButton(m_OptionsFrame, "Save events which are flagged bad (BD)", 1);
@@ -104,6 +107,16 @@ void MGUIOptionsEventSaver::Create()
   if (m_SplitFile->IsOn() == false) m_SplitFileTime->SetEnabled(false);
   m_OptionsFrame->AddFrame(m_SplitFileTime, SplitFileTimeLayout);
   
+  m_AsynchronousWriting = new TGCheckButton(m_OptionsFrame, "Write the file in the background (gzip'ed files are compressed in parallel)", 4);
+  m_AsynchronousWriting->Associate(this);
+  m_AsynchronousWriting->SetOn(dynamic_cast<MModuleEventSaver*>(m_Module)->GetAsynchronousWriting());
+  m_OptionsFrame->AddFrame(m_AsynchronousWriting, LabelLayout);
+  
+  m_NumberOfCompressionThreads = new MGUIEEntry(m_OptionsFrame, "Number of compression threads:", false, 
+    (long) dynamic_cast<MModuleEventSaver*>(m_Module)->GetNumberOfCompressionThreads(), true, 1l);
+  if (m_AsynchronousWriting->IsOn() == false) m_NumberOfCompressionThreads->SetEnabled(false);
+  m_OptionsFrame->AddFrame(m_NumberOfCompressionThreads, SplitFileTimeLayout);
+  
   
   PostCreate();
 }
@@ -127,6 +140,9 @@ bool MGUIOptionsEventSaver::ProcessMessage(long Message, long Parameter1, long P
       if (Parameter1 == 2) {
         m_SplitFileTime->SetEnabled(m_SplitFile->IsOn());
       }
+      if (Parameter1 == 4) {
+        m_NumberOfCompressionThreads->SetEnabled(m_AsynchronousWriting->IsOn());
+      }
       break;
     default:
       break;
@@ -152,12 +168,17 @@ bool MGUIOptionsEventSaver::OnApply()
 {
   // Modify this to store the data in the module!
 
-  dynamic_cast<MModuleEventSaver*>(m_Module)->SetMode(m_Mode->GetSelected());
+  // The radio buttons skip the sim and tra modes
+  unsigned int Mode = m_Mode->GetSelected();
+  if (Mode == 3) Mode = MModuleEventSaver::c_BinaryFile;
+  dynamic_cast<MModuleEventSaver*>(m_Module)->SetMode(Mode);
   dynamic_cast<MModuleEventSaver*>(m_Module)->SetFileName(m_FileSelector->GetFileName());
   dynamic_cast<MModuleEventSaver*>(m_Module)->SetSaveBadEvents(m_SaveBadEvents->IsOn());
   dynamic_cast<MModuleEventSaver*>(m_Module)->SetAddTimeTag(m_AddTimeTag->IsOn());
   dynamic_cast<MModuleEventSaver*>(m_Module)->SetSplitFile(m_SplitFile->IsOn());
   dynamic_cast<MModuleEventSaver*>(m_Module)->SetSplitFileTime(MTime(m_SplitFileTime->GetAsInt()));
+  dynamic_cast<MModuleEventSaver*>(m_Module)->SetAsynchronousWriting(m_AsynchronousWriting->IsOn());
+  dynamic_cast<MModuleEventSaver*>(m_Module)->SetNumberOfCompressionThreads(m_NumberOfCompressionThreads->GetAsInt());
   
   return true;
 }
@@ -0,0 +1,135 @@
+/*
+ * MGUIOptionsLoaderBinaryEvents.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+// Include the header:
+#include "MGUIOptionsLoaderBinaryEvents.h"
+
+// Standard libs:
+
+// ROOT libs:
+#include <TSystem.h>
+#include <MString.h>
+#include <TGLabel.h>
+#include <TGResourcePool.h>
+
+// MEGAlib libs:
+#include "MStreams.h"
+#include "MModuleLoaderBinaryEvents.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MGUIOptionsLoaderBinaryEvents)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MGUIOptionsLoaderBinaryEvents::MGUIOptionsLoaderBinaryEvents(MModule* Module) 
+  : MGUIOptions(Module)
+{
+  // standard constructor
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MGUIOptionsLoaderBinaryEvents::~MGUIOptionsLoaderBinaryEvents()
+{
+  // kDeepCleanup is activated 
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MGUIOptionsLoaderBinaryEvents::Create()
+{
+  PreCreate();
+
+  m_FileSelector = new MGUIEFileSelector(m_OptionsFrame, "Please select a binary event file:",
+    dynamic_cast<MModuleLoaderBinaryEvents*>(m_Module)->GetFileName());
+  m_FileSelector->SetFileType("Binary event file", "*.bev");
+  m_FileSelector->SetFileType("Binary event file", "*.bev.gz");
+  TGLayoutHints* LabelLayout = new TGLayoutHints(kLHintsTop | kLHintsCenterX | kLHintsExpandX, 10, 10, 10, 10);
+  m_OptionsFrame->AddFrame(m_FileSelector, LabelLayout);
+
+  // The radio buttons are in the order of the checkpoint stages
+  m_CheckpointStage = new MGUIERBList(m_OptionsFrame, "The events have been saved:");
+  m_CheckpointStage->Add("after the detector effects engine (continue with the energy calibration)");
+  m_CheckpointStage->Add("after the strip pairing");
+  m_CheckpointStage->SetSelected(dynamic_cast<MModuleLoaderBinaryEvents*>(m_Module)->GetCheckpointStage());
+  m_CheckpointStage->Create();
+  m_OptionsFrame->AddFrame(m_CheckpointStage, LabelLayout);
+
+  
+  PostCreate();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MGUIOptionsLoaderBinaryEvents::ProcessMessage(long Message, long Parameter1, long Parameter2)
+{
+  // Modify here if you have more buttons
+
+	bool Status = true;
+	
+  switch (GET_MSG(Message)) {
+  case kC_COMMAND:
+    switch (GET_SUBMSG(Message)) {
+    case kCM_BUTTON:
+      break;
+    default:
+      break;
+    }
+    break;
+  default:
+    break;
+  }
+  
+  if (Status == false) {
+    return false;
+  }
+
+  // Call also base class
+  return MGUIOptions::ProcessMessage(Message, Parameter1, Parameter2);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MGUIOptionsLoaderBinaryEvents::OnApply()
+{
+	// Modify this to store the data in the module!
+
+  dynamic_cast<MModuleLoaderBinaryEvents*>(m_Module)->SetFileName(m_FileSelector->GetFileName());
+  dynamic_cast<MModuleLoaderBinaryEvents*>(m_Module)->SetCheckpointStage(m_CheckpointStage->GetSelected());
+	
+	return true;
+}
+
+
+// MGUIOptionsLoaderBinaryEvents: the end...
+////////////////////////////////////////////////////////////////////////////////
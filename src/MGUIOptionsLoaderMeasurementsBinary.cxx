@@ -97,6 +97,21 @@ void MGUIOptionsLoaderMeasurementsBinary::Create()
   m_CoincidenceMode->Create();
   m_OptionsFrame->AddFrame(m_CoincidenceMode, LabelLayout);
 
+  m_ReadMode = new MGUIERBList(m_OptionsFrame, "Read uncompressed files");
+  m_ReadMode->Add("block by block");
+  m_ReadMode->Add("memory mapped");
+  m_ReadMode->SetSelected(dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->GetUseMemoryMapping() == true ? 1 : 0);
+  m_ReadMode->Create();
+  m_OptionsFrame->AddFrame(m_ReadMode, LabelLayout);
+
+  m_NumberOfParallelFiles = new MGUIEEntry(m_OptionsFrame, "Number of files of a file list decoded in parallel (1: one after the other): ", false,
+                                           (long) dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->GetNumberOfParallelFiles(), true, 1l);
+  m_OptionsFrame->AddFrame(m_NumberOfParallelFiles, LabelLayout);
+
+  m_NumberOfDecodingThreads = new MGUIEEntry(m_OptionsFrame, "Number of threads which decode the dataframes of a file in parallel (0: none): ", false,
+                                             (long) dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->GetNumberOfDecodingThreads(), true, 0l);
+  m_OptionsFrame->AddFrame(m_NumberOfDecodingThreads, LabelLayout);
+
 
 
   PostCreate();
@@ -169,6 +184,10 @@ bool MGUIOptionsLoaderMeasurementsBinary::OnApply()
 	  dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->EnableCoincidenceMerging(true);
   }
 
+  dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->SetUseMemoryMapping(m_ReadMode->GetSelected() == 1);
+  dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->SetNumberOfParallelFiles(m_NumberOfParallelFiles->GetAsInt() > 0 ? m_NumberOfParallelFiles->GetAsInt() : 1);
+  dynamic_cast<MModuleLoaderMeasurementsBinary*>(m_Module)->SetNumberOfDecodingThreads(m_NumberOfDecodingThreads->GetAsInt() > 0 ? m_NumberOfDecodingThreads->GetAsInt() : 0);
+
 
 	return true;
 }
@@ -69,12 +69,17 @@ void MGUIOptionsStripPairing::Create()
   TGLayoutHints* LabelLayout = new TGLayoutHints(kLHintsTop | kLHintsCenterX | kLHintsExpandX, 10, 10, 10, 10);  
   
   m_Mode = new MGUIERBList(m_OptionsFrame, "Please select a strip pairing mode:");
-  m_Mode->Add("Andreas's algorithm");
-  m_Mode->Add("Daniel's 'greedy' algorithm");
-  m_Mode->SetSelected(dynamic_cast<MModuleStripPairingGreedy*>(m_Module)->GetMode());
+  m_Mode->Add("Greedy search (Daniel's algorithm)");
+  m_Mode->Add("Optimal assignment");
+  // Both old greedy modes are shown as the greedy search
+  m_Mode->SetSelected(dynamic_cast<MModuleStripPairingGreedy*>(m_Module)->GetMode() == MModuleStripPairingGreedy::c_ModeOptimalAssignment ? 1 : 0);
   m_Mode->Create();
   m_OptionsFrame->AddFrame(m_Mode, LabelLayout);
 
+  m_NPairingThreads = new MGUIEEntry(m_OptionsFrame, "Number of threads which pair the detectors of one event in parallel (0: none):", false,
+                                     dynamic_cast<MModuleStripPairingGreedy*>(m_Module)->GetNumberOfPairingThreads(), true, 0l);
+  m_OptionsFrame->AddFrame(m_NPairingThreads, LabelLayout);
+
    PostCreate();
 }
 
@@ -117,7 +122,8 @@ bool MGUIOptionsStripPairing::OnApply()
 {
   // Modify this to store the data in the module!
 
-  dynamic_cast<MModuleStripPairingGreedy*>(m_Module)->SetMode(m_Mode->GetSelected());
+  dynamic_cast<MModuleStripPairingGreedy*>(m_Module)->SetMode(m_Mode->GetSelected() == 1 ? MModuleStripPairingGreedy::c_ModeOptimalAssignment : MModuleStripPairingGreedy::c_ModeGreedy);
+  dynamic_cast<MModuleStripPairingGreedy*>(m_Module)->SetNumberOfPairingThreads(m_NPairingThreads->GetAsInt());
   
   return true;
 }
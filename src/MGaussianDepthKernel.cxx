@@ -0,0 +1,357 @@
+/*
+ * MGaussianDepthKernel.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MGaussianDepthKernel
+//
+// The weights are w_k = exp(-((CTD_k - CTD_s)^2 - d_min^2) / (2 sigma^2)), where d_min
+// is the distance of the closest grid point -- the normalization of the Gaussian
+// and the factor exp(-d_min^2 / (2 sigma^2)) cancel in the mean and the variance.
+// Thus the largest weight is always 1 and the sums cannot underflow. The depths
+// are accumulated relative to the depth of the closest grid point to avoid
+// cancellation in Sum(w*z^2)/Sum(w) - mean^2.
+//
+// The AVX2 and AVX-512 versions use a polynomial exp approximation:
+// exp(x) = 2^n * exp(r) with |r| <= ln(2)/2, where exp(r) is a degree-10 Taylor
+// polynomial. Its relative truncation error is below 3e-13.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MGaussianDepthKernel.h"
+
+// Standard libs:
+#include <cmath>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MGAUSSIANDEPTHKERNEL_X86
+#endif
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MGaussianDepthKernel)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+const double MGaussianDepthKernel::c_MaxExpRelativeError = 1.0E-12;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+namespace {
+
+// Below this argument exp() is set to zero (2^n would leave the normal range)
+const double c_ExpCutOff = -708.0;
+
+
+//! Turn the three sums into mean and sigma
+bool MGaussianDepthKernelFinish(double S0, double S1, double S2, double Reference, double& MeanDepth, double& DepthSigma)
+{
+  if (!(S0 > 0.0) || std::isfinite(S0) == false) {
+    return false;
+  }
+  double Mean = S1/S0;
+  double Variance = S2/S0 - Mean*Mean;
+  if (Variance < 0.0) Variance = 0.0;
+  MeanDepth = Mean + Reference;
+  DepthSigma = sqrt(Variance);
+  return true;
+}
+
+
+//! The scalar version -- uses the standard library exp
+bool MGaussianDepthKernelScalar(const double* CTDs, const double* Depths, unsigned int N, double CTD_s, double Shift, double Factor, double Reference, double& S0, double& S1, double& S2)
+{
+  for (unsigned int k = 0; k < N; ++k) {
+    double d = CTDs[k] - CTD_s;
+    double w = exp(Factor*(d*d - Shift));
+    double z = Depths[k] - Reference;
+    S0 += w;
+    S1 += w*z;
+    S2 += w*z*z;
+  }
+  return true;
+}
+
+
+#ifdef MGAUSSIANDEPTHKERNEL_X86
+
+
+//! The AVX2 version
+__attribute__((target("avx2,fma")))
+bool MGaussianDepthKernelAVX2(const double* CTDs, const double* Depths, unsigned int N, double CTD_s, double Shift, double Factor, double Reference, double& S0, double& S1, double& S2)
+{
+  const __m256d vCTD_s = _mm256_set1_pd(CTD_s);
+  const __m256d vShift = _mm256_set1_pd(Shift);
+  const __m256d vFactor = _mm256_set1_pd(Factor);
+  const __m256d vReference = _mm256_set1_pd(Reference);
+  const __m256d vCutOff = _mm256_set1_pd(c_ExpCutOff);
+  const __m256d vLog2e = _mm256_set1_pd(1.4426950408889634);
+  const __m256d vLn2Hi = _mm256_set1_pd(6.93145751953125E-1);
+  const __m256d vLn2Lo = _mm256_set1_pd(1.42860682030941723212E-6);
+  const __m256i vBias = _mm256_set1_epi64x(1023);
+
+  __m256d vS0 = _mm256_setzero_pd();
+  __m256d vS1 = _mm256_setzero_pd();
+  __m256d vS2 = _mm256_setzero_pd();
+
+  unsigned int k = 0;
+  for (; k + 4 <= N; k += 4) {
+    __m256d d = _mm256_sub_pd(_mm256_loadu_pd(CTDs + k), vCTD_s);
+    __m256d x = _mm256_mul_pd(_mm256_fmsub_pd(d, d, vShift), vFactor);
+    __m256d Valid = _mm256_cmp_pd(x, vCutOff, _CMP_GE_OQ);
+    x = _mm256_max_pd(x, vCutOff);
+
+    // exp(x) = 2^n * exp(r)
+    __m256d n = _mm256_round_pd(_mm256_mul_pd(x, vLog2e), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_fnmadd_pd(n, vLn2Hi, x);
+    r = _mm256_fnmadd_pd(n, vLn2Lo, r);
+    __m256d p = _mm256_set1_pd(1.0/3628800.0);
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0/362880.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0/40320.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0/5040.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0/720.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0/120.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0/24.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0/6.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(0.5));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0));
+    p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(1.0));
+    __m256i e = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+    e = _mm256_slli_epi64(_mm256_add_epi64(e, vBias), 52);
+    __m256d w = _mm256_mul_pd(p, _mm256_castsi256_pd(e));
+    w = _mm256_and_pd(w, Valid);
+
+    __m256d z = _mm256_sub_pd(_mm256_loadu_pd(Depths + k), vReference);
+    __m256d wz = _mm256_mul_pd(w, z);
+    vS0 = _mm256_add_pd(vS0, w);
+    vS1 = _mm256_add_pd(vS1, wz);
+    vS2 = _mm256_fmadd_pd(wz, z, vS2);
+  }
+
+  double Buffer[4];
+  _mm256_storeu_pd(Buffer, vS0); S0 += (Buffer[0] + Buffer[1]) + (Buffer[2] + Buffer[3]);
+  _mm256_storeu_pd(Buffer, vS1); S1 += (Buffer[0] + Buffer[1]) + (Buffer[2] + Buffer[3]);
+  _mm256_storeu_pd(Buffer, vS2); S2 += (Buffer[0] + Buffer[1]) + (Buffer[2] + Buffer[3]);
+
+  return MGaussianDepthKernelScalar(CTDs + k, Depths + k, N - k, CTD_s, Shift, Factor, Reference, S0, S1, S2);
+}
+
+
+//! The AVX-512 version
+__attribute__((target("avx512f")))
+bool MGaussianDepthKernelAVX512(const double* CTDs, const double* Depths, unsigned int N, double CTD_s, double Shift, double Factor, double Reference, double& S0, double& S1, double& S2)
+{
+  const __m512d vCTD_s = _mm512_set1_pd(CTD_s);
+  const __m512d vShift = _mm512_set1_pd(Shift);
+  const __m512d vFactor = _mm512_set1_pd(Factor);
+  const __m512d vReference = _mm512_set1_pd(Reference);
+  const __m512d vCutOff = _mm512_set1_pd(c_ExpCutOff);
+  const __m512d vLog2e = _mm512_set1_pd(1.4426950408889634);
+  const __m512d vLn2Hi = _mm512_set1_pd(6.93145751953125E-1);
+  const __m512d vLn2Lo = _mm512_set1_pd(1.42860682030941723212E-6);
+
+  __m512d vS0 = _mm512_setzero_pd();
+  __m512d vS1 = _mm512_setzero_pd();
+  __m512d vS2 = _mm512_setzero_pd();
+
+  unsigned int k = 0;
+  for (; k < N; k += 8) {
+    // The tail is handled with a masked load, masked-out lanes get zero weight
+    __mmask8 Lanes = (N - k >= 8) ? (__mmask8) 0xFF : (__mmask8) ((1u << (N - k)) - 1);
+    __m512d d = _mm512_sub_pd(_mm512_maskz_loadu_pd(Lanes, CTDs + k), vCTD_s);
+    __m512d x = _mm512_mul_pd(_mm512_fmsub_pd(d, d, vShift), vFactor);
+    __mmask8 Valid = _mm512_mask_cmp_pd_mask(Lanes, x, vCutOff, _CMP_GE_OQ);
+    x = _mm512_max_pd(x, vCutOff);
+
+    // exp(x) = 2^n * exp(r)
+    __m512d n = _mm512_roundscale_pd(_mm512_mul_pd(x, vLog2e), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512d r = _mm512_fnmadd_pd(n, vLn2Hi, x);
+    r = _mm512_fnmadd_pd(n, vLn2Lo, r);
+    __m512d p = _mm512_set1_pd(1.0/3628800.0);
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0/362880.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0/40320.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0/5040.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0/720.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0/120.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0/24.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0/6.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(0.5));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0));
+    p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(1.0));
+    __m512d w = _mm512_maskz_mov_pd(Valid, _mm512_scalef_pd(p, n));
+
+    __m512d z = _mm512_sub_pd(_mm512_maskz_loadu_pd(Lanes, Depths + k), vReference);
+    __m512d wz = _mm512_mul_pd(w, z);
+    vS0 = _mm512_add_pd(vS0, w);
+    vS1 = _mm512_add_pd(vS1, wz);
+    vS2 = _mm512_fmadd_pd(wz, z, vS2);
+  }
+
+  S0 += _mm512_reduce_add_pd(vS0);
+  S1 += _mm512_reduce_add_pd(vS1);
+  S2 += _mm512_reduce_add_pd(vS2);
+
+  return true;
+}
+
+
+#endif
+
+} // namespace
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MGaussianDepthKernel::MGaussianDepthKernel() : m_ISA(GetBestISA())
+{
+  // Construct an instance of MGaussianDepthKernel
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MGaussianDepthKernel::~MGaussianDepthKernel()
+{
+  // Delete this instance of MGaussianDepthKernel
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MGaussianDepthKernel::IsSupported(MGaussianDepthKernelISA ISA)
+{
+  // Return true if the instruction set can be used on this machine
+
+  if (ISA == MGaussianDepthKernelISA::c_Scalar) return true;
+
+#ifdef MGAUSSIANDEPTHKERNEL_X86
+  if (ISA == MGaussianDepthKernelISA::c_AVX2) {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }
+  if (ISA == MGaussianDepthKernelISA::c_AVX512) {
+    return __builtin_cpu_supports("avx512f");
+  }
+#endif
+
+  return false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MGaussianDepthKernelISA MGaussianDepthKernel::GetBestISA()
+{
+  // Return the best supported instruction set
+
+  if (IsSupported(MGaussianDepthKernelISA::c_AVX512) == true) return MGaussianDepthKernelISA::c_AVX512;
+  if (IsSupported(MGaussianDepthKernelISA::c_AVX2) == true) return MGaussianDepthKernelISA::c_AVX2;
+  return MGaussianDepthKernelISA::c_Scalar;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MString MGaussianDepthKernel::GetISAName(MGaussianDepthKernelISA ISA)
+{
+  // Return a human readable name of the instruction set
+
+  if (ISA == MGaussianDepthKernelISA::c_AVX512) return "AVX-512";
+  if (ISA == MGaussianDepthKernelISA::c_AVX2) return "AVX2";
+  return "Scalar";
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MGaussianDepthKernel::SetISA(MGaussianDepthKernelISA ISA)
+{
+  // Switch to a different instruction set
+
+  if (IsSupported(ISA) == false) return false;
+  m_ISA = ISA;
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MGaussianDepthKernel::Calculate(const vector<double>& CTDs, const vector<double>& Depths, double CTD_s, double NoiseFWHM, double& MeanDepth, double& DepthSigma) const
+{
+  // Calculate the Gaussian-weighted mean depth and depth sigma in one pass over the grid
+
+  unsigned int N = min(CTDs.size(), Depths.size());
+  if (N == 0 || !(NoiseFWHM > 0.0)) return false;
+
+  double Sigma = NoiseFWHM/2.355;
+  double Factor = -0.5/(Sigma*Sigma);
+
+  // Find the grid point closest to the measured CTD
+  unsigned int Closest = 0;
+  double Shift = numeric_limits<double>::max();
+  for (unsigned int k = 0; k < N; ++k) {
+    double d = CTDs[k] - CTD_s;
+    if (d*d < Shift) {
+      Shift = d*d;
+      Closest = k;
+    }
+  }
+  double Reference = Depths[Closest];
+
+  double S0 = 0.0;
+  double S1 = 0.0;
+  double S2 = 0.0;
+
+#ifdef MGAUSSIANDEPTHKERNEL_X86
+  if (m_ISA == MGaussianDepthKernelISA::c_AVX512) {
+    MGaussianDepthKernelAVX512(&CTDs[0], &Depths[0], N, CTD_s, Shift, Factor, Reference, S0, S1, S2);
+  } else if (m_ISA == MGaussianDepthKernelISA::c_AVX2) {
+    MGaussianDepthKernelAVX2(&CTDs[0], &Depths[0], N, CTD_s, Shift, Factor, Reference, S0, S1, S2);
+  } else {
+    MGaussianDepthKernelScalar(&CTDs[0], &Depths[0], N, CTD_s, Shift, Factor, Reference, S0, S1, S2);
+  }
+#else
+  MGaussianDepthKernelScalar(&CTDs[0], &Depths[0], N, CTD_s, Shift, Factor, Reference, S0, S1, S2);
+#endif
+
+  return MGaussianDepthKernelFinish(S0, S1, S2, Reference, MeanDepth, DepthSigma);
+}
+
+
+// MGaussianDepthKernel.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -33,6 +33,7 @@
 
 // MEGAlib libs:
 #include "MStreams.h"
+#include "MAsciiBuffer.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -75,8 +76,18 @@ void MHit::Clear()
   m_Energy = g_DoubleNotDefined;
   m_PositionResolution = g_VectorNotDefined;
   m_EnergyResolution = g_DoubleNotDefined;
+  m_HitQuality = 0;
 
   m_StripHits.clear();
+
+  m_PossibleCrossTalk = false;
+  m_PossibleChargeLoss = false;
+  m_StripHitMultipleTimesX = false;
+  m_StripHitMultipleTimesY = false;
+  m_ChargeSharing = false;
+  m_NoDepth = false;
+  m_IsNonDominantNeighborStrip = false;
+
   m_Origins.clear();
 }
 
@@ -155,6 +166,64 @@ void MHit::StreamEvta(ostream& S)
   
   // Assemble the origin information;
   vector<int> Origins;
+  CollectEvtaOrigins(Origins);
+  
+  S<<"HT 3;"<<m_Position.GetX()<<";"<<m_Position.GetY()<<";"<<m_Position.GetZ()<<";"<<m_Energy
+       <<";"<<m_PositionResolution.GetX()<<";"<<m_PositionResolution.GetY()<<";"<<m_PositionResolution.GetZ()<<";"<<m_EnergyResolution;
+  for (unsigned int i = 0; i < Origins.size(); ++i) {
+    S<<";"<<Origins[i]; 
+  }
+  S<<endl;
+
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MHit::StreamDat(MAsciiBuffer& S, int Version)
+{
+  //! Dump the content into a reusable character buffer (identical to the ostream version)
+  
+  if (Version != 1 && Version != 2) return true;
+  
+  S<<"HT "<<m_Position.GetX()<<' '<<m_Position.GetY()<<' '<<m_Position.GetZ()<<' '<<m_Energy<<'\n';
+  if (Version == 2) {
+    // The strip hits of this hit follow, so that we know which strip hits were associated with which hits
+    for (auto SH : m_StripHits) {
+      SH->StreamDat(S, 0);
+    }
+  }
+ 
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHit::StreamEvta(MAsciiBuffer& S)
+{
+  //! Stream the content in MEGAlib's evta format into a reusable character buffer (identical to the ostream version)
+  
+  vector<int> Origins;
+  CollectEvtaOrigins(Origins);
+  
+  S<<"HT 3;"<<m_Position.GetX()<<';'<<m_Position.GetY()<<';'<<m_Position.GetZ()<<';'<<m_Energy
+   <<';'<<m_PositionResolution.GetX()<<';'<<m_PositionResolution.GetY()<<';'<<m_PositionResolution.GetZ()<<';'<<m_EnergyResolution;
+  for (unsigned int i = 0; i < Origins.size(); ++i) {
+    S<<';'<<Origins[i]; 
+  }
+  S<<'\n';
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MHit::CollectEvtaOrigins(vector<int>& Origins)
+{
+  //! Collect the origins for the evta format
   
   // Fix the origins: only those existing both on x and y strips count
   vector<int> xOrigins;
@@ -194,14 +263,6 @@ void MHit::StreamEvta(ostream& S)
     sort(Origins.begin(), Origins.end());
     Origins.erase(unique(Origins.begin(), Origins.end()), Origins.end());
   }
-  
-  S<<"HT 3;"<<m_Position.GetX()<<";"<<m_Position.GetY()<<";"<<m_Position.GetZ()<<";"<<m_Energy
-       <<";"<<m_PositionResolution.GetX()<<";"<<m_PositionResolution.GetY()<<";"<<m_PositionResolution.GetZ()<<";"<<m_EnergyResolution;
-  for (unsigned int i = 0; i < Origins.size(); ++i) {
-    S<<";"<<Origins[i]; 
-  }
-  S<<endl;
-
 }
 
 
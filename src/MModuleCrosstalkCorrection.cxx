@@ -38,7 +38,6 @@
 // ROOT libs:
 #include "TGClient.h"
 #include "TFile.h"
-#include "TMatrixD.h"
 
 // MEGAlib libs:
 #include "MStreams.h"
@@ -88,6 +87,8 @@ MModuleCrosstalkCorrection::MModuleCrosstalkCorrection() : MModule()
   // Allow the use of multiple threads and instances
   m_AllowMultiThreading = true;
   m_AllowMultipleInstances = true;
+  
+  m_SolverMode = MStripCrosstalkSolver::c_ModeBanded;
 }
 
 
@@ -197,6 +198,11 @@ bool MModuleCrosstalkCorrection::Initialize()
     }
   } // 'DetectorNumber' loop
   
+  if (m_SolverMode != MStripCrosstalkSolver::c_ModeBanded && m_SolverMode != MStripCrosstalkSolver::c_ModeDense) {
+    mout<<"***Warning: Unknown cross-talk solver mode "<<m_SolverMode<<" - using the banded solver"<<endl;
+    m_SolverMode = MStripCrosstalkSolver::c_ModeBanded;
+  }
+  m_Solver.SetMode(m_SolverMode);
   
   return MModule::Initialize();
 }
@@ -205,36 +211,12 @@ bool MModuleCrosstalkCorrection::Initialize()
 ////////////////////////////////////////////////////////////////////////////////
 
 
-bool compare_striphits(MStripHit* SH1, MStripHit* SH2)
-{
-  int det1 = SH1->GetDetectorID();
-  int det2 = SH2->GetDetectorID();
-  int side1 = 0, side2 = 0;
-  int strip1 = SH1->GetStripID();
-  int strip2 = SH2->GetStripID();
-  if (not SH1->IsXStrip()) side1 = 1;
-  if (not SH2->IsXStrip()) side2 = 1;
-  if (det1 != det2) return (det1<det2);
-  else if ((det1==det2) && (side1!=side2)) return (side1<side2);
-  else if ((det1==det2) && (side1==side2)) return (strip1<strip2);
-  else
-  {
-    mout << "############# Problem in compare_striphits!" << endl;
-    return false;
-  }
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-
-
 bool MModuleCrosstalkCorrection::AnalyzeEvent(MReadOutAssembly* Event) 
 {
   // Main data analysis routine, which updates the event to a new level 
 
   
  //for (unsigned int sh=0; sh < Event->GetNHits(); sh++) {
-  unsigned int NStripHits = Event->GetNStripHits();
   vector<MStripHit*> StripHits;
   bool debug=false;
   
@@ -250,19 +232,10 @@ bool MModuleCrosstalkCorrection::AnalyzeEvent(MReadOutAssembly* Event)
     // Loop over detector sides
     for (unsigned int i_side=0; i_side<=1; i_side++)
     {
-      StripHits.clear();
-      // Extract strip hits from the given side of the given detector
-      for (unsigned int i_sh=0; i_sh<NStripHits; i_sh++)
-      {
-        // Count number of X and Y strips
-        MStripHit *SH = Event->GetStripHit(i_sh);
-        if ((SH->GetDetectorID()==i_det) 
-          && (((SH->IsXStrip()==true) && (i_side==0)) 
-          || ((SH->IsXStrip()==false) && (i_side==1))))
-        {
-          StripHits.push_back(SH);
-        }
-      }
+      // Extract strip hits from the given side of the given detector - they are sorted by strip ID
+      unsigned int NSideStripHits = Event->GetNStripHits(i_det, i_side);
+      MStripHit** SideStripHits = Event->GetStripHits(i_det, i_side);
+      StripHits.assign(SideStripHits, SideStripHits + NSideStripHits);
       if (StripHits.size()>=2)
       {
         // Perform the cross-talk correction!
@@ -456,22 +429,18 @@ bool MModuleCrosstalkCorrection::AnalyzeEvent(MReadOutAssembly* Event)
 
 
 // Method to make the cross-talk correction on a vector of strip hits
-// StripHits is a vector of StripHits from one side of one detector
-void MModuleCrosstalkCorrection::CorrectCrosstalk(vector<MStripHit*> StripHits, 
+// StripHits is a vector of StripHits from one side of one detector, sorted by strip ID
+void MModuleCrosstalkCorrection::CorrectCrosstalk(vector<MStripHit*>& StripHits, 
                                                      int det, unsigned int side)
 {
   bool debug=false;
-  bool debug_matrices=false;
   unsigned int N = StripHits.size();
-  // Sort the strip hits
-  sort(StripHits.begin(), StripHits.end(), compare_striphits);
   // Cross-talk coefficients
   double a0 = m_CrosstalkCoeffs[det][side][0][0];
   double b0 = m_CrosstalkCoeffs[det][side][0][1];
   double a1 = m_CrosstalkCoeffs[det][side][1][0];
   double b1 = m_CrosstalkCoeffs[det][side][1][1];
-  double a2 = m_CrosstalkCoeffs[det][side][2][0];
-  double b2 = m_CrosstalkCoeffs[det][side][2][1];
+  // Skip-2 neighbor contributions (a2, b2) are not used
   
   // Print out the strips, check their order
   if (debug && StripHits.size()>0)
@@ -486,64 +455,20 @@ void MModuleCrosstalkCorrection::CorrectCrosstalk(vector<MStripHit*> StripHits,
     }
   }
   
-  // Make a matrix vector of energies from each strip
-  TMatrixD Energies(N,1);
-  double Energy_Total = 0.;
-  for (unsigned int j=0; j<StripHits.size(); j++)
+  // Solve (1 + cross-talk matrix) * corrected energies = energies + cross-talk offsets
+  m_StripIDs.resize(N);
+  m_Energies.resize(N);
+  m_CorrectedEnergies.resize(N);
+  for (unsigned int j=0; j<N; j++)
   {
-    Energies[j][0] = StripHits[j]->GetEnergy();
-    Energy_Total += StripHits[j]->GetEnergy();
+    m_StripIDs[j] = StripHits[j]->GetStripID();
+    m_Energies[j] = StripHits[j]->GetEnergy();
   }
-  if (debug_matrices && N>=2) Energies.Print();
-  
-  // Make a big matrix for the cross-talk corrections
-  TMatrixD Matrix(N,N);
-  TMatrixD Constant(N,1);
-  for (unsigned int i=0; i<StripHits.size(); i++)
+  m_Solver.SetCoefficients(a0, b0, a1, b1);
+  m_Solver.Solve(N, &m_StripIDs[0], &m_Energies[0], &m_CorrectedEnergies[0]);
+  for (unsigned int j=0; j<N; j++)
   {
-    for (unsigned int j=i; j<StripHits.size(); j++)
-    {
-      // Self-contribution
-      if (i==j)
-      {
-        Matrix[i][j] += 1.0;
-      }
-      // Nearest-neighbor contributions
-      if (StripHits[j]->GetStripID()==(StripHits[i]->GetStripID()+1))
-      {
-        Matrix[i][j] += b0;
-        Matrix[j][i] += b0;
-        Constant[i] += a0/2.;
-        Constant[j] += a0/2.;
-      }
-      // Skip-1 neighbor contributions
-      if (StripHits[j]->GetStripID()==(StripHits[i]->GetStripID()+2))
-      {
-        Matrix[i][j] += b1;
-        Matrix[j][i] += b1;
-        Constant[i] += a1/2.;
-        Constant[j] += a1/2.;
-      }
-      // Skip-2 neighbor contributions
-     // if (StripHits[j]->GetStripID()==(StripHits[i]->GetStripID()+3))
-     // {
-     //   Matrix[i][j] += b2;
-     //   Matrix[j][i] += b2;
-     //   Constant[i] += a2/2.;
-     //   Constant[j] += a2/2.;
-     // }
-    }
-  }
-  if (debug_matrices && N>=2) Constant.Print();
-  if (debug_matrices && N>=2) Matrix.Print();
-  TMatrixD Inv = Matrix.Invert();
-  if (debug_matrices && N>=2) Inv.Print();
-  // Calculate final corrected energies
-  TMatrixD FinalEnergies = TMatrixD(Inv,TMatrixD::kMult,Energies+Constant); //ck changed this to Energies + Constant
-  if (debug_matrices && N>=2) FinalEnergies.Print();
-  for (unsigned int j=0; j<StripHits.size(); j++)
-  {
-    StripHits[j]->SetEnergy(FinalEnergies[j][0]);
+    StripHits[j]->SetEnergy(m_CorrectedEnergies[j]);
   }
   
   // Print out the strips again, check their order and energies
@@ -595,6 +520,10 @@ bool MModuleCrosstalkCorrection::ReadXmlConfiguration(MXmlNode* Node)
   if (FileNameNode != 0) {
     m_FileName = FileNameNode->GetValue();
   }
+  MXmlNode* SolverModeNode = Node->GetNode("SolverMode");
+  if (SolverModeNode != 0) {
+    m_SolverMode = SolverModeNode->GetValueAsUnsignedInt();
+  }
   return true;
 }
 
@@ -608,6 +537,7 @@ MXmlNode* MModuleCrosstalkCorrection::CreateXmlConfiguration()
 
   MXmlNode* Node = new MXmlNode(0, m_XmlTag);
   new MXmlNode(Node, "FileName", m_FileName);
+  new MXmlNode(Node, "SolverMode", m_SolverMode);
 
   return Node;
 
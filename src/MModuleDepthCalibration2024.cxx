@@ -88,7 +88,30 @@ MModuleDepthCalibration2024::MModuleDepthCalibration2024() : MModule()
   m_Error3 = 0;
   m_Error4 = 0;
   m_Error5 = 0;
+  m_Error6 = 0;
   m_ErrorSH = 0;
+
+  m_Coeffs_Energy = 0;
+  m_SplinesFileIsLoaded = false;
+  m_CoeffsFileIsLoaded = false;
+  m_TACCalFileIsLoaded = false;
+  m_UCSDOverride = false;
+  m_EnergyCalibration = nullptr;
+
+  m_UseDepthTables = false;
+  m_CrossCheckDepthTables = false;
+  m_NDepthTableChecks = 0;
+  m_NDepthTableMisses = 0;
+  m_MaxDepthTableMeanDeviation = 0.0;
+  m_MaxDepthTableSigmaDeviation = 0.0;
+
+  for (int d = 0; d < c_MaxDetectors; ++d) {
+    m_Thicknesses[d] = 0.0;
+    m_NXStrips[d] = 0;
+    m_NYStrips[d] = 0;
+    m_XPitches[d] = 0.0;
+    m_YPitches[d] = 0.0;
+  }
 }
 
 
@@ -106,6 +129,8 @@ MModuleDepthCalibration2024::~MModuleDepthCalibration2024()
 
 bool MModuleDepthCalibration2024::Initialize()
 {
+  // All calibration data goes into dense tables, which are only filled here
+  ResetCalibrationTables();
 
   if( LoadCoeffsFile(m_CoeffsFile) == false ){
     return false;
@@ -129,6 +154,10 @@ bool MModuleDepthCalibration2024::Initialize()
     if ( m_UCSDOverride ){
       DetID = 11;
     }
+    if ( DetID >= (unsigned int) c_MaxDetectors ){
+      cout << "MModuleDepthCalibration2024: Only " << c_MaxDetectors << " detectors are supported, ignoring detector " << DetID << "." << endl;
+      continue;
+    }
     MDDetector* det = m_Detectors[i];
     // MString det_name = (det->GetDetectorVolume())->GetNamedDetectorName(0);
     if (det->GetNNamedDetectors() > 0){
@@ -145,6 +174,10 @@ bool MModuleDepthCalibration2024::Initialize()
       MString det_name = det->GetNamedDetectorName(0);
       m_DetectorNames[DetID] = det_name;
       MDStrip3D* strip = dynamic_cast<MDStrip3D*>(det);
+      if ( strip == nullptr ){
+        cout << "MModuleDepthCalibration2024: Detector " << det_name << " is not a 3D strip detector." << endl;
+        return false;
+      }
       m_XPitches[DetID] = strip->GetPitchX();
       m_YPitches[DetID] = strip->GetPitchY();
       m_NXStrips[DetID] = strip->GetNStripsX();
@@ -154,6 +187,10 @@ bool MModuleDepthCalibration2024::Initialize()
       cout << "Number of Y strips: " << m_NYStrips[DetID] << endl;
       cout << "X strip pitch: " << m_XPitches[DetID] << endl;
       cout << "Y strip pitch: " << m_YPitches[DetID] << endl;
+      if ( m_NXStrips[DetID] > c_MaxStrips || m_NYStrips[DetID] > c_MaxStrips ){
+        cout << "MModuleDepthCalibration2024: Only " << c_MaxStrips << " strips per side are supported." << endl;
+        return false;
+      }
     }
   }
 
@@ -239,7 +276,14 @@ bool MModuleDepthCalibration2024::AnalyzeEvent(MReadOutAssembly* Event)
       int DetID = XSH->GetDetectorID();
       int XStripID = XSH->GetStripID();
       int YStripID = YSH->GetStripID();
-      int pixel_code = 10000*DetID + 100*XStripID + YStripID;
+
+      if ( DetID < 0 || DetID >= c_MaxDetectors ){
+        cout << "MModuleDepthCalibration2024: Got a hit in an unknown detector " << DetID << "." << endl;
+        H->SetNoDepth();
+        Event->SetDepthCalibrationIncomplete();
+        ++m_ErrorSH;
+        continue;
+      }
 
       // TODO: Calculate X and Y positions more rigorously using charge sharing.
       // Somewhat confusing notation: XStrips run parallel to X-axis, so we calculate X position with YStrips.
@@ -254,22 +298,28 @@ bool MModuleDepthCalibration2024::AnalyzeEvent(MReadOutAssembly* Event)
       double Zsigma = m_Thicknesses[DetID]/sqrt(12.0);
 
       // cout << "looking up the coefficients" << endl;
-      vector<double>* Coeffs = GetPixelCoeffs(pixel_code);
+      int PixelIndex = GetPixelIndex(DetID, XStripID, YStripID);
 
       // TODO: For Card Cage, may need to add noise
       double XTiming = XSH->GetTiming();
       double YTiming = YSH->GetTiming();
       if ( !m_UCSDOverride ) {
-        if ( m_TACCalFileIsLoaded ) {
+        int XIndex = GetStripIndex(DetID, XStripID);
+        int YIndex = GetStripIndex(DetID, YStripID);
+        if ( m_TACCalFileIsLoaded && XIndex >= 0 && YIndex >= 0 ) {
           if ( XSH->IsLowVoltageStrip() ){
-            XTiming = XTiming*m_LVTACCal[DetID][XStripID][0] + m_LVTACCal[DetID][XStripID][1];
-            YTiming = YTiming*m_HVTACCal[DetID][YStripID][0] + m_HVTACCal[DetID][YStripID][1];
+            XTiming = XTiming*m_LVTACSlope[XIndex] + m_LVTACOffset[XIndex];
+            YTiming = YTiming*m_HVTACSlope[YIndex] + m_HVTACOffset[YIndex];
           }
           else {
-            XTiming = XTiming*m_HVTACCal[DetID][XStripID][0] + m_HVTACCal[DetID][XStripID][1];
-            YTiming = YTiming*m_LVTACCal[DetID][YStripID][0] + m_LVTACCal[DetID][YStripID][1];
+            XTiming = XTiming*m_HVTACSlope[XIndex] + m_HVTACOffset[XIndex];
+            YTiming = YTiming*m_LVTACSlope[YIndex] + m_LVTACOffset[YIndex];
           }
         }
+        else if ( m_TACCalFileIsLoaded ) {
+          XTiming = 0.0;
+          YTiming = 0.0;
+        }
         else { 
           if ( XSH->IsLowVoltageStrip() ){
             XTiming = XTiming*0.405 - 525.;
@@ -285,7 +335,7 @@ bool MModuleDepthCalibration2024::AnalyzeEvent(MReadOutAssembly* Event)
       // cout << "Got the coefficients: " << Coeffs << endl;
 
       // If there aren't coefficients loaded, then calibration is incomplete.
-      if( Coeffs == nullptr ){
+      if( PixelIndex < 0 ){
         //set the bad flag for depth
         H->SetNoDepth();
         Event->SetDepthCalibrationIncomplete();
@@ -303,15 +353,6 @@ bool MModuleDepthCalibration2024::AnalyzeEvent(MReadOutAssembly* Event)
       // If there are coefficients and timing information is loaded, try calculating the CTD and depth
       else {
 
-        vector<double> ctdvec = GetCTD(DetID, Grade);
-        vector<double> depthvec = GetDepth(DetID);
-
-      	if ( ctdvec.size() == 0){
-      	  cout << "Empty CTD vector" << endl;
-      	  H->SetNoDepth();
-      	  Event->SetDepthCalibrationIncomplete();
-      	}
-
         double CTD;
         if ( XSH->IsLowVoltageStrip() ){
           CTD = (YTiming - XTiming);
@@ -323,59 +364,72 @@ bool MModuleDepthCalibration2024::AnalyzeEvent(MReadOutAssembly* Event)
         // cout << "Got the CTD: " << CTD << endl;
 
         // Confirmed that this matches SP's python code.
-        CTD_s = (CTD - Coeffs->at(1))/(Coeffs->at(0)); //apply inverse stretch and offset
+        CTD_s = (CTD - m_PixelOffset[PixelIndex])/m_PixelStretch[PixelIndex]; //apply inverse stretch and offset
 
         // cout << "Transformed CTD: " << CTD_s << endl;
 
-        double Xmin = * std::min_element(ctdvec.begin(), ctdvec.end());
-        double Xmax = * std::max_element(ctdvec.begin(), ctdvec.end());
+        const DepthTable& Table = m_DepthTables[DetID*c_NDepthTableGrades + Grade];
 
-        // cout << "Got the min and max ctd values: " << Xmin << "; " << Xmax << endl;
-
-        double noise = GetTimingNoiseFWHM(pixel_code, H->GetEnergy());
+      	if ( Table.HasRelation == false ){
+      	  cout << "Empty CTD vector" << endl;
+      	  H->SetNoDepth();
+      	  Event->SetDepthCalibrationIncomplete();
+      	}
 
-        // cout << "Got the timing noise: " << noise << endl;
+        else {
+          double noise = GetTimingNoiseFWHM(PixelIndex, H->GetEnergy());
 
-        //if the CTD is out of range, check if we should reject the event.
-        if( (CTD_s < (Xmin - 2.0*noise)) || (CTD_s > (Xmax + 2.0*noise)) ){
-          H->SetNoDepth();
-          Event->SetDepthCalibrationIncomplete();
-          ++m_Error2;
-        }
+          // cout << "Got the timing noise: " << noise << endl;
 
-        // If the CTD is in range, calculate the depth
-        else {
-          // cout << "Calculating depth" << endl;
-          // Calculate the probability given timing noise of CTD_s corresponding to the values of depth in depthvec
-          // Utlize symmetry of the normal distribution.
-          // TODO: Get the energy of the event and pass it to GetTimingNoiseFWHM
-          vector<double> prob_dist = norm_pdf(ctdvec, CTD_s, noise/2.355);
-          
-          // Weight the depth by probability
-      	  double prob_sum = 0.0;
-      	  for( unsigned int k=0; k < prob_dist.size(); ++k ){
-      	    prob_sum += prob_dist[k];
-      	  }
-          //double prob_sum = std::accumulate(prob_dist.begin(), prob_dist.end(), 0);
-	         //cout << "summed probability: " << prob_sum << endl;
-          double weighted_depth = 0.0;
-          for( unsigned int k = 0; k < depthvec.size(); ++k ){
-            weighted_depth += prob_dist[k]*depthvec[k];
+          //if the CTD is out of range, check if we should reject the event.
+          if( (CTD_s < (Table.CTDMin - 2.0*noise)) || (CTD_s > (Table.CTDMax + 2.0*noise)) ){
+            H->SetNoDepth();
+            Event->SetDepthCalibrationIncomplete();
+            ++m_Error2;
           }
-          // Calculate the expectation value of the depth
-          double mean_depth = weighted_depth/prob_sum;
 
-          // Calculate the standard deviation of the depth
-          double depth_var = 0.0;
-          for( unsigned int k=0; k<depthvec.size(); ++k ){
-            depth_var += prob_dist[k]*pow(depthvec[k]-mean_depth, 2.0);
+          // If the CTD is in range, calculate the depth
+          else {
+            // Calculate the probability given timing noise of CTD_s corresponding to the values of depth in depthvec
+            double mean_depth = 0.0;
+            double depth_sigma = 0.0;
+            bool Found = false;
+            if ( m_UseDepthTables == true ){
+              Found = LookupDepthTable(DetID, Grade, CTD_s, noise, mean_depth, depth_sigma);
+            }
+            if ( Found == false || m_CrossCheckDepthTables == true ){
+              double exact_depth = 0.0;
+              double exact_sigma = 0.0;
+              bool Calculated = CalculateDepthExact(GetCTD(DetID, Grade), GetDepth(DetID), CTD_s, noise, exact_depth, exact_sigma);
+              if ( Found == true ){
+                if ( Calculated == true ){
+                  ++m_NDepthTableChecks;
+                  m_MaxDepthTableMeanDeviation = max(m_MaxDepthTableMeanDeviation, fabs(mean_depth - exact_depth));
+                  m_MaxDepthTableSigmaDeviation = max(m_MaxDepthTableSigmaDeviation, fabs(depth_sigma - exact_sigma));
+                }
+              } else {
+                if ( m_UseDepthTables == true ){
+                  ++m_NDepthTableMisses;
+                }
+                mean_depth = exact_depth;
+                depth_sigma = exact_sigma;
+                Found = Calculated;
+              }
+            }
+
+            if ( Found == false ){
+              H->SetNoDepth();
+              Event->SetDepthCalibrationIncomplete();
+              ++m_Error2;
+            }
+            else {
+              Zsigma = depth_sigma;
+              Zpos = mean_depth - (m_Thicknesses[DetID]/2.0);
+              // Zpos = mean_depth;
+              // cout << "calculated depth: " << Zpos << endl;
+              m_NoError+=1;
+            }
           }
-
-          Zsigma =  sqrt(depth_var/prob_sum);
-          Zpos = mean_depth - (m_Thicknesses[DetID]/2.0);
-          // Zpos = mean_depth;
-	  // cout << "calculated depth: " << Zpos << endl;
-          m_NoError+=1;
         }
       }
 
@@ -432,13 +486,13 @@ MStripHit* MModuleDepthCalibration2024::GetDominantStrip(vector<MStripHit*>& Str
   return MaxStrip;
 }
 
-double MModuleDepthCalibration2024::GetTimingNoiseFWHM(int pixel_code, double Energy)
+double MModuleDepthCalibration2024::GetTimingNoiseFWHM(int PixelIndex, double Energy)
 {
   // Placeholder for determining the timing noise with energy, and possibly even on a pixel-by-pixel basis.
   // Should follow 1/E relation
   // TODO: Check that this makes sense
-  if ( m_Coeffs_Energy != NULL ){
-    return m_Coeffs[pixel_code][2] * m_Coeffs_Energy/Energy;
+  if ( m_Coeffs_Energy != 0 ){
+    return m_PixelNoiseFWHM[PixelIndex] * m_Coeffs_Energy/Energy;
   }
   else{
     return 6.0*2.355;
@@ -472,9 +526,19 @@ bool MModuleDepthCalibration2024::LoadCoeffsFile(MString FName)
           double CTD_FWHM = Tokens[3].ToDouble() * 2.355;
           double Chi2 = Tokens[4].ToDouble();
           // Previous iteration of depth calibration read in "Scale" instead of ctd resolution.
-          vector<double> coeffs;
-          coeffs.push_back(Stretch); coeffs.push_back(Offset); coeffs.push_back(CTD_FWHM); coeffs.push_back(Chi2);
-          m_Coeffs[pixel_code] = coeffs;
+          int DetID = pixel_code / 10000;
+          int XStripID = (pixel_code % 10000) / 100;
+          int YStripID = pixel_code % 100;
+          if( pixel_code < 0 || DetID >= c_MaxDetectors || XStripID >= c_MaxStrips || YStripID >= c_MaxStrips ){
+            cout << "MModuleDepthCalibration2024: pixel code " << pixel_code << " is outside of the supported range, ignoring it." << endl;
+            continue;
+          }
+          int PixelIndex = (DetID*c_MaxStrips + XStripID)*c_MaxStrips + YStripID;
+          m_PixelStretch[PixelIndex] = Stretch;
+          m_PixelOffset[PixelIndex] = Offset;
+          m_PixelNoiseFWHM[PixelIndex] = CTD_FWHM;
+          m_PixelChi2[PixelIndex] = Chi2;
+          m_PixelHasCoeffs[PixelIndex] = 1;
         }
       }
     }
@@ -497,12 +561,6 @@ bool MModuleDepthCalibration2024::LoadTACCalFile(MString FName)
     m_TACCalFileIsLoaded = false;
     return false;
   } else {
-    for(unsigned int i = 0; i < m_Detectors.size(); ++i){
-      unordered_map<int, vector<double>> temp_map_HV;
-      m_HVTACCal[i] = temp_map_HV;
-      unordered_map<int, vector<double>> temp_map_LV;
-      m_LVTACCal[i] = temp_map_LV;
-    }
     MString Line;
     while( F.ReadLine( Line ) ){
       if( !Line.BeginsWith("#") ){
@@ -511,16 +569,19 @@ bool MModuleDepthCalibration2024::LoadTACCalFile(MString FName)
           int DetID = Tokens[0].ToInt();
           int StripID = Tokens[2].ToInt();
           double taccal = Tokens[3].ToDouble();
-          double taccal_err = Tokens[4].ToDouble();
           double offset = Tokens[5].ToDouble();
-          double offset_err = Tokens[6].ToDouble();
-          vector<double> cal_vals;
-          cal_vals.push_back(taccal); cal_vals.push_back(offset); cal_vals.push_back(taccal_err); cal_vals.push_back(offset_err);
+          int StripIndex = GetStripIndex(DetID, StripID);
+          if ( StripIndex < 0 ){
+            cout << "MModuleDepthCalibration2024: TAC calibration for detector " << DetID << " strip " << StripID << " is outside of the supported range, ignoring it." << endl;
+            continue;
+          }
           if ( Tokens[1] == "l" ){
-            m_LVTACCal[DetID][StripID] = cal_vals;
+            m_LVTACSlope[StripIndex] = taccal;
+            m_LVTACOffset[StripIndex] = offset;
           }
           else if ( Tokens[1] == "h" ){
-            m_HVTACCal[DetID][StripID] = cal_vals;
+            m_HVTACSlope[StripIndex] = taccal;
+            m_HVTACOffset[StripIndex] = offset;
           }
         }
       }
@@ -535,32 +596,200 @@ bool MModuleDepthCalibration2024::LoadTACCalFile(MString FName)
 }
 
 
-std::vector<double>* MModuleDepthCalibration2024::GetPixelCoeffs(int pixel_code)
+void MModuleDepthCalibration2024::ResetCalibrationTables()
+{
+  // Size the dense calibration tables once, so that the per-hit lookups never allocate
+
+  unsigned int NPixels = c_MaxDetectors*c_MaxStrips*c_MaxStrips;
+  m_PixelStretch.assign(NPixels, 1.0);
+  m_PixelOffset.assign(NPixels, 0.0);
+  m_PixelNoiseFWHM.assign(NPixels, 0.0);
+  m_PixelChi2.assign(NPixels, 0.0);
+  m_PixelHasCoeffs.assign(NPixels, 0);
+
+  unsigned int NStrips = c_MaxDetectors*c_MaxStrips;
+  m_HVTACSlope.assign(NStrips, 0.0);
+  m_HVTACOffset.assign(NStrips, 0.0);
+  m_LVTACSlope.assign(NStrips, 0.0);
+  m_LVTACOffset.assign(NStrips, 0.0);
+
+  m_Coeffs_Energy = 0;
+  m_CoeffsFileIsLoaded = false;
+  m_TACCalFileIsLoaded = false;
+}
+
+
+int MModuleDepthCalibration2024::GetPixelIndex(int DetID, int XStripID, int YStripID)
 {
   // Check to see if the stretch and offset have been loaded. If so, try to get the coefficients for the specified pixel.
   if( m_CoeffsFileIsLoaded ){
-    if( m_Coeffs.count(pixel_code) > 0 ){
-      return &m_Coeffs[pixel_code];
-    } else {
-      cout << "MModuleDepthCalibration2024::GetPixelCoeffs: cannot get stretch and offset; pixel code " << pixel_code << " not found." << endl;
-      return nullptr;
+    if( DetID >= 0 && DetID < c_MaxDetectors && XStripID >= 0 && XStripID < c_MaxStrips && YStripID >= 0 && YStripID < c_MaxStrips ){
+      int PixelIndex = (DetID*c_MaxStrips + XStripID)*c_MaxStrips + YStripID;
+      if( m_PixelHasCoeffs[PixelIndex] != 0 ){
+        return PixelIndex;
+      }
     }
+    cout << "MModuleDepthCalibration2024::GetPixelIndex: cannot get stretch and offset; pixel code " << 10000*DetID + 100*XStripID + YStripID << " not found." << endl;
+    return -1;
   } else {
-    cout << "MModuleDepthCalibration2024::GetPixelCoeffs: cannot get stretch and offset; file has not yet been loaded." << endl;
-    return nullptr;
+    cout << "MModuleDepthCalibration2024::GetPixelIndex: cannot get stretch and offset; file has not yet been loaded." << endl;
+    return -1;
+  }
+
+}
+
+
+int MModuleDepthCalibration2024::GetStripIndex(int DetID, int StripID) const
+{
+  // Return the position of a strip in the dense TAC calibration tables
+
+  if( DetID < 0 || DetID >= c_MaxDetectors || StripID < 0 || StripID >= c_MaxStrips ){
+    return -1;
+  }
+  return DetID*c_MaxStrips + StripID;
+}
+
+bool MModuleDepthCalibration2024::CalculateDepthExact(const vector<double>& CTDs, const vector<double>& Depths, double CTD_s, double Noise, double& MeanDepth, double& DepthSigma)
+{
+  // Weight the depth grid by the probability that the measured CTD_s (with a timing noise FWHM of Noise)
+  // corresponds to the CTD at each depth, and return the expectation value and standard deviation of the depth.
+  // This is done in a single (vectorized) pass over the grid, see MGaussianDepthKernel
+
+  return m_DepthKernel.Calculate(CTDs, Depths, CTD_s, Noise, MeanDepth, DepthSigma);
+}
+
+bool MModuleDepthCalibration2024::LookupDepthTable(int DetID, int Grade, double CTD_s, double Noise, double& MeanDepth, double& DepthSigma)
+{
+  // Bilinear interpolation in the (CTD_s, log(noise)) table
+
+  const DepthTable& T = m_DepthTables[DetID*c_NDepthTableGrades + Grade];
+  if( T.IsTabulated == false || Noise <= 0.0 ){
+    return false;
   }
 
+  double u = (CTD_s - T.CTDStart)*T.InvCTDBinWidth;
+  if( u < 0.0 || u > T.NCTDBins - 1 ){
+    return false;
+  }
+  unsigned int i = min((unsigned int) u, T.NCTDBins - 2);
+  double fu = u - i;
+
+  unsigned int j = 0;
+  double fv = 0.0;
+  if( T.NNoiseBins > 1 ){
+    double v = (log(Noise) - T.LogNoiseStart)*T.InvLogNoiseBinWidth;
+    if( v < 0.0 || v > T.NNoiseBins - 1 ){
+      return false;
+    }
+    j = min((unsigned int) v, T.NNoiseBins - 2);
+    fv = v - j;
+  }
+
+  const float* V00 = &T.Values[2*(j*T.NCTDBins + i)];
+  const float* V01 = V00 + 2;
+  const float* V10 = (T.NNoiseBins > 1) ? V00 + 2*T.NCTDBins : V00;
+  const float* V11 = V10 + 2;
+
+  // Nodes at which the exact calculation failed (no probability anywhere on the grid) are marked NaN
+  double Mean = (1.0 - fv)*((1.0 - fu)*V00[0] + fu*V01[0]) + fv*((1.0 - fu)*V10[0] + fu*V11[0]);
+  double Sigma = (1.0 - fv)*((1.0 - fu)*V00[1] + fu*V01[1]) + fv*((1.0 - fu)*V10[1] + fu*V11[1]);
+  if( std::isfinite(Mean) == false || std::isfinite(Sigma) == false ){
+    return false;
+  }
+
+  MeanDepth = Mean;
+  DepthSigma = Sigma;
+
+  return true;
 }
 
-vector<double> MModuleDepthCalibration2024::norm_pdf(vector<double> x, double mu, double sigma)
+void MModuleDepthCalibration2024::GetTimingNoiseRange(double& NoiseMin, double& NoiseMax)
 {
-  vector<double> result;
-  for( unsigned int i=0; i<x.size(); ++i ){
-    double prob = 1.0 / (sigma * sqrt(2.0 * M_PI)) * exp(-(pow((x[i] - mu)/sigma, 2.0)/2.0));
-    // cout << "Probability: " << prob << endl;
-    result.push_back(prob);
+  // The timing noise scales with 1/E (see GetTimingNoiseFWHM), thus cover all pixels between these energies
+
+  const double EnergyMin = 10.0;
+  const double EnergyMax = 5000.0;
+
+  if( m_CoeffsFileIsLoaded == false || m_Coeffs_Energy == 0 ){
+    NoiseMin = 6.0*2.355;
+    NoiseMax = 6.0*2.355;
+    return;
+  }
+
+  NoiseMin = numeric_limits<double>::max();
+  NoiseMax = 0.0;
+  for( unsigned int p = 0; p < m_PixelHasCoeffs.size(); ++p ){
+    if( m_PixelHasCoeffs[p] != 0 && m_PixelNoiseFWHM[p] > 0.0 ){
+      NoiseMin = min(NoiseMin, m_PixelNoiseFWHM[p]*m_Coeffs_Energy/EnergyMax);
+      NoiseMax = max(NoiseMax, m_PixelNoiseFWHM[p]*m_Coeffs_Energy/EnergyMin);
+    }
+  }
+  if( NoiseMax == 0.0 ){
+    NoiseMin = 6.0*2.355;
+    NoiseMax = 6.0*2.355;
+  }
+}
+
+void MModuleDepthCalibration2024::BuildDepthTables()
+{
+  // Cache the CTD range of each detector and grade, and if requested
+  // tabulate mean depth and depth sigma as a function of CTD_s and timing noise
+
+  m_DepthTables.assign(c_MaxDetectors*c_NDepthTableGrades, DepthTable());
+
+  double NoiseMin, NoiseMax;
+  GetTimingNoiseRange(NoiseMin, NoiseMax);
+
+  for( auto& D: m_CTDMap ){
+    int DetID = D.first;
+    if( DetID < 0 || DetID >= c_MaxDetectors ) continue;
+    const vector<double>& Depths = GetDepth(DetID);
+
+    for( int Grade = 0; Grade < c_NDepthTableGrades; ++Grade ){
+      const vector<double>& CTDs = GetCTD(DetID, Grade);
+      if( CTDs.size() == 0 ) continue;
+
+      DepthTable& T = m_DepthTables[DetID*c_NDepthTableGrades + Grade];
+      T.HasRelation = true;
+      T.CTDMin = * std::min_element(CTDs.begin(), CTDs.end());
+      T.CTDMax = * std::max_element(CTDs.begin(), CTDs.end());
+
+      if( m_UseDepthTables == false ) continue;
+
+      // A noise larger than the full CTD range washes out the depth anyway - leave such hits to the exact calculation
+      double TableNoiseMax = min(NoiseMax, max(T.CTDMax - T.CTDMin, NoiseMin));
+
+      T.NCTDBins = c_DepthTableCTDBins;
+      T.CTDStart = T.CTDMin - 2.0*TableNoiseMax;
+      double CTDBinWidth = (T.CTDMax + 2.0*TableNoiseMax - T.CTDStart)/(T.NCTDBins - 1);
+      if( CTDBinWidth <= 0.0 ) continue;
+      T.InvCTDBinWidth = 1.0/CTDBinWidth;
+
+      T.NNoiseBins = (TableNoiseMax > NoiseMin) ? c_DepthTableNoiseBins : 1;
+      T.LogNoiseStart = log(NoiseMin);
+      double LogNoiseBinWidth = (T.NNoiseBins > 1) ? (log(TableNoiseMax) - T.LogNoiseStart)/(T.NNoiseBins - 1) : 0.0;
+      T.InvLogNoiseBinWidth = (T.NNoiseBins > 1) ? 1.0/LogNoiseBinWidth : 0.0;
+
+      T.Values.resize(2*T.NNoiseBins*T.NCTDBins);
+      for( unsigned int j = 0; j < T.NNoiseBins; ++j ){
+        double Noise = exp(T.LogNoiseStart + j*LogNoiseBinWidth);
+        for( unsigned int i = 0; i < T.NCTDBins; ++i ){
+          double Mean = 0.0, Sigma = 0.0;
+          if( CalculateDepthExact(CTDs, Depths, T.CTDStart + i*CTDBinWidth, Noise, Mean, Sigma) == false ){
+            Mean = numeric_limits<double>::quiet_NaN();
+            Sigma = numeric_limits<double>::quiet_NaN();
+          }
+          T.Values[2*(j*T.NCTDBins + i)] = Mean;
+          T.Values[2*(j*T.NCTDBins + i) + 1] = Sigma;
+        }
+      }
+      T.IsTabulated = true;
+    }
+  }
+
+  if( m_UseDepthTables == true ){
+    cout << "MModuleDepthCalibration2024: Tabulated the CTD->depth relations for timing noise FWHM between " << NoiseMin << " and " << NoiseMax << " ns." << endl;
   }
-  return result;
 }
 
 bool MModuleDepthCalibration2024::LoadSplinesFile(MString FName)
@@ -620,6 +849,9 @@ bool MModuleDepthCalibration2024::LoadSplinesFile(MString FName)
   }
 
   m_SplinesFileIsLoaded = true;
+
+  BuildDepthTables();
+
   return true;
 
 }
@@ -759,6 +991,11 @@ bool MModuleDepthCalibration2024::AddDepthCTD(vector<double> depthvec, vector<ve
     }
   }
 
+  if( DetID < 0 || DetID >= c_MaxDetectors ){
+    cout << "MModuleDepthCalibration2024::AddDepthCTD: Detector " << DetID << " is outside of the supported range." << endl;
+    return false;
+  }
+
   double maxdepth = * std::max_element(depthvec.begin(), depthvec.end());
   double mindepth = * std::min_element(depthvec.begin(), depthvec.end());
   m_Thicknesses[DetID] = maxdepth-mindepth;
@@ -778,13 +1015,15 @@ bool MModuleDepthCalibration2024::AddDepthCTD(vector<double> depthvec, vector<ve
 }
 
 
-vector<double> MModuleDepthCalibration2024::GetCTD(int DetID, int Grade)
+const vector<double>& MModuleDepthCalibration2024::GetCTD(int DetID, int Grade)
 {
   // Retrieves the appropriate CTD vector given the Detector ID and Event Grade passed
 
+  static const vector<double> Empty;
+
   if( !m_SplinesFileIsLoaded ){
     cout << "MModuleDepthCalibration2024::GetCTD: cannot return Depth to CTD relation because the file was not loaded." << endl;
-    return vector<double> ();
+    return Empty;
   }
   // If there is a CTD array for the given detector, return it.
   // If the Grade is larger than the number of CTD vectors stored, then just return Grade 0 vector.
@@ -798,17 +1037,19 @@ vector<double> MModuleDepthCalibration2024::GetCTD(int DetID, int Grade)
     }
   } else {
     cout << "MModuleDepthCalibration2024::GetCTD: No CTD map is loaded for Det " << DetID << "." << endl;
-    return vector<double> ();
+    return Empty;
   }
 }
 
-vector<double> MModuleDepthCalibration2024::GetDepth(int DetID)
+const vector<double>& MModuleDepthCalibration2024::GetDepth(int DetID)
 {
   // Retrieves the appropriate CTD vector given the Detector ID and Event Grade passed
 
+  static const vector<double> Empty;
+
   if( !m_SplinesFileIsLoaded ){
     cout << "MModuleDepthCalibration2024::GetDepth: cannot return Depth grid because the file was not loaded." << endl;
-    return vector<double> ();
+    return Empty;
   }
 
   // If there is a CTD array for the given detector, return it.
@@ -817,7 +1058,7 @@ vector<double> MModuleDepthCalibration2024::GetDepth(int DetID)
     return m_DepthGrid[DetID];
     } else {
       cout << "MModuleDepthCalibration2024::GetDepth: No Depth grid is loaded for Det " << DetID << "." << endl;
-      return vector<double> ();
+      return Empty;
   }
 } 
 
@@ -849,6 +1090,16 @@ bool MModuleDepthCalibration2024::ReadXmlConfiguration(MXmlNode* Node)
     m_TACCalFile = TACCalFileNameNode->GetValue();
   }
 
+  MXmlNode* UseDepthTablesNode = Node->GetNode("UseDepthTables");
+  if (UseDepthTablesNode != 0) {
+    m_UseDepthTables = UseDepthTablesNode->GetValueAsBoolean();
+  }
+
+  MXmlNode* CrossCheckDepthTablesNode = Node->GetNode("CrossCheckDepthTables");
+  if (CrossCheckDepthTablesNode != 0) {
+    m_CrossCheckDepthTables = CrossCheckDepthTablesNode->GetValueAsBoolean();
+  }
+
   return true;
 }
 
@@ -863,6 +1114,8 @@ MXmlNode* MModuleDepthCalibration2024::CreateXmlConfiguration()
   new MXmlNode(Node, "CoeffsFileName", m_CoeffsFile);
   new MXmlNode(Node, "SplinesFileName", m_SplinesFile);
   new MXmlNode(Node, "TACCalFileName", m_TACCalFile);
+  new MXmlNode(Node, "UseDepthTables", m_UseDepthTables);
+  new MXmlNode(Node, "CrossCheckDepthTables", m_CrossCheckDepthTables);
 
   return Node;
 }
@@ -882,6 +1135,14 @@ void MModuleDepthCalibration2024::Finalize()
   cout << "Number of hits with non-adjacent strip hits: " << m_Error6 << endl;
   cout << "Number of hits with too many strip hits: " << m_Error4 << endl;
   cout << "Number of hits with no strip hits on one or both sides: " << m_ErrorSH << endl;
+  if ( m_UseDepthTables ){
+    cout << "Number of hits outside of the depth tables: " << m_NDepthTableMisses << endl;
+  }
+  if ( m_UseDepthTables && m_CrossCheckDepthTables ){
+    cout << "Number of hits cross-checked against the exact depth calculation: " << m_NDepthTableChecks << endl;
+    cout << "Maximum deviation of the tabulated mean depth: " << m_MaxDepthTableMeanDeviation << " cm" << endl;
+    cout << "Maximum deviation of the tabulated depth sigma: " << m_MaxDepthTableSigmaDeviation << " cm" << endl;
+  }
   /*
   TFile* rootF = new TFile("EHist.root","recreate");
   rootF->WriteTObject( EHist );
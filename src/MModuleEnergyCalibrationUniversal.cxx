@@ -26,6 +26,7 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <algorithm>
 using namespace std;
 
 // Include the header:
@@ -188,6 +189,19 @@ bool MModuleEnergyCalibrationUniversal::Initialize()
 
 
 
+  // The dense calibration tables must hold all strips which appear in the calibration files
+  unsigned int NDetectors = 0;
+  unsigned int NStrips = 0;
+  for (auto ROEToLine: { &CM_ROEToLine, &CR_ROEToLine, &CT_ROEToLine }) {
+    for (auto& E: *ROEToLine) {
+      NDetectors = max(NDetectors, (unsigned int) E.first.GetDetectorID() + 1);
+      NStrips = max(NStrips, (unsigned int) E.first.GetStripID() + 1);
+    }
+  }
+  m_EnergyPolynomials.Reset(NDetectors, NStrips);
+  m_ResolutionPolynomials.Reset(NDetectors, NStrips);
+  m_TemperaturePolynomials.Reset(NDetectors, NStrips);
+
   for (auto CM: CM_ROEToLine) {
     // If we have at least three data points, we store the calibration
     
@@ -222,12 +236,8 @@ bool MModuleEnergyCalibrationUniversal::Initialize()
     if (CalibratorType == "poly1zero") {
       double a0 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
      
-      //From the fit parameters I just extracted from the .ecal file, I can define a function
-      TF1* melinatorfit = new TF1("poly1zero","0. + [0]*x", 0., 8191.);
-      melinatorfit->FixParameter(0, a0);
-     
-      //Define the map by saving the fit function I just created as a map to the current ReadOutElement
-      m_Calibration[CM.first] = melinatorfit;
+      double Coefficients[] = { 0., a0 };
+      m_EnergyPolynomials.Set(CM.first, Coefficients, 1);
      
     }     
         
@@ -236,27 +246,16 @@ bool MModuleEnergyCalibrationUniversal::Initialize()
       double a0 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
       double a1 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
       
-      //From the fit parameters I just extracted from the .ecal file, I can define a function
-      TF1* melinatorfit = new TF1("poly1","[0] + [1]*x", 0., 8191.);
-      melinatorfit->FixParameter(0, a0);
-      melinatorfit->FixParameter(1, a1);
-      
-      //Define the map by saving the fit function I just created as a map to the current ReadOutElement
-      m_Calibration[CM.first] = melinatorfit;
+      double Coefficients[] = { a0, a1 };
+      m_EnergyPolynomials.Set(CM.first, Coefficients, 1);
       
     } else if (CalibratorType == "poly2") {
       double a0 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
       double a1 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
       double a2 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
       
-      //From the fit parameters I just extracted from the .ecal file, I can define a function
-      TF1* melinatorfit = new TF1("poly2","[0] + [1]*x + [2]*x^2", 0., 8191.);
-      melinatorfit->FixParameter(0, a0);
-      melinatorfit->FixParameter(1, a1);
-      melinatorfit->FixParameter(2, a2);
-      
-      //Define the map by saving the fit function I just created as a map to the current ReadOutElement
-      m_Calibration[CM.first] = melinatorfit;
+      double Coefficients[] = { a0, a1, a2 };
+      m_EnergyPolynomials.Set(CM.first, Coefficients, 2);
       
     } 
      //Eventually, I'll be including other possible fits, but for now, we've just include poly3 and poly4
@@ -266,15 +265,8 @@ bool MModuleEnergyCalibrationUniversal::Initialize()
       double a2 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
       double a3 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
       
-      //From the fit parameters I just extracted from the .ecal file, I can define a function
-      TF1* melinatorfit = new TF1("poly3","[0] + [1]*x + [2]*x^2 + [3]*x^3", 0., 8191.);
-      melinatorfit->FixParameter(0, a0);
-      melinatorfit->FixParameter(1, a1);
-      melinatorfit->FixParameter(2, a2);
-      melinatorfit->FixParameter(3, a3);
-      
-      //Define the map by saving the fit function I just created as a map to the current ReadOutElement
-      m_Calibration[CM.first] = melinatorfit;
+      double Coefficients[] = { a0, a1, a2, a3 };
+      m_EnergyPolynomials.Set(CM.first, Coefficients, 3);
       
     } else if (CalibratorType == "poly4") {
       double a0 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
@@ -283,22 +275,16 @@ bool MModuleEnergyCalibrationUniversal::Initialize()
       double a3 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
       double a4 = Parser.GetTokenizerAt(CM.second)->GetTokenAtAsDouble(++Pos);
 
-      //From the fit parameters I just extracted from the .ecal file, I can define a function
-      TF1 * melinatorfit = new TF1("poly4","[0] + [1]*x + [2]*x^2 + [3]*x^3 + [4]*x^4", 0., 8191.);
-      melinatorfit->FixParameter(0, a0);
-      melinatorfit->FixParameter(1, a1);
-      melinatorfit->FixParameter(2, a2);
-      melinatorfit->FixParameter(3, a3);
-      melinatorfit->FixParameter(4, a4);
-
-      //Define the map by saving the fit function I just created as a map to the current ReadOutElement
-      m_Calibration[CM.first] = melinatorfit;
+      double Coefficients[] = { a0, a1, a2, a3, a4 };
+      m_EnergyPolynomials.Set(CM.first, Coefficients, 4);
 
     } else {
       if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Line parser: Unknown calibrator type ("<<CalibratorType<<") for strip"<<CM.first<<endl;
       continue;
     }
   }
+  // The inverses are needed by GetADC (the ADC range is the one of the original TF1 functions)
+  m_EnergyPolynomials.BuildInverse(0., 8191.);
   
   for (auto CR: CR_ROEToLine) {
 
@@ -308,11 +294,9 @@ bool MModuleEnergyCalibrationUniversal::Initialize()
     if (CalibratorType == "p1" || CalibratorType == "poly1") {
       double f0 = Parser.GetTokenizerAt(CR.second)->GetTokenAtAsDouble(++Pos);
       double f1 = Parser.GetTokenizerAt(CR.second)->GetTokenAtAsDouble(++Pos);
-      TF1* resolutionfit = new TF1("P1","([0]+[1]*x) / 2.355",0.,2000.);
-      resolutionfit->FixParameter(0,f0);
-      resolutionfit->FixParameter(1,f1);
-
-      m_ResolutionCalibration[CR.first] = resolutionfit;
+      // The FWHM resolution ([0]+[1]*x) converted to 1 sigma
+      double Coefficients[] = { f0/2.355, f1/2.355 };
+      m_ResolutionPolynomials.Set(CR.first, Coefficients, 1);
     } else {
       if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Line parser: Unknown resolution calibrator type ("<<CalibratorType<<") for strip"<<CR.first<<endl;
       continue;
@@ -325,11 +309,8 @@ bool MModuleEnergyCalibrationUniversal::Initialize()
       unsigned int Pos = 5;
       double f0 = Parser_Temp.GetTokenizerAt(CT.second)->GetTokenAtAsDouble(Pos);
       double f1 = Parser_Temp.GetTokenizerAt(CT.second)->GetTokenAtAsDouble(++Pos);
-      TF1 * temperaturefit = new TF1("temperaturefit", "pol1", 0, 40);
-      temperaturefit->FixParameter(0, f0);
-      temperaturefit->FixParameter(1, f1);
-
-      m_TemperatureCalibration[CT.first] = temperaturefit;
+      double Coefficients[] = { f0, f1 };
+      m_TemperaturePolynomials.Set(CT.first, Coefficients, 1);
     }
   }
 
@@ -345,52 +326,60 @@ bool MModuleEnergyCalibrationUniversal::AnalyzeEvent(MReadOutAssembly* Event)
 {
   // Main data analysis routine, which updates the event to a new level, i.e. takes the raw ADC value from the .roa file loaded through nuclearizer and converts it into energy units.
   
-  for (unsigned int i = 0; i < Event->GetNStripHits(); ++i) {
+  // Calibrate all strip hits of the event at once
+  unsigned int NStripHits = Event->GetNStripHits();
+  if (m_BatchSlots.size() < NStripHits) {
+    m_BatchSlots.resize(NStripHits);
+    m_BatchADCs.resize(NStripHits);
+    m_BatchTemperatures.resize(NStripHits);
+    m_BatchCorrectedADCs.resize(NStripHits);
+    m_BatchEnergies.resize(NStripHits);
+    m_BatchEnergyResolutions.resize(NStripHits);
+    m_BatchFlags.resize(NStripHits);
+  }
+  
+  for (unsigned int i = 0; i < NStripHits; ++i) {
     MStripHit* SH = Event->GetStripHit(i);
-    MReadOutElementDoubleStrip R = *dynamic_cast<MReadOutElementDoubleStrip*>(SH->GetReadOutElement());
-    
-    TF1* Fit = m_Calibration[R];
-    TF1* FitRes = m_ResolutionCalibration[R];
-    double temp, ADCMod, newADC;
+    m_BatchSlots[i] = GetCalibrationSlot(SH->GetDetectorID(), SH->IsPositiveStrip(), SH->GetStripID());
+    m_BatchADCs[i] = SH->GetADCUnits();
+    m_BatchTemperatures[i] = SH->GetPreampTemp();
+  }
+  
+  CalibrateEnergies(NStripHits, m_BatchSlots.data(), m_BatchADCs.data(), m_BatchTemperatures.data(),
+                    m_BatchCorrectedADCs.data(), m_BatchEnergies.data(), m_BatchEnergyResolutions.data(), m_BatchFlags.data());
+  
+  // Store the results and flag the event
+  for (unsigned int i = 0; i < NStripHits; ++i) {
+    MStripHit* SH = Event->GetStripHit(i);
+    unsigned char Flags = m_BatchFlags[i];
 
-    if (Fit == 0) {
-      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: Energy-fit not found for read-out element "<<R<<endl;
+    if ((Flags & c_NoEnergyCalibration) != 0) {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: Energy-fit not found for read-out element "<<*dynamic_cast<MReadOutElementDoubleStrip*>(SH->GetReadOutElement())<<endl;
       Event->SetEnergyCalibrationIncomplete_BadStrip(true);
     } else {
 
-      double Energy = 0;
       if (m_TemperatureEnabled) {
-	TF1* FitTemp = m_TemperatureCalibration[R];
-	if (FitTemp == 0) {
-	  if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: temp-fit not found for read-out element "<<R<<endl;
+        if ((Flags & c_NoTemperatureCalibration) != 0) {
+          if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: temp-fit not found for read-out element "<<*dynamic_cast<MReadOutElementDoubleStrip*>(SH->GetReadOutElement())<<endl;
           Event->SetEnergyCalibrationIncomplete_BadStrip(true);
         } else {
-          temp = SH->GetPreampTemp();
-	  ADCMod = FitTemp->Eval(temp);
-          newADC = (SH->GetADCUnits())/ADCMod;
- 	  SH->SetADCUnits(newADC); 
+          SH->SetADCUnits(m_BatchCorrectedADCs[i]);
         }
-      } 
-       
-      Energy = Fit->Eval(SH->GetADCUnits());
-
-      if (Energy < 0 && SH->GetADCUnits() > 100) {
+      }
+      
+      double Energy = m_BatchEnergies[i];
+      if ((Flags & c_NegativeEnergy) != 0) {
         Event->SetEnergyCalibrationIncomplete(true);
-        Energy = 0;
-      } else if (Energy < 0) {
-        Energy = 0;
       }
-     
       
       SH->SetEnergy(Energy);
-      if (FitRes == 0) {
-        if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: Energy Resolution fit not found for read-out element "<<R<<endl;
+      if ((Flags & c_NoResolutionCalibration) != 0) {
+        if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: Energy Resolution fit not found for read-out element "<<*dynamic_cast<MReadOutElementDoubleStrip*>(SH->GetReadOutElement())<<endl;
         Event->SetEnergyResolutionCalibrationIncomplete(true);
       } else {
-        double EnergyResolution = FitRes->Eval(Energy);
-        SH->SetEnergyResolution(EnergyResolution);
+        SH->SetEnergyResolution(m_BatchEnergyResolutions[i]);
       }
-      if (R.IsPositiveStrip() == true) {
+      if (SH->IsPositiveStrip() == true) {
         if (HasExpos() == true) {
           m_ExpoEnergyCalibration->AddEnergy(Energy);
         }
@@ -408,13 +397,95 @@ bool MModuleEnergyCalibrationUniversal::AnalyzeEvent(MReadOutAssembly* Event)
 /////////////////////////////////////////////////////////////////////////////////
 
 
+void MModuleEnergyCalibrationUniversal::CalibrateEnergies(unsigned int N, const int* Slots, const double* ADCs, const double* PreampTemperatures,
+                                                          double* CorrectedADCs, double* Energies, double* EnergyResolutions, unsigned char* Flags)
+{
+  // Calibrate N strip hits with one batch evaluation per calibration table - all tables share the same slots
+  // Strips without a polynomial are evaluated too (strips outside the tables in slot 0), and their results are replaced afterwards
+
+  if (N == 0) return;
+
+  if (m_EvaluationSlots.size() < N) {
+    m_EvaluationSlots.resize(N);
+    m_EvaluationValues.resize(3*N);
+    m_EvaluationFlags.resize(N);
+  }
+  if (CorrectedADCs == nullptr) CorrectedADCs = m_EvaluationValues.data();
+  if (EnergyResolutions == nullptr) EnergyResolutions = m_EvaluationValues.data() + N;
+  if (Flags == nullptr) Flags = m_EvaluationFlags.data();
+  double* Scales = m_EvaluationValues.data() + 2*N;
+  int* EvaluationSlots = m_EvaluationSlots.data();
+
+  bool UseTemperatures = (m_TemperatureEnabled == true && PreampTemperatures != nullptr);
+  bool HasTables = (m_EnergyPolynomials.GetNSlots() > 0);
+
+  // Which calibrations each strip hit has
+  for (unsigned int i = 0; i < N; ++i) {
+    int Slot = Slots[i];
+    unsigned char Flag = c_CalibrationOK;
+    if (m_EnergyPolynomials.HasPolynomial(Slot) == false) {
+      Flag = c_NoEnergyCalibration;
+    } else {
+      if (UseTemperatures == true && m_TemperaturePolynomials.HasPolynomial(Slot) == false) {
+        Flag |= c_NoTemperatureCalibration;
+      }
+      if (m_ResolutionPolynomials.HasPolynomial(Slot) == false) {
+        Flag |= c_NoResolutionCalibration;
+      }
+    }
+    Flags[i] = Flag;
+    EvaluationSlots[i] = (Slot >= 0) ? Slot : 0;
+  }
+
+  // Without any calibration there is nothing to evaluate
+  if (HasTables == false) {
+    for (unsigned int i = 0; i < N; ++i) {
+      CorrectedADCs[i] = ADCs[i];
+      Energies[i] = 0;
+      EnergyResolutions[i] = 0;
+    }
+    return;
+  }
+
+  // Temperature correction
+  if (UseTemperatures == true) {
+    m_TemperaturePolynomials.Evaluate(EvaluationSlots, PreampTemperatures, Scales, N);
+    for (unsigned int i = 0; i < N; ++i) {
+      CorrectedADCs[i] = ((Flags[i] & (c_NoEnergyCalibration | c_NoTemperatureCalibration)) == 0) ? ADCs[i]/Scales[i] : ADCs[i];
+    }
+  } else if (CorrectedADCs != ADCs) {
+    copy(ADCs, ADCs + N, CorrectedADCs);
+  }
+
+  // Energy
+  m_EnergyPolynomials.Evaluate(EvaluationSlots, CorrectedADCs, Energies, N);
+  for (unsigned int i = 0; i < N; ++i) {
+    if ((Flags[i] & c_NoEnergyCalibration) != 0) {
+      Energies[i] = 0;
+    } else if (Energies[i] < 0) {
+      if (CorrectedADCs[i] > 100) Flags[i] |= c_NegativeEnergy;
+      Energies[i] = 0;
+    }
+  }
+
+  // Energy resolution
+  m_ResolutionPolynomials.Evaluate(EvaluationSlots, Energies, EnergyResolutions, N);
+  for (unsigned int i = 0; i < N; ++i) {
+    if ((Flags[i] & (c_NoEnergyCalibration | c_NoResolutionCalibration)) != 0) EnergyResolutions[i] = 0;
+  }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////////
+
+
 double MModuleEnergyCalibrationUniversal::GetEnergy(MReadOutElementDoubleStrip R, double ADC){
 	
-  TF1* Fit = m_Calibration[R];
+  int Slot = m_EnergyPolynomials.GetSlot(R);
   double Energy;
-  if (Fit == 0){ Energy = 0; }
+  if (m_EnergyPolynomials.HasPolynomial(Slot) == false){ Energy = 0; }
   else {
-    Energy = Fit->Eval(ADC);
+    Energy = m_EnergyPolynomials.Evaluate(Slot, ADC);
     if (Energy < 0 && ADC > 100) {
       Energy = 0;
     } else if (Energy < 0) {
@@ -428,12 +499,12 @@ double MModuleEnergyCalibrationUniversal::GetEnergy(MReadOutElementDoubleStrip R
 
 double MModuleEnergyCalibrationUniversal::GetADC(MReadOutElementDoubleStrip R, double energy){
 
-  TF1* Fit = m_Calibration[R];
+  int Slot = m_EnergyPolynomials.GetSlot(R);
 
   double ADC;
-  if (Fit == 0){ ADC = 0; }
+  if (m_EnergyPolynomials.HasPolynomial(Slot) == false){ ADC = 0; }
   else{
-    ADC = Fit->GetX(energy);
+    ADC = m_EnergyPolynomials.Invert(Slot, energy);
   }
 
   return ADC;
@@ -449,10 +520,6 @@ void MModuleEnergyCalibrationUniversal::Finalize()
 
   MModule::Finalize();
 
-  for (auto& F: m_Calibration) delete F.second;
-  for (auto& F: m_ResolutionCalibration) delete F.second;
-  for (auto& F: m_TemperatureCalibration) delete F.second;
-
   return;
 }
 
@@ -514,13 +581,12 @@ MXmlNode* MModuleEnergyCalibrationUniversal::CreateXmlConfiguration()
 /////////////////////////////////////////////////////////////////////////////////
 
 double MModuleEnergyCalibrationUniversal::LookupEnergyResolution(MStripHit* SH, double Energy){
-    MReadOutElementDoubleStrip R = *dynamic_cast<MReadOutElementDoubleStrip*>(SH->GetReadOutElement());
-	 TF1* FitRes = m_ResolutionCalibration[R];
-	 if( FitRes == 0 ){
+	 int Slot = m_ResolutionPolynomials.GetSlot(SH->GetDetectorID(), SH->IsPositiveStrip(), SH->GetStripID());
+	 if( m_ResolutionPolynomials.HasPolynomial(Slot) == false ){
 		 cout << "::LookupEnergyResolution: couldn't locate energy resolution" << endl;
 		 return -1.0;
 	 } else {
-		 double EnergyResolution = FitRes->Eval(Energy);
+		 double EnergyResolution = m_ResolutionPolynomials.Evaluate(Slot, Energy);
 		 return EnergyResolution;
 	 }
 }
@@ -53,7 +53,7 @@ MModuleEventSaver::MModuleEventSaver() : MModule()
   // Set all module relevant information
 
   // Set the module name --- has to be unique
-  m_Name = "Save events (roa, dat, or evta format)";
+  m_Name = "Save events (roa, dat, evta, or binary format)";
 
   // Set the XML tag --- has to be unique --- no spaces allowed
   m_XmlTag = "XmlTagEventSaver";
@@ -81,6 +81,9 @@ MModuleEventSaver::MModuleEventSaver() : MModule()
   m_SplitFileTime.Set(60*10); // seconds
   m_SubFileStart.Set(0);
   
+  m_AsynchronousWriting = true;
+  m_NumberOfCompressionThreads = 2;
+  
   // Allow the use of multiple threads and instances
   m_AllowMultiThreading = true;
   m_AllowMultipleInstances = false;
@@ -98,6 +101,7 @@ MModuleEventSaver::~MModuleEventSaver()
   // Destructor
   
   m_Out.Close();
+  m_SubFileOut.Close();
 }
 
 
@@ -121,7 +125,7 @@ bool MModuleEventSaver::Initialize()
   MString Suffix = m_InternalFileName;
   if (Suffix.Last('.') != MString::npos) {
     Suffix.RemoveInPlace(0, Suffix.Last('.'));
-    if (Suffix == ".dat" || Suffix == ".roa" || Suffix == ".evta") {
+    if (Suffix == ".dat" || Suffix == ".roa" || Suffix == ".evta" || Suffix == ".bev") {
       m_InternalFileName.RemoveInPlace(m_InternalFileName.Last('.'));
     }
   }
@@ -139,6 +143,8 @@ bool MModuleEventSaver::Initialize()
     m_InternalFileName += ".evta";
   } else if (m_Mode == c_RoaFile) {
     m_InternalFileName += ".roa";
+  } else if (m_Mode == c_BinaryFile) {
+    m_InternalFileName += ".bev";
   } else {
     if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unsupported mode: "<<m_Mode<<endl;
     return false;
@@ -148,9 +154,27 @@ bool MModuleEventSaver::Initialize()
     m_InternalFileName += ".gz";
   }
   
+  // The binary format has its own file header and is not split into sub-files
+  if (m_Mode == c_BinaryFile) {
+    if (m_SplitFile == true) {
+      if (g_Verbosity >= c_Warning) cout<<m_XmlTag<<": Binary event files are not split"<<endl;
+    }
+    if (OpenFile(m_Out, m_InternalFileName) == false) {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unable to open file: "<<m_InternalFileName<<endl;
+      return false;
+    }
+    m_BinaryBlock.Clear();
+    m_BinaryBuffer.clear();
+    MBinaryEventBlock::WriteFileHeader(m_BinaryBuffer);
+    if (m_Out.Write(m_BinaryBuffer) == false) {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unable to write to file: "<<m_InternalFileName<<endl;
+      return false;
+    }
+    
+    return MModule::Initialize();
+  }
   
-  m_Out.Open(m_InternalFileName, MFile::c_Write);
-  if (m_Out.IsOpen() == false) {
+  if (OpenFile(m_Out, m_InternalFileName) == false) {
     if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unable to open file: "<<m_InternalFileName<<endl;
     return false;
   }
@@ -199,8 +223,10 @@ bool MModuleEventSaver::StartSubFile()
   //! Start a new sub-file
 
   if (m_SubFileOut.IsOpen() == true) {
-    m_SubFileOut.Write("EN");
-    m_SubFileOut.Close();
+    m_SubFileOut.Write(MString("EN"));
+    if (m_SubFileOut.Close() == false) {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unable to write all events to the sub-file"<<endl;
+    }
   }
   
   MString SubName = m_InternalFileName;
@@ -232,8 +258,7 @@ bool MModuleEventSaver::StartSubFile()
     SubName += ".gz";
   }
   
-  m_SubFileOut.Open(SubName, MFile::c_Write);
-  if (m_SubFileOut.IsOpen() == false) {
+  if (OpenFile(m_SubFileOut, SubName) == false) {
     if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unable to open file: "<<SubName<<endl;
     return false;
   }
@@ -242,9 +267,43 @@ bool MModuleEventSaver::StartSubFile()
   if (SubName.Last('/') != MString::npos) {
     SubName.RemoveInPlace(0, SubName.Last('/')+1); 
   }
-  m_Out.Write("IN ");
-  m_Out.Write(SubName);
-  m_Out.Write('\n');
+  m_Out.Write(MString("IN ") + SubName + "\n");
+  
+  return true;
+}
+  
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleEventSaver::OpenFile(MBinaryFileWriter& File, MString FileName)
+{
+  //! Open an output file with the current writing options
+  
+  MFile::ExpandFileName(FileName);
+  
+  File.SetAsynchronous(m_AsynchronousWriting);
+  File.SetNumberOfCompressionThreads(m_NumberOfCompressionThreads);
+  
+  return File.Open(FileName);
+}
+  
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleEventSaver::WriteBinaryBlock()
+{
+  //! Write the collected events as one block to the binary file
+
+  m_BinaryBuffer.clear();
+  m_BinaryBlock.Write(m_BinaryBuffer);
+  m_BinaryBlock.Clear();
+  
+  if (m_Out.Write(m_BinaryBuffer) == false) {
+    if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unable to write to file: "<<m_InternalFileName<<endl;
+    return false;
+  }
   
   return true;
 }
@@ -259,18 +318,33 @@ void MModuleEventSaver::Finalize()
 
   MModule::Finalize();
   
+  if (m_Mode == c_BinaryFile) {
+    if (m_Out.IsOpen() == true) {
+      // The last events, and the empty block which ends the file
+      if (m_BinaryBlock.GetNEvents() > 0) WriteBinaryBlock();
+      WriteBinaryBlock();
+      if (m_Out.Close() == false) {
+        if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unable to write all events to file: "<<m_InternalFileName<<endl;
+      }
+    }
+    return;
+  }
+  
   if (m_SubFileOut.IsOpen() == true) {
-    m_SubFileOut.Write("EN\n");
-    m_SubFileOut.Close();
+    m_SubFileOut.Write(MString("EN\n"));
+    if (m_SubFileOut.Close() == false) {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unable to write all events to the sub-file"<<endl;
+    }
   }
 
-  m_Out.WriteLine("EN");
-  m_Out.WriteLine();
+  m_Out.Write(MString("EN\n\n"));
   if (m_NumberOfSimulatedEvents > 0) {
-    m_Out.WriteLine(MString("TS ") + m_NumberOfSimulatedEvents);
+    m_Out.Write(MString("TS ") + m_NumberOfSimulatedEvents + "\n");
+  }
+  m_Out.Write(MString("\n"));
+  if (m_Out.Close() == false) {
+    if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unable to write all events to file: "<<m_InternalFileName<<endl;
   }
-  m_Out.WriteLine();
-  m_Out.Close();
   
   
   return;
@@ -288,7 +362,19 @@ bool MModuleEventSaver::AnalyzeEvent(MReadOutAssembly* Event)
     if (Event->IsBad() == true) return true;
   }
 
-  MFile* Choosen = 0; // Wish C++ would allow unassigned references...
+  if (m_Mode == c_BinaryFile) {
+    Event->StreamBinary(m_BinaryBlock);
+    if (m_BinaryBlock.GetNEvents() >= c_BinaryEventsPerBlock) {
+      if (WriteBinaryBlock() == false) {
+        m_IsOK = false;
+        return false;
+      }
+    }
+    Event->SetAnalysisProgress(MAssembly::c_EventSaver);
+    return true;
+  }
+  
+  MBinaryFileWriter* Choosen = 0; // Wish C++ would allow unassigned references...
   if (m_SplitFile == true) {
     MTime Current = Event->GetTime();
     if (Current > m_SubFileStart + m_SplitFileTime) {
@@ -303,15 +389,21 @@ bool MModuleEventSaver::AnalyzeEvent(MReadOutAssembly* Event)
     Choosen = &m_Out; 
   }
   
-  ostringstream Out;
+  // Each event starts with the precision of a new stream
+  m_EventBuffer.Clear();
+  m_EventBuffer.SetPrecision(6);
   if (m_Mode == c_EvtaFile) {
-    Event->StreamEvta(Out);
+    Event->StreamEvta(m_EventBuffer);
   } else if (m_Mode == c_DatFile) {
-    Event->StreamDat(Out, 1);    
+    Event->StreamDat(m_EventBuffer, 1);    
   } else if (m_Mode == c_RoaFile) {
-    Event->StreamRoa(Out);
+    Event->StreamRoa(m_EventBuffer);
+  }
+  if (Choosen->Write(m_EventBuffer.GetString()) == false) {
+    if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unable to write to file: "<<m_InternalFileName<<endl;
+    m_IsOK = false;
+    return false;
   }
-  Choosen->Write(Out);
   
   Event->SetAnalysisProgress(MAssembly::c_EventSaver);
 
@@ -363,6 +455,14 @@ bool MModuleEventSaver::ReadXmlConfiguration(MXmlNode* Node)
   if (SplitFileTimeNode != 0) {
     m_SplitFileTime.Set(SplitFileTimeNode->GetValueAsInt());
   }
+  MXmlNode* AsynchronousWritingNode = Node->GetNode("AsynchronousWriting");
+  if (AsynchronousWritingNode != 0) {
+    m_AsynchronousWriting = AsynchronousWritingNode->GetValueAsBoolean();
+  }
+  MXmlNode* NumberOfCompressionThreadsNode = Node->GetNode("NumberOfCompressionThreads");
+  if (NumberOfCompressionThreadsNode != 0) {
+    SetNumberOfCompressionThreads(NumberOfCompressionThreadsNode->GetValueAsUnsignedInt());
+  }
 
   return true;
 }
@@ -382,6 +482,8 @@ MXmlNode* MModuleEventSaver::CreateXmlConfiguration()
   new MXmlNode(Node, "AddTimeTag", m_AddTimeTag);
   new MXmlNode(Node, "SplitFile", m_SplitFile);
   new MXmlNode(Node, "SplitFileTime", m_SplitFileTime.GetAsSystemSeconds());
+  new MXmlNode(Node, "AsynchronousWriting", m_AsynchronousWriting);
+  new MXmlNode(Node, "NumberOfCompressionThreads", m_NumberOfCompressionThreads);
 
   return Node;
 }
@@ -0,0 +1,334 @@
+/*
+ * MModuleLoaderBinaryEvents.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MModuleLoaderBinaryEvents
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MModuleLoaderBinaryEvents.h"
+
+// Standard libs:
+
+// ROOT libs:
+#include "TGClient.h"
+
+// MEGAlib libs:
+#include "MGUIOptionsLoaderBinaryEvents.h"
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MModuleLoaderBinaryEvents)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MModuleLoaderBinaryEvents::MModuleLoaderBinaryEvents() : MModuleLoaderMeasurements()
+{
+  // Construct an instance of MModuleLoaderBinaryEvents
+  
+  // Set all module relevant information
+  
+  // Set the module name --- has to be unique
+  m_Name = "Loader for binary event files (checkpoints)";
+  
+  // Set the XML tag --- has to be unique --- no spaces allowed
+  m_XmlTag = "XmlTagLoaderBinaryEvents";
+  
+  // The events keep their analysis progress, thus we stand in for the modules done before the checkpoint
+  m_CheckpointStage = c_CheckpointAfterStripPairing;
+  SetCheckpointModuleTypes();
+  
+  // This is a special start module which can generate its own events
+  m_IsStartModule = true;
+  
+  // Allow the use of multiple threads and instances
+  m_AllowMultiThreading = true;
+  m_AllowMultipleInstances = false;
+  
+  m_BufferPosition = 0;
+  m_IsEndOfFile = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleLoaderBinaryEvents::SetCheckpointStage(unsigned int CheckpointStage)
+{
+  // Set the checkpoint stage and the module types which follow from it
+
+  if (CheckpointStage != c_CheckpointAfterDetectorEffectsEngine && CheckpointStage != c_CheckpointAfterStripPairing) {
+    if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unknown checkpoint stage: "<<CheckpointStage<<" - using after strip pairing"<<endl;
+    CheckpointStage = c_CheckpointAfterStripPairing;
+  }
+  m_CheckpointStage = CheckpointStage;
+  SetCheckpointModuleTypes();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleLoaderBinaryEvents::SetCheckpointModuleTypes()
+{
+  // The module types of a measurement loader, and those of the modules done before the checkpoint
+
+  m_ModuleTypes.clear();
+  AddModuleType(MAssembly::c_EventLoader);
+  AddModuleType(MAssembly::c_EventLoaderMeasurement);
+  AddModuleType(MAssembly::c_EventOrdering);
+  AddModuleType(MAssembly::c_Aspect);
+  AddModuleType(MAssembly::c_DetectorEffectsEngine);
+  if (m_CheckpointStage == c_CheckpointAfterStripPairing) {
+    AddModuleType(MAssembly::c_EnergyCalibration);
+    AddModuleType(MAssembly::c_StripPairing);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MModuleLoaderBinaryEvents::~MModuleLoaderBinaryEvents()
+{
+  // Delete this instance of MModuleLoaderBinaryEvents
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleLoaderBinaryEvents::Initialize()
+{
+  // Initialize the module 
+  
+  if (Open(m_FileName, c_Read) == false) return false;
+  
+  m_NEventsInFile = 0;
+  m_NGoodEventsInFile = 0;
+    
+  return MModule::Initialize();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleLoaderBinaryEvents::AnalyzeEvent(MReadOutAssembly* Event) 
+{
+  // Main data analysis routine, which updates the event to a new level:
+  // Here: Just read it.
+  
+  while (Event->ParseBinary(m_Block) == false) {
+    if (m_IsEndOfFile == true || ReadNextBlock() == false) {
+      cout<<"MModuleLoaderBinaryEvents: No more events!"<<endl;
+      m_IsFinished = true;
+      return false;
+    }
+  }
+  
+  m_NEventsInFile++;
+  if (Event->IsBad() == false) m_NGoodEventsInFile++;
+  
+  // The events must have been saved at the configured checkpoint, otherwise modules would be skipped or done twice
+  bool IsPaired = Event->HasAnalysisProgress(MAssembly::c_EnergyCalibration | MAssembly::c_StripPairing);
+  bool IsCalibratedOrPaired = Event->HasAnalysisProgress(MAssembly::c_EnergyCalibration) || Event->HasAnalysisProgress(MAssembly::c_StripPairing);
+  if ((m_CheckpointStage == c_CheckpointAfterStripPairing && IsPaired == false) ||
+      (m_CheckpointStage == c_CheckpointAfterDetectorEffectsEngine && IsCalibratedOrPaired == true)) {
+    if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: Event "<<Event->GetID()<<" has not been saved "
+                                    <<(m_CheckpointStage == c_CheckpointAfterStripPairing ? "after the strip pairing" : "before the energy calibration")
+                                    <<" as configured - choose the checkpoint stage of the file"<<endl;
+    m_IsOK = false;
+    m_IsFinished = true;
+    return false;
+  }
+  
+  Event->SetAnalysisProgress(MAssembly::c_EventLoader | MAssembly::c_EventLoaderMeasurement);
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleLoaderBinaryEvents::Finalize()
+{
+  // Initialize the module 
+  
+  MModule::Finalize();
+  
+  cout<<"MModuleLoaderBinaryEvents: "<<endl;
+  cout<<"  * all events on file: "<<m_NEventsInFile<<endl;
+  cout<<"  * good events on file: "<<m_NGoodEventsInFile<<endl;
+
+  m_Reader.Close();
+  m_Buffer.clear();
+  m_BufferPosition = 0;
+  m_Block.Clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleLoaderBinaryEvents::Open(MString FileName, unsigned int Way)
+{
+  // Open the file and check its header
+  
+  m_Buffer.clear();
+  m_BufferPosition = 0;
+  m_Block.Clear();
+  m_IsEndOfFile = false;
+  
+  if (m_Reader.Open(FileName) == false) {
+    if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unable to open file: "<<FileName<<endl;
+    return false;
+  }
+  
+  while (m_Buffer.size() < MBinaryEventBlock::GetFileHeaderLength()) {
+    if (FillBuffer() == false) break;
+  }
+  if (MBinaryEventBlock::CheckFileHeader(m_Buffer.data(), m_Buffer.size()) == false) {
+    if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Not a binary event file: "<<FileName<<endl;
+    m_Reader.Close();
+    return false;
+  }
+  m_BufferPosition = MBinaryEventBlock::GetFileHeaderLength();
+  
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleLoaderBinaryEvents::FillBuffer()
+{
+  // Append the next data of the file to the buffer - the parsed data is removed first
+  
+  if (m_BufferPosition > 0) {
+    m_Buffer.erase(m_Buffer.begin(), m_Buffer.begin() + m_BufferPosition);
+    m_BufferPosition = 0;
+  }
+  
+  if (m_Reader.Read(m_ReadBuffer) == false) return false;
+  m_Buffer.insert(m_Buffer.end(), m_ReadBuffer.begin(), m_ReadBuffer.end());
+  
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleLoaderBinaryEvents::ReadNextBlock()
+{
+  // Read the next block of events - a block without events ends the file
+  
+  size_t BlockLength = 0;
+  while (true) {
+    const uint8_t* Data = m_Buffer.data() + m_BufferPosition;
+    size_t Length = m_Buffer.size() - m_BufferPosition;
+    if (MBinaryEventBlock::GetBlockLength(Data, Length, BlockLength) == false) {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": The file is corrupt: "<<m_FileName<<endl;
+      return false;
+    }
+    if (BlockLength > 0 && BlockLength <= Length) break;
+    
+    if (FillBuffer() == false) {
+      if (m_Reader.HasError() == true) {
+        if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Unable to read the file: "<<m_FileName<<endl;
+      } else {
+        if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": The file is truncated: "<<m_FileName<<endl;
+      }
+      return false;
+    }
+  }
+  
+  if (m_Block.Read(m_Buffer.data() + m_BufferPosition, BlockLength) == false) {
+    if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": The file is corrupt: "<<m_FileName<<endl;
+    return false;
+  }
+  m_BufferPosition += BlockLength;
+  
+  if (m_Block.GetNEvents() == 0) m_IsEndOfFile = true;
+  
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleLoaderBinaryEvents::ShowOptionsGUI()
+{
+  //! Show the options GUI
+
+  MGUIOptionsLoaderBinaryEvents* Options = new MGUIOptionsLoaderBinaryEvents(this);
+  Options->Create();
+  gClient->WaitForUnmap(Options);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleLoaderBinaryEvents::ReadXmlConfiguration(MXmlNode* Node)
+{
+  //! Read the configuration data from an XML node
+  
+  MXmlNode* FileNameNode = Node->GetNode("FileName");
+  if (FileNameNode != 0) {
+    m_FileName = FileNameNode->GetValue();
+  }
+  MXmlNode* CheckpointStageNode = Node->GetNode("CheckpointStage");
+  if (CheckpointStageNode != 0) {
+    SetCheckpointStage(CheckpointStageNode->GetValueAsUnsignedInt());
+  }
+ 
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MXmlNode* MModuleLoaderBinaryEvents::CreateXmlConfiguration() 
+{
+  //! Create an XML node tree from the configuration
+  
+  MXmlNode* Node = new MXmlNode(0, m_XmlTag);  
+  new MXmlNode(Node, "FileName", m_FileName);
+  new MXmlNode(Node, "CheckpointStage", m_CheckpointStage);
+  
+  return Node;
+}
+
+
+// MModuleLoaderBinaryEvents.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -84,10 +84,8 @@ MModuleLoaderMeasurementsBinary::MModuleLoaderMeasurementsBinary() : MModule(),
 
 	m_IgnoreAspect = false; //this was set to true and was causing events to be pushed through the pipeline before aspect info was available for them AWL Sep 20 2016
 	m_FileIsDone = false;
+	m_NumberOfParallelFiles = 1;
   
-  m_IsZipped = false;
-	m_ZipFile = NULL;
-
   m_ExpoAspectViewer = nullptr;
 }
 
@@ -98,6 +96,8 @@ MModuleLoaderMeasurementsBinary::MModuleLoaderMeasurementsBinary() : MModule(),
 MModuleLoaderMeasurementsBinary::~MModuleLoaderMeasurementsBinary()
 {
 	// Delete this instance of MModuleLoaderMeasurementsBinary
+
+	StopDecoders();
 }
 
 
@@ -127,32 +127,71 @@ bool MModuleLoaderMeasurementsBinary::OpenNextFile()
   ++m_OpenFileID;
   if (m_OpenFileID >= (int) m_BinaryFileNames.size()) return false;
 
-  m_IsZipped = m_BinaryFileNames[m_OpenFileID].EndsWith(".gz");
+  // The parser might still point into the memory mapped previous file
+  DetachExternalData();
+
+  // The reader decompresses gzip'ed files in large blocks on a background thread
+  if (m_Reader.Open(m_BinaryFileNames[m_OpenFileID]) == false) {
+    if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to open file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
+    return false;
+  }
   
-  if (m_IsZipped == false) {
-    if (m_In.is_open()) m_In.close();
-    m_In.clear();
+  if (g_Verbosity >= c_Info) cout<<m_XmlTag<<": Opened file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
   
-    m_In.open(m_BinaryFileNames[m_OpenFileID], ios::binary);
-    if (m_In.is_open() == false) {
-      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to open file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
-      return false;
-    }
-  } else {
-    if (m_ZipFile != NULL) gzclose(m_ZipFile);
-    
-    m_ZipFile = gzopen(m_BinaryFileNames[m_OpenFileID], "rb");
-    if (m_ZipFile == NULL) {
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MModuleLoaderMeasurementsBinary::StartDecoders()
+{
+  //! Start decoding the next files until the maximum number of files is decoded in parallel
+
+  while (m_Decoders.size() < m_NumberOfParallelFiles && m_OpenFileID + 1 < (int) m_BinaryFileNames.size()) {
+    ++m_OpenFileID;
+
+    // Each file is decoded with its own parser on its own thread
+    MBinaryFileDecoder* Decoder = new MBinaryFileDecoder();
+    Decoder->SetDataSelectionMode(m_DataSelectionMode);
+    Decoder->SetUseMemoryMapping(GetUseMemoryMapping());
+    if (Decoder->Start(m_BinaryFileNames[m_OpenFileID]) == false) {
       if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to open file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
+      delete Decoder;
+      // As when reading one file after the other, we stop at this file
+      m_OpenFileID = m_BinaryFileNames.size();
       return false;
     }
+    m_Decoders.push_back(Decoder);
+
+    if (g_Verbosity >= c_Info) cout<<m_XmlTag<<": Started decoding file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
   }
-  
-  if (g_Verbosity >= c_Info) cout<<m_XmlTag<<": Opened file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
-  
+
   return true;
 }
 
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleLoaderMeasurementsBinary::StopDecoders()
+{
+  //! Stop all decoders
+
+  for (auto D: m_Decoders) {
+    delete D;
+  }
+  m_Decoders.clear();
+
+  for (auto& Frame: m_CurrentBlock.Frames) {
+    for (auto E: Frame.Events) {
+      delete E;
+    }
+  }
+  m_CurrentBlock.Frames.clear();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 
@@ -164,8 +203,9 @@ bool MModuleLoaderMeasurementsBinary::Initialize()
   m_BinaryFileNames.clear();
   m_OpenFileID = -1;
 
-	if (m_In.is_open()) m_In.close();
-  m_In.clear();
+	DetachExternalData();
+	m_Reader.Close();
+	StopDecoders();
   
   // First check if we can read is as text file, look for "TYPE" or "IN" in the first 10 lines
   ifstream in;
@@ -209,7 +249,14 @@ bool MModuleLoaderMeasurementsBinary::Initialize()
     m_BinaryFileNames.push_back(m_FileName);
   }
   
-  if (OpenNextFile() == false) {
+  if (m_NumberOfParallelFiles > 1 && m_BinaryFileNames.size() > 1) {
+    // The files are decoded in parallel, and the main parser continues with the decoded blocks in file order
+    if (StartDecoders() == false) {
+      if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to start decoding the files"<<endl;
+      StopDecoders();
+      return false;
+    }
+  } else if (OpenNextFile() == false) {
     if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to open the file \""<<m_BinaryFileNames[m_OpenFileID]<<"\""<<endl;
     return false;
   }
@@ -254,49 +301,50 @@ bool MModuleLoaderMeasurementsBinary::IsReady()
 
 	//AWL restructured this so that we don't allocate/fill a 1MB array when there is nothing to read.  
 
-	vector<char> Stream;
-	unsigned int Size = 1000000;
-	streamsize Read;
-	if (m_FileIsDone == true) {
-		Read = 0;
-	} else {
-		Stream.reserve(Size);
-    if (m_IsZipped == false) {
-      m_In.read(&Stream[0], Size);
-      Read = m_In.gcount();
-    } else {
-      Read = 0;
-      for (unsigned int i = 0; i < Size; ++i) {
-        int c = gzgetc(m_ZipFile);
-        if (c == -1) {
-          break;
-        }
-        Stream[i] = (char) c;
-        Read = i+1;
-      }
-    }
+	if (m_Decoders.size() > 0) {
+		// The files are decoded in parallel: continue with the next block in file order
+		bool HasBlock = false;
+		while (m_Decoders.size() > 0) {
+			if (m_Decoders.front()->Next(m_CurrentBlock) == true) {
+				HasBlock = true;
+				break;
+			}
+			if (m_Decoders.front()->HasError() == true) {
+				if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to read file \""<<m_Decoders.front()->GetFileName()<<"\" - skipping the rest of it"<<endl;
+			}
+			delete m_Decoders.front();
+			m_Decoders.pop_front();
+			StartDecoders();
+		}
+
+		if (HasBlock == false) {
+			m_FileIsDone = true;
+			SetIsDone(true);
+			if (m_EventsBuf.IsEmpty() == true) {
+				m_IsFinished = true;
+			}
+			return ParseData(NULL, 0, false);
+		}
+
+		// The coincidence search continues across the file boundaries, since all blocks end up in our events buffer
+		return ParseDecodedBlock(m_CurrentBlock);
 	}
 
-	// If we do not read anything, try again with the next file
-  if (Read == 0) {
-    if (OpenNextFile() == true) {
-      Stream.reserve(Size);
-      if (m_IsZipped == false) {
-        m_In.read(&Stream[0], Size);
-        Read = m_In.gcount();
-      } else {
-        Read = 0;
-        for (unsigned int i = 0; i < Size; ++i) {
-          int c = gzgetc(m_ZipFile);
-          if (c == -1) {
-            break;
-          }
-          Stream[i] = (char) c;
-          Read = i+1;
-        }
-      }  
-    }
-  }
+	// The reader returns the file in blocks of about 1 MB - memory mapped files without any copy
+	const uint8_t* Data = NULL;
+	size_t Read = 0;
+	if (m_FileIsDone == false) {
+		// If we do not read anything, try again with the next file
+		while (m_Reader.ReadSpan(Data, Read) == false) {
+			if (m_Reader.HasError() == true) {
+				if (g_Verbosity >= c_Error) cout<<m_XmlTag<<": Error: unable to read file \""<<m_BinaryFileNames[m_OpenFileID]<<"\" - skipping the rest of it"<<endl;
+			}
+			if (OpenNextFile() == false) {
+				Read = 0;
+				break;
+			}
+		}
+	}
 
 	/*
 		if (Read < Size) {
@@ -317,21 +365,15 @@ bool MModuleLoaderMeasurementsBinary::IsReady()
 	}
 
 
-	if (m_FileIsDone  == true && m_EventsBuf.size() == 0) {
+	if (m_FileIsDone  == true && m_EventsBuf.IsEmpty() == true) {
 		//m_IsOK = false;
 		m_IsFinished = true;
 	}
 
-	vector<uint8_t> Received(Read);
-	for (unsigned int i = 0; i < Read; ++i) {
-		// cout << "char: " << Received[i] << endl;
-		//	 printf("char:%02X\n",(uint8_t)Stream[i]);
-		Received[i] = (uint8_t) Stream[i];
-	}
-
-	//cout<<"Received: "<<Received.size()<<endl;
+	//cout<<"Received: "<<Read<<endl;
 	
-	return ParseData(Received);
+	// A memory mapped file stays valid until we open the next one, thus the parser can work on it in place
+	return ParseData(Data, Read, m_Reader.IsMapped());
 }
 
 
@@ -391,21 +433,12 @@ bool MModuleLoaderMeasurementsBinary::AnalyzeEvent(MReadOutAssembly* Event)
 
 	// This checks if the event's aspect data was within the range of the retrieved aspect info
 	if (NewEvent->GetAspect() != 0 && NewEvent->GetAspect()->GetOutOfRange()) {
-		delete NewEvent;
+		ReleaseAssembly(NewEvent);
 		return false;
 	}
 
-	//transfer over strip hits that have ADC
-	while (NewEvent->GetNStripHits() > 0) {
-		Event->AddStripHit( NewEvent->GetStripHit(0) );
-		NewEvent->RemoveStripHit(0);
-	}
-
-	//transfer over strip hits that have timing and no ADC
-	while (NewEvent->GetNStripHitsTOnly() > 0){
-		Event->AddStripHitTOnly( NewEvent->GetStripHitTOnly(0));
-		NewEvent->RemoveStripHitTOnly(0);
-	}
+	//transfer over strip hits that have ADC and strip hits that have timing and no ADC
+	Event->StealStripHits(NewEvent);
 
 
 	Event->SetID( NewEvent->GetID() );
@@ -440,7 +473,7 @@ bool MModuleLoaderMeasurementsBinary::AnalyzeEvent(MReadOutAssembly* Event)
 		Event->SetTimeIncomplete(true);
 	}
 
-	delete NewEvent;
+	ReleaseAssembly(NewEvent);
 
 	return true;
 }
@@ -456,8 +489,9 @@ void MModuleLoaderMeasurementsBinary::Finalize()
 	MModule::Finalize();
 	MBinaryFlightDataParser::Finalize();
 
-	m_In.close();
-	m_In.clear();
+	DetachExternalData();
+	m_Reader.Close();
+	StopDecoders();
 
 	return;
 }
@@ -503,6 +537,21 @@ bool MModuleLoaderMeasurementsBinary::ReadXmlConfiguration(MXmlNode* Node)
 		m_CoincidenceEnabled = (bool) CoincidenceMergingNode->GetValueAsInt();
 	}
 
+	MXmlNode* UseMemoryMappingNode = Node->GetNode("UseMemoryMapping");
+	if( UseMemoryMappingNode != NULL ){
+		SetUseMemoryMapping(UseMemoryMappingNode->GetValueAsBoolean());
+	}
+
+	MXmlNode* NumberOfParallelFilesNode = Node->GetNode("NumberOfParallelFiles");
+	if( NumberOfParallelFilesNode != NULL ){
+		SetNumberOfParallelFiles(NumberOfParallelFilesNode->GetValueAsUnsignedInt());
+	}
+
+	MXmlNode* NumberOfDecodingThreadsNode = Node->GetNode("NumberOfDecodingThreads");
+	if( NumberOfDecodingThreadsNode != NULL ){
+		SetNumberOfDecodingThreads(NumberOfDecodingThreadsNode->GetValueAsUnsignedInt());
+	}
+
 
 	return true;
 }
@@ -520,6 +569,9 @@ MXmlNode* MModuleLoaderMeasurementsBinary::CreateXmlConfiguration()
 	new MXmlNode(Node, "DataSelectionMode", (unsigned int) m_DataSelectionMode);
 	new MXmlNode(Node, "AspectSelectionMode", (unsigned int) m_AspectMode);
 	new MXmlNode(Node, "CoincidenceMerging",(unsigned int) m_CoincidenceEnabled);
+	new MXmlNode(Node, "UseMemoryMapping", GetUseMemoryMapping());
+	new MXmlNode(Node, "NumberOfParallelFiles", m_NumberOfParallelFiles);
+	new MXmlNode(Node, "NumberOfDecodingThreads", GetNumberOfDecodingThreads());
 
 	return Node;
 }
@@ -51,7 +51,7 @@ ClassImp(MModuleLoaderMeasurementsROA)
 ////////////////////////////////////////////////////////////////////////////////
 
 
-MModuleLoaderMeasurementsROA::MModuleLoaderMeasurementsROA() : MModuleLoaderMeasurements()
+MModuleLoaderMeasurementsROA::MModuleLoaderMeasurementsROA() : MModuleLoaderMeasurements(), m_IsEndOfFile(false), m_StopReader(false)
 {
   // Construct an instance of MModuleLoaderMeasurementsROA
   
@@ -78,6 +78,10 @@ MModuleLoaderMeasurementsROA::MModuleLoaderMeasurementsROA() : MModuleLoaderMeas
 MModuleLoaderMeasurementsROA::~MModuleLoaderMeasurementsROA()
 {
   // Delete this instance of MModuleLoaderMeasurementsROA
+
+  StopReader();
+
+  for (MReadOutAssembly* Event: m_AssemblyPool) delete Event;
 }
 
 
@@ -89,6 +93,7 @@ bool MModuleLoaderMeasurementsROA::Initialize()
   // Initialize the module 
   
   // Clean:
+  StopReader();
   m_FileType = "Unknown";
   m_Detector = "Unknown";
   m_Version = -1;
@@ -101,6 +106,8 @@ bool MModuleLoaderMeasurementsROA::Initialize()
   
   m_NEventsInFile = 0;
   m_NGoodEventsInFile = 0;
+  
+  StartReader();
     
   return MModule::Initialize();
 }
@@ -109,16 +116,53 @@ bool MModuleLoaderMeasurementsROA::Initialize()
 ////////////////////////////////////////////////////////////////////////////////
 
 
+bool MModuleLoaderMeasurementsROA::IsReady() 
+{
+  // Return true if an event has been read ahead, or if the end of the file has been reached
+  
+  lock_guard<mutex> Lock(m_Mutex);
+  return m_Events.size() > 0 || m_IsEndOfFile == true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 bool MModuleLoaderMeasurementsROA::AnalyzeEvent(MReadOutAssembly* Event) 
 {
   // Main data analysis routine, which updates the event to a new level:
-  // Here: Just read it.
-    
-  if (ReadNextEvent(Event) == false) {
+  // Here: Just take the next event, which the reader thread has read.
+  
+  MReadOutAssembly* NewEvent = nullptr;
+  {
+    unique_lock<mutex> Lock(m_Mutex);
+    m_EventAvailable.wait(Lock, [this] { return m_Events.size() > 0 || m_IsEndOfFile == true; });
+    if (m_Events.size() > 0) {
+      NewEvent = m_Events.front();
+      m_Events.pop_front();
+    }
+  }
+  
+  if (NewEvent == nullptr) {
+    cout<<m_Name<<": No more read-outs available in File"<<endl;
     cout<<"MModuleLoaderMeasurementsROA: No more events!"<<endl;
     m_IsFinished = true;
     return false;
   }
+  m_SpaceAvailable.notify_one();
+  
+  m_NEventsInFile++;
+  m_NGoodEventsInFile++;
+  
+  // The read-outs themselves stay with the recycled assembly, only the strip hits are handed on
+  Event->Clear();
+  Event->SetID(NewEvent->GetID());
+  Event->SetTime(NewEvent->GetTime());
+  Event->SetTimeUTC(NewEvent->GetTimeUTC());
+  Event->StealStripHits(NewEvent);
+  Event->StealSimIAs(NewEvent);
+  
+  ReleaseAssembly(NewEvent);
   
   Event->SetAnalysisProgress(MAssembly::c_EventLoader | MAssembly::c_EventLoaderMeasurement);
 
@@ -135,6 +179,8 @@ void MModuleLoaderMeasurementsROA::Finalize()
   
   MModule::Finalize();
   
+  StopReader();
+  
   cout<<"MModuleLoaderMeasurementsROA: "<<endl;
   cout<<"  * all events on file: "<<m_NEventsInFile<<endl;
   cout<<"  * good events on file: "<<m_NGoodEventsInFile<<endl;
@@ -162,40 +208,43 @@ bool MModuleLoaderMeasurementsROA::Open(MString FileName, unsigned int Way)
 bool MModuleLoaderMeasurementsROA::ReadNextEvent(MReadOutAssembly* Event)
 {
   // Return next single event from file... or 0 if there are no more.
+  // Called by the reader thread
   
   Event->Clear();
 
   m_ROAFile.ReadNext(*Event);
   
   if (Event->GetNumberOfReadOuts() == 0) {
-    cout<<m_Name<<": No more read-outs available in File"<<endl;
     return false;
   }
   
-  m_NEventsInFile++;
-  m_NGoodEventsInFile++;
-
-  
   for (unsigned int r = 0; r < Event->GetNumberOfReadOuts(); ++r) {
-    MReadOut RO = Event->GetReadOut(r);
-    const MReadOutElementDoubleStrip* Strip = 
-      dynamic_cast<const MReadOutElementDoubleStrip*>(&(RO.GetReadOutElement()));
-      
+    const MReadOut& RO = Event->GetReadOut(r);
+    // The read-out files of this module only contain double-sided strip detectors
+    const MReadOutElementDoubleStrip& Strip = 
+      static_cast<const MReadOutElementDoubleStrip&>(RO.GetReadOutElement());
+    
+    // Get() finds the data by its type ID, thus no dynamic_cast is required to identify it
+    const MReadOutData& Data = RO.GetReadOutData();
     const MReadOutDataADCValue* ADC = 
-      dynamic_cast<const MReadOutDataADCValue*>(RO.GetReadOutData().Get(MReadOutDataADCValue::m_TypeID));
+      static_cast<const MReadOutDataADCValue*>(Data.Get(MReadOutDataADCValue::m_TypeID));
     const MReadOutDataTiming* Timing = 
-      dynamic_cast<const MReadOutDataTiming*>(RO.GetReadOutData().Get(MReadOutDataTiming::m_TypeID));
+      static_cast<const MReadOutDataTiming*>(Data.Get(MReadOutDataTiming::m_TypeID));
     const MReadOutDataOrigins* Origins = 
-      dynamic_cast<const MReadOutDataOrigins*>(RO.GetReadOutData().Get(MReadOutDataOrigins::m_TypeID));
+      static_cast<const MReadOutDataOrigins*>(Data.Get(MReadOutDataOrigins::m_TypeID));
     
     
     MStripHit* SH = new MStripHit();
-    SH->SetDetectorID(Strip->GetDetectorID());
-    SH->IsXStrip(Strip->IsPositiveStrip());
-    SH->SetStripID(Strip->GetStripID());
+    SH->SetDetectorID(Strip.GetDetectorID());
+    SH->IsXStrip(Strip.IsPositiveStrip());
+    SH->SetStripID(Strip.GetStripID());
     
-    SH->SetTiming(Timing->GetTiming());
-    SH->SetADCUnits(ADC->GetADCValue());
+    if (Timing != nullptr) {
+      SH->SetTiming(Timing->GetTiming());
+    }
+    if (ADC != nullptr) {
+      SH->SetADCUnits(ADC->GetADCValue());
+    }
     
     if (Origins != nullptr) {
       SH->AddOrigins(Origins->GetOrigins());
@@ -215,6 +264,107 @@ bool MModuleLoaderMeasurementsROA::ReadNextEvent(MReadOutAssembly* Event)
 ////////////////////////////////////////////////////////////////////////////////
 
 
+void MModuleLoaderMeasurementsROA::StartReader()
+{
+  // Start the reader thread
+  
+  StopReader();
+  
+  m_IsEndOfFile = false;
+  m_StopReader = false;
+  m_ReaderThread = thread(&MModuleLoaderMeasurementsROA::RunReader, this);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleLoaderMeasurementsROA::StopReader()
+{
+  // Stop the reader thread and delete the events read ahead
+  
+  if (m_ReaderThread.joinable() == true) {
+    {
+      lock_guard<mutex> Lock(m_Mutex);
+      m_StopReader = true;
+    }
+    m_SpaceAvailable.notify_all();
+    m_ReaderThread.join();
+  }
+  
+  while (m_Events.size() > 0) {
+    ReleaseAssembly(m_Events.front());
+    m_Events.pop_front();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleLoaderMeasurementsROA::RunReader()
+{
+  // The loop of the reader thread: read and convert the events ahead of the analysis
+  
+  while (true) {
+    MReadOutAssembly* Event = NewAssembly();
+    bool HasEvent = ReadNextEvent(Event);
+    
+    unique_lock<mutex> Lock(m_Mutex);
+    if (HasEvent == true) {
+      m_SpaceAvailable.wait(Lock, [this] { return m_StopReader == true || m_Events.size() < c_MaxQueuedEvents; });
+    }
+    if (HasEvent == false || m_StopReader == true) {
+      m_IsEndOfFile = true;
+      Lock.unlock();
+      ReleaseAssembly(Event);
+      m_EventAvailable.notify_all();
+      break;
+    }
+    m_Events.push_back(Event);
+    Lock.unlock();
+    m_EventAvailable.notify_one();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MReadOutAssembly* MModuleLoaderMeasurementsROA::NewAssembly()
+{
+  // Return an empty assembly from the pool
+  
+  {
+    lock_guard<mutex> Lock(m_Mutex);
+    if (m_AssemblyPool.size() > 0) {
+      MReadOutAssembly* Event = m_AssemblyPool.back();
+      m_AssemblyPool.pop_back();
+      return Event;
+    }
+  }
+  
+  return new MReadOutAssembly();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MModuleLoaderMeasurementsROA::ReleaseAssembly(MReadOutAssembly* Event)
+{
+  // Clear the assembly and return it to the pool - the queue limits the number of assemblies
+  
+  Event->Clear();
+  
+  lock_guard<mutex> Lock(m_Mutex);
+  m_AssemblyPool.push_back(Event);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 bool MModuleLoaderMeasurementsROA::ReadXmlConfiguration(MXmlNode* Node)
 {
   //! Read the configuration data from an XML node
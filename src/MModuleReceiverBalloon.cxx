@@ -378,6 +378,7 @@ bool MModuleReceiverBalloon::Initialize()
       FileName += TimeStamp; 
     }
     m_Out.open(FileName);
+    m_OutBuffer.SetPrecision(m_Out.precision());
     m_Out<<"TYPE ROA"<<endl;
     m_Out<<"UF doublesidedstrip adcwithtiming"<<endl;
     m_Out<<endl;
@@ -466,10 +467,7 @@ bool MModuleReceiverBalloon::AnalyzeEvent(MReadOutAssembly* Event)
     Event->SetAspectIncomplete(true);
   }
 
-  while( NewEvent->GetNStripHits() > 0 ){
-    Event->AddStripHit( NewEvent->GetStripHit(0) );
-    NewEvent->RemoveStripHit(0);
-  }
+  Event->StealStripHits(NewEvent, false);
 
   Event->SetID( NewEvent->GetID() );
   Event->SetFC( NewEvent->GetFC() );
@@ -502,10 +500,13 @@ bool MModuleReceiverBalloon::AnalyzeEvent(MReadOutAssembly* Event)
   }
   
   if (m_RoaFileName != "") {
-    Event->StreamRoa(m_Out);
+    // The buffer keeps the precision between events, as the stream did
+    m_OutBuffer.Clear();
+    Event->StreamRoa(m_OutBuffer);
+    m_Out.write(m_OutBuffer.Data(), m_OutBuffer.Size());
   }
   
-  delete NewEvent;
+  ReleaseAssembly(NewEvent);
   
 
   // TODO: Just *copy* the data from the OLDEST event in the list to this event  
@@ -0,0 +1,175 @@
+/*
+ * MPacketKeyRecord.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MPacketKeyRecord
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MPacketKeyRecord.h"
+
+// Standard libs:
+#include <algorithm>
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MPacketKeyRecord)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MPacketKeyRecord::MPacketKeyRecord(unsigned int Capacity)
+{
+  // Construct an instance of MPacketKeyRecord
+
+  if (Capacity == 0) Capacity = 1;
+  m_Capacity = Capacity;
+
+  unsigned int Bits = 1;
+  while ((1U << Bits) < 2*m_Capacity) ++Bits;
+  m_Table.resize(1U << Bits);
+  m_Used.resize(1U << Bits);
+  m_Mask = (1U << Bits) - 1;
+  m_Shift = 64 - Bits;
+
+  m_Ring.resize(m_Capacity);
+
+  Clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MPacketKeyRecord::~MPacketKeyRecord()
+{
+  // Delete this instance of MPacketKeyRecord
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MPacketKeyRecord::Clear()
+{
+  // Forget all keys
+
+  fill(m_Used.begin(), m_Used.end(), 0);
+  m_Oldest = 0;
+  m_Size = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+unsigned int MPacketKeyRecord::Find(uint64_t Key) const
+{
+  // Return the slot of the key or the empty slot where it would go
+  // The table is never more than half full, thus there always is an empty slot
+
+  unsigned int Slot = Home(Key);
+  while (m_Used[Slot] != 0 && m_Table[Slot] != Key) {
+    Slot = (Slot + 1) & m_Mask;
+  }
+
+  return Slot;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MPacketKeyRecord::Contains(uint64_t Key) const
+{
+  // Return true if the key is in the record
+
+  return m_Used[Find(Key)] != 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MPacketKeyRecord::Insert(uint64_t Key)
+{
+  // Add the key and return true, or return false if it is already in the record
+
+  unsigned int Slot = Find(Key);
+  if (m_Used[Slot] != 0) return false;
+
+  if (m_Size == m_Capacity) {
+    // Forget the oldest key, its ring position is reused for the new one
+    Erase(m_Ring[m_Oldest]);
+    m_Ring[m_Oldest] = Key;
+    m_Oldest = (m_Oldest + 1) % m_Capacity;
+    // The erase might have shifted the empty slot
+    Slot = Find(Key);
+  } else {
+    m_Ring[(m_Oldest + m_Size) % m_Capacity] = Key;
+    ++m_Size;
+  }
+
+  m_Table[Slot] = Key;
+  m_Used[Slot] = 1;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MPacketKeyRecord::Erase(uint64_t Key)
+{
+  // Remove the key from the hash table
+  // Following keys of the probe sequence are moved up, so that no lookup
+  // stops early at the new hole
+
+  unsigned int Hole = Find(Key);
+  if (m_Used[Hole] == 0) return;
+
+  unsigned int Slot = Hole;
+  while (true) {
+    Slot = (Slot + 1) & m_Mask;
+    if (m_Used[Slot] == 0) break;
+    // Move the key into the hole if its home is not cyclically within (Hole, Slot]
+    unsigned int H = Home(m_Table[Slot]);
+    if (((Slot - H) & m_Mask) >= ((Slot - Hole) & m_Mask)) {
+      m_Table[Hole] = m_Table[Slot];
+      Hole = Slot;
+    }
+  }
+  m_Used[Hole] = 0;
+}
+
+
+// MPacketKeyRecord.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -28,12 +28,17 @@
 
 // Standard libs:
 #include <iomanip>
+#include <algorithm>
 using namespace std;
 
 // ROOT libs:
 
 // MEGAlib libs:
 
+// Nuclearizer libs:
+#include "MBinaryEventBlock.h"
+#include "MAsciiBuffer.h"
+
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -120,6 +125,9 @@ void MReadOutAssembly::Clear()
   m_MJD = 0.0;
 
   m_Veto = false;
+  m_VetoGR0 = false;
+  m_VetoGR1 = false;
+  m_VetoShield = false;
   m_Trigger = true;
 
   for (int DetectorID = 0; DetectorID <= 11; DetectorID++) {
@@ -131,6 +139,7 @@ void MReadOutAssembly::Clear()
     delete m_StripHits[h];
   }
   m_StripHits.clear();
+  m_StripHitIndexValid = false;
 
   for (unsigned int h = 0; h < m_StripHitsTOnly.size(); ++h) {
     delete m_StripHitsTOnly[h];
@@ -252,6 +261,7 @@ void MReadOutAssembly::AddStripHit(MStripHit* StripHit)
     m_InDetector[DetectorID]=true;
   }
   m_StripHits.push_back(StripHit);
+  m_StripHitIndexValid = false;
 }
 
 
@@ -265,7 +275,91 @@ void MReadOutAssembly::RemoveStripHit(unsigned int i)
     vector<MStripHit*>::iterator it;
     it = m_StripHits.begin()+i;
     m_StripHits.erase(it);
+    m_StripHitIndexValid = false;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::BuildStripHitIndex()
+{
+  //! Sort the strip hits by detector, side and strip into the strip hit index
+  //! Two stable counting sorts: first by strip ID, then by detector and side
+
+  unsigned int NDetectors = 0;
+  unsigned int NStrips = 1;
+  for (MStripHit* SH: m_StripHits) {
+    if (SH->GetDetectorID() < 0) continue;
+    NDetectors = max(NDetectors, (unsigned int) SH->GetDetectorID() + 1);
+    NStrips = max(NStrips, (unsigned int) max(SH->GetStripID(), 0) + 1);
+  }
+
+  // By strip ID into the scratch space
+  m_StripHitIndexCounts.assign(NStrips + 1, 0);
+  unsigned int NIndexed = 0;
+  for (MStripHit* SH: m_StripHits) {
+    if (SH->GetDetectorID() < 0) continue;
+    ++m_StripHitIndexCounts[max(SH->GetStripID(), 0) + 1];
+    ++NIndexed;
+  }
+  for (unsigned int s = 1; s <= NStrips; ++s) {
+    m_StripHitIndexCounts[s] += m_StripHitIndexCounts[s-1];
+  }
+  m_StripHitIndexScratch.resize(NIndexed);
+  for (MStripHit* SH: m_StripHits) {
+    if (SH->GetDetectorID() < 0) continue;
+    m_StripHitIndexScratch[m_StripHitIndexCounts[max(SH->GetStripID(), 0)]++] = SH;
+  }
+
+  // By detector and side into the index
+  m_StripHitIndexStarts.assign(2*NDetectors + 1, 0);
+  for (MStripHit* SH: m_StripHitIndexScratch) {
+    ++m_StripHitIndexStarts[2*SH->GetDetectorID() + (SH->IsXStrip() == true ? 0 : 1) + 1];
   }
+  for (unsigned int b = 1; b <= 2*NDetectors; ++b) {
+    m_StripHitIndexStarts[b] += m_StripHitIndexStarts[b-1];
+  }
+  m_StripHitIndexCounts.assign(m_StripHitIndexStarts.begin(), m_StripHitIndexStarts.end());
+  m_StripHitIndex.resize(NIndexed);
+  for (MStripHit* SH: m_StripHitIndexScratch) {
+    m_StripHitIndex[m_StripHitIndexCounts[2*SH->GetDetectorID() + (SH->IsXStrip() == true ? 0 : 1)]++] = SH;
+  }
+
+  m_StripHitIndexValid = true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+unsigned int MReadOutAssembly::GetNStripHits(int DetectorID, unsigned int Side)
+{
+  //! Return the number of strip hits on one side of one detector
+
+  if (m_StripHitIndexValid == false) BuildStripHitIndex();
+
+  unsigned int Bucket = 2*DetectorID + Side;
+  if (DetectorID < 0 || Side > 1 || Bucket + 1 >= m_StripHitIndexStarts.size()) return 0;
+
+  return m_StripHitIndexStarts[Bucket+1] - m_StripHitIndexStarts[Bucket];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MStripHit** MReadOutAssembly::GetStripHits(int DetectorID, unsigned int Side)
+{
+  //! Return the strip hits on one side of one detector
+
+  if (m_StripHitIndexValid == false) BuildStripHitIndex();
+
+  unsigned int Bucket = 2*DetectorID + Side;
+  if (DetectorID < 0 || Side > 1 || Bucket + 1 >= m_StripHitIndexStarts.size()) return 0;
+
+  return m_StripHitIndex.data() + m_StripHitIndexStarts[Bucket];
 }
 
 
@@ -318,6 +412,42 @@ void MReadOutAssembly::RemoveStripHitTOnly(unsigned int i)
 ////////////////////////////////////////////////////////////////////////////////
 
 
+void MReadOutAssembly::StealStripHits(MReadOutAssembly* Other, bool IncludeTOnly)
+{
+  //! Move all strip hits (and T Only strip hits) of Other to this assembly
+
+  if (Other == this) return;
+
+  for (MStripHit* SH: Other->m_StripHits) {
+    int DetectorID = SH->GetDetectorID();
+    if (DetectorID >= 0 && DetectorID <= 11) {
+      m_InDetector[DetectorID] = true;
+    }
+  }
+
+  if (m_StripHits.size() == 0) {
+    m_StripHits.swap(Other->m_StripHits);
+  } else {
+    m_StripHits.insert(m_StripHits.end(), Other->m_StripHits.begin(), Other->m_StripHits.end());
+    Other->m_StripHits.clear();
+  }
+  m_StripHitIndexValid = false;
+  Other->m_StripHitIndexValid = false;
+
+  if (IncludeTOnly == false) return;
+
+  if (m_StripHitsTOnly.size() == 0) {
+    m_StripHitsTOnly.swap(Other->m_StripHitsTOnly);
+  } else {
+    m_StripHitsTOnly.insert(m_StripHitsTOnly.end(), Other->m_StripHitsTOnly.begin(), Other->m_StripHitsTOnly.end());
+    Other->m_StripHitsTOnly.clear();
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 MHit* MReadOutAssembly::GetHit(unsigned int i) 
 { 
   //! Return hit i
@@ -661,6 +791,552 @@ void MReadOutAssembly::StreamRoa(ostream& S, bool)
 ////////////////////////////////////////////////////////////////////////////////
 
 
+//! The BD lines in the order of IsBad()
+static const char* g_BDLines[] = { "BD AspectIncomplete", "BD TimeIncomplete", "BD EnergyCalibrationIncomplete_BadStrip",
+  "BD EnergyCalibrationIncomplete", "BD EnergyResolutionCalibrationIncomplete", "BD StripPairingIncomplete", "BD LLDEvent",
+  "BD DepthCalibrationIncomplete", "BD DepthCalibration_OutofRange" };
+//! The number of BD lines
+static const unsigned int g_NBDLines = sizeof(g_BDLines)/sizeof(g_BDLines[0]);
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::StreamBDs(MAsciiBuffer& S, unsigned int NBDs)
+{
+  //! Stream the first NBDs BD flags (in the order of IsBad()) into a reusable character buffer
+
+  const bool BDs[g_NBDLines] = { m_AspectIncomplete, m_TimeIncomplete, m_EnergyCalibrationIncomplete_BadStrip, m_EnergyCalibrationIncomplete,
+    m_EnergyResolutionCalibrationIncomplete, m_StripPairingIncomplete, m_LLDEvent, m_DepthCalibrationIncomplete, m_DepthCalibration_OutofRange };
+  const MString* BDTexts[g_NBDLines] = { &m_AspectIncompleteString, &m_TimeIncompleteString, &m_EnergyCalibrationIncomplete_BadStripString, &m_EnergyCalibrationIncompleteString,
+    &m_EnergyResolutionCalibrationIncompleteString, &m_StripPairingIncompleteString, &m_LLDEventString, &m_DepthCalibrationIncompleteString, &m_DepthCalibration_OutofRangeString };
+
+  for (unsigned int b = 0; b < NBDs && b < g_NBDLines; ++b) {
+    if (BDs[b] == false) continue;
+    S<<g_BDLines[b];
+    if (*BDTexts[b] != "") S<<" ("<<*BDTexts[b]<<")";
+    S<<'\n';
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MReadOutAssembly::StreamDat(MAsciiBuffer& S, int Version)
+{
+  //! Steam the content into a reusable character buffer (identical to the ostream version)
+
+  S<<"SE\nID "<<m_ID<<"\nCL "<<m_Time<<"\nTI "<<m_EventTimeUTC<<'\n';
+
+  for (MSimIA& IA: m_SimIAs) {
+    S<<IA.ToSimString()<<'\n'; 
+  }
+  
+  if (m_Aspect != 0) {
+    m_Aspect->StreamDat(S, Version);
+  }
+  
+  if (Version == 1) {
+    for (unsigned int h = 0; h < m_StripHits.size(); ++h) {
+      m_StripHits[h]->StreamDat(S, Version);  
+    }
+
+    for (unsigned int h = 0; h < m_Hits.size(); ++h) {
+      m_Hits[h]->StreamDat(S, Version);  
+    }
+  } else if (Version == 2) {
+    for (auto H : m_Hits) {
+      H->StreamDat(S, 2);
+    }
+  }
+
+  StreamBDs(S, g_NBDLines);
+  
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::StreamEvta(MAsciiBuffer& S)
+{
+  //! Stream the content in MEGAlib's evta format into a reusable character buffer (identical to the ostream version)
+
+  S<<"SE\nID "<<m_ID<<"\nCL "<<m_Time<<"\nTI "<<m_EventTimeUTC<<'\n';
+
+  if (m_Aspect != 0) {
+    m_Aspect->StreamEvta(S);
+  }
+
+  if (m_HasSimAspectInfo){
+    S<<"GX "<<m_GalacticPointingXAxisPhi<<' '<<m_GalacticPointingXAxisTheta<<'\n';
+    S<<"GZ "<<m_GalacticPointingZAxisPhi<<' '<<m_GalacticPointingZAxisTheta<<'\n';
+  }
+
+  for (MSimIA& IA: m_SimIAs) {
+    S<<IA.ToSimString()<<'\n'; 
+  }
+  
+  for (unsigned int h = 0; h < m_Hits.size(); ++h) {
+    m_Hits[h]->StreamEvta(S);  
+  }
+  
+  S<<"CC NStripHits "<<m_StripHits.size()<<'\n';
+  
+  StreamBDs(S, g_NBDLines);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::StreamRoa(MAsciiBuffer& S, bool)
+{
+  //! Stream the content in MEGAlib's roa format into a reusable character buffer (identical to the ostream version)
+
+  S<<"SE\nID "<<m_ID<<"\nCL "<<m_Time<<"\nTI "<<m_EventTimeUTC<<'\n';
+
+  if (m_Aspect != 0) {
+    m_Aspect->StreamEvta(S);
+  }
+
+  for (MSimIA& IA: m_SimIAs) {
+    S<<IA.ToSimString()<<'\n'; 
+  }
+
+  for (unsigned int h = 0; h < m_StripHits.size(); ++h) {
+    m_StripHits[h]->StreamRoa(S);  
+  }
+  
+  // Those are the only BD's relevant for the roa format: aspect and time
+  StreamBDs(S, 2);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+//! The bits of the event flags in the binary event format
+static const uint32_t c_BinaryVeto = 1 << 0;
+static const uint32_t c_BinaryVetoGR0 = 1 << 1;
+static const uint32_t c_BinaryVetoGR1 = 1 << 2;
+static const uint32_t c_BinaryVetoShield = 1 << 3;
+static const uint32_t c_BinaryTrigger = 1 << 4;
+static const uint32_t c_BinaryAspectGood = 1 << 5;
+static const uint32_t c_BinaryFilteredOut = 1 << 6;
+static const uint32_t c_BinaryHasSimAspectInfo = 1 << 7;
+static const uint32_t c_BinaryHasAspect = 1 << 8;
+//! The first BD flag, the others follow in the order of MReadOutAssembly::IsBad()
+static const uint32_t c_BinaryFirstBD = 9;
+static const unsigned int c_BinaryNBDs = 9;
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssembly::StreamBinary(MBinaryEventBlock& B)
+{
+  //! Append the content to a block of the binary event format
+
+  bool* BDs[c_BinaryNBDs] = { &m_AspectIncomplete, &m_TimeIncomplete, &m_EnergyCalibrationIncomplete_BadStrip, &m_EnergyCalibrationIncomplete,
+    &m_EnergyResolutionCalibrationIncomplete, &m_StripPairingIncomplete, &m_LLDEvent, &m_DepthCalibrationIncomplete, &m_DepthCalibration_OutofRange };
+  MString* BDTexts[c_BinaryNBDs] = { &m_AspectIncompleteString, &m_TimeIncompleteString, &m_EnergyCalibrationIncomplete_BadStripString, &m_EnergyCalibrationIncompleteString,
+    &m_EnergyResolutionCalibrationIncompleteString, &m_StripPairingIncompleteString, &m_LLDEventString, &m_DepthCalibrationIncompleteString, &m_DepthCalibration_OutofRangeString };
+
+  B.NewEvent();
+
+  B.Add<uint64_t>(MBinaryEventBlock::c_EventID, m_ID);
+  B.Add<int64_t>(MBinaryEventBlock::c_EventTimeSeconds, m_Time.GetAsSystemSeconds());
+  B.Add<int32_t>(MBinaryEventBlock::c_EventTimeNanoSeconds, m_Time.GetNanoSeconds());
+  B.Add<int64_t>(MBinaryEventBlock::c_EventUTCSeconds, m_EventTimeUTC.GetAsSystemSeconds());
+  B.Add<int32_t>(MBinaryEventBlock::c_EventUTCNanoSeconds, m_EventTimeUTC.GetNanoSeconds());
+  B.Add<uint64_t>(MBinaryEventBlock::c_EventCL, m_CL);
+  B.Add<uint64_t>(MBinaryEventBlock::c_EventTI, m_TI);
+  B.Add<uint32_t>(MBinaryEventBlock::c_EventFC, m_FC);
+  B.Add<double>(MBinaryEventBlock::c_EventMJD, m_MJD);
+  B.Add<double>(MBinaryEventBlock::c_EventQuality, m_EventQuality);
+  B.Add<uint64_t>(MBinaryEventBlock::c_EventAnalysisProgress, m_AnalysisProgress);
+
+  uint32_t Flags = 0;
+  if (m_Veto == true) Flags |= c_BinaryVeto;
+  if (m_VetoGR0 == true) Flags |= c_BinaryVetoGR0;
+  if (m_VetoGR1 == true) Flags |= c_BinaryVetoGR1;
+  if (m_VetoShield == true) Flags |= c_BinaryVetoShield;
+  if (m_Trigger == true) Flags |= c_BinaryTrigger;
+  if (m_AspectGood == true) Flags |= c_BinaryAspectGood;
+  if (m_FilteredOut == true) Flags |= c_BinaryFilteredOut;
+  if (m_HasSimAspectInfo == true) Flags |= c_BinaryHasSimAspectInfo;
+  if (m_Aspect != 0) Flags |= c_BinaryHasAspect;
+  for (unsigned int b = 0; b < c_BinaryNBDs; ++b) {
+    if (*BDs[b] == true) {
+      Flags |= 1 << (c_BinaryFirstBD + b);
+      B.AddString(MBinaryEventBlock::c_EventBDTexts, *BDTexts[b]);
+    }
+  }
+  B.Add<uint32_t>(MBinaryEventBlock::c_EventFlags, Flags);
+
+  if (m_HasSimAspectInfo == true) {
+    B.Add<double>(MBinaryEventBlock::c_EventSimAspect, m_GalacticPointingXAxisTheta);
+    B.Add<double>(MBinaryEventBlock::c_EventSimAspect, m_GalacticPointingXAxisPhi);
+    B.Add<double>(MBinaryEventBlock::c_EventSimAspect, m_GalacticPointingZAxisTheta);
+    B.Add<double>(MBinaryEventBlock::c_EventSimAspect, m_GalacticPointingZAxisPhi);
+  }
+
+  if (m_Aspect != 0) {
+    const unsigned int A = MBinaryEventBlock::c_EventAspect;
+    B.Add<int64_t>(A, m_Aspect->GetTime().GetAsSystemSeconds());
+    B.Add<int32_t>(A, m_Aspect->GetTime().GetNanoSeconds());
+    B.Add<int32_t>(A, m_Aspect->GetFlag());
+    B.Add<double>(A, m_Aspect->GetBRMS());
+    B.Add<uint16_t>(A, m_Aspect->GetAttFlag());
+    B.Add<int32_t>(A, m_Aspect->GetGPS_or_magnetometer());
+    B.Add<double>(A, m_Aspect->GetHeading());
+    B.Add<double>(A, m_Aspect->GetPitch());
+    B.Add<double>(A, m_Aspect->GetRoll());
+    B.Add<double>(A, m_Aspect->GetLatitude());
+    B.Add<double>(A, m_Aspect->GetLongitude());
+    B.Add<double>(A, m_Aspect->GetAltitude());
+    B.Add<double>(A, m_Aspect->GetGalacticPointingXAxisLongitude());
+    B.Add<double>(A, m_Aspect->GetGalacticPointingXAxisLatitude());
+    B.Add<double>(A, m_Aspect->GetGalacticPointingZAxisLongitude());
+    B.Add<double>(A, m_Aspect->GetGalacticPointingZAxisLatitude());
+    B.Add<double>(A, m_Aspect->GetHorizonPointingXAxisAzimuthNorth());
+    B.Add<double>(A, m_Aspect->GetHorizonPointingXAxisElevation());
+    B.Add<double>(A, m_Aspect->GetHorizonPointingZAxisAzimuthNorth());
+    B.Add<double>(A, m_Aspect->GetHorizonPointingZAxisElevation());
+    B.Add<uint8_t>(A, m_Aspect->GetOutOfRange() == true ? 1 : 0);
+    B.Add<int64_t>(A, m_Aspect->GetGPSTime().GetAsSystemSeconds());
+    B.Add<int32_t>(A, m_Aspect->GetGPSTime().GetNanoSeconds());
+    B.Add<int64_t>(A, m_Aspect->GetUTCTime().GetAsSystemSeconds());
+    B.Add<int32_t>(A, m_Aspect->GetUTCTime().GetNanoSeconds());
+    B.Add<uint64_t>(A, m_Aspect->GetPPS());
+  }
+
+  B.Add<uint32_t>(MBinaryEventBlock::c_EventNSimIAs, m_SimIAs.size());
+  for (MSimIA& IA: m_SimIAs) {
+    B.AddString(MBinaryEventBlock::c_EventSimIAs, IA.ToSimString());
+  }
+
+  // The strip hits are followed by the T only strip hits, the hits refer to them by their index
+  B.Add<uint32_t>(MBinaryEventBlock::c_EventNStripHits, m_StripHits.size());
+  B.Add<uint32_t>(MBinaryEventBlock::c_EventNStripHitsTOnly, m_StripHitsTOnly.size());
+  for (unsigned int l = 0; l < 2; ++l) {
+    for (MStripHit* SH: (l == 0 ? m_StripHits : m_StripHitsTOnly)) {
+      B.Add<int32_t>(MBinaryEventBlock::c_StripHitDetectorID, SH->GetDetectorID());
+      B.Add<int32_t>(MBinaryEventBlock::c_StripHitStripID, SH->GetStripID());
+      uint8_t SHFlags = 0;
+      if (SH->IsPositiveStrip() == true) SHFlags |= 1 << 0;
+      if (SH->IsLowVoltageStrip() == true) SHFlags |= 1 << 1;
+      if (SH->HasTriggered() == true) SHFlags |= 1 << 2;
+      B.Add<uint8_t>(MBinaryEventBlock::c_StripHitFlags, SHFlags);
+      B.Add<double>(MBinaryEventBlock::c_StripHitUncorrectedADCUnits, SH->GetUncorrectedADCUnits());
+      B.Add<double>(MBinaryEventBlock::c_StripHitADCUnits, SH->GetADCUnits());
+      B.Add<double>(MBinaryEventBlock::c_StripHitEnergy, SH->GetEnergy());
+      B.Add<double>(MBinaryEventBlock::c_StripHitEnergyResolution, SH->GetEnergyResolution());
+      B.Add<double>(MBinaryEventBlock::c_StripHitTiming, SH->GetTiming());
+      B.Add<double>(MBinaryEventBlock::c_StripHitPreampTemp, SH->GetPreampTemp());
+      vector<int> Origins = SH->GetOrigins();
+      B.Add<uint32_t>(MBinaryEventBlock::c_StripHitNOrigins, Origins.size());
+      for (int O: Origins) {
+        B.Add<int32_t>(MBinaryEventBlock::c_StripHitOrigins, O);
+      }
+    }
+  }
+
+  // The hits are followed by the simulation hits
+  B.Add<uint32_t>(MBinaryEventBlock::c_EventNHits, m_Hits.size());
+  B.Add<uint32_t>(MBinaryEventBlock::c_EventNHitsSim, m_HitsSim.size());
+  for (unsigned int l = 0; l < 2; ++l) {
+    for (MHit* H: (l == 0 ? m_Hits : m_HitsSim)) {
+      MVector P = H->GetPosition();
+      B.Add<double>(MBinaryEventBlock::c_HitPosition, P.X());
+      B.Add<double>(MBinaryEventBlock::c_HitPosition, P.Y());
+      B.Add<double>(MBinaryEventBlock::c_HitPosition, P.Z());
+      MVector R = H->GetPositionResolution();
+      B.Add<double>(MBinaryEventBlock::c_HitPositionResolution, R.X());
+      B.Add<double>(MBinaryEventBlock::c_HitPositionResolution, R.Y());
+      B.Add<double>(MBinaryEventBlock::c_HitPositionResolution, R.Z());
+      B.Add<double>(MBinaryEventBlock::c_HitEnergy, H->GetEnergy());
+      B.Add<double>(MBinaryEventBlock::c_HitEnergyResolution, H->GetEnergyResolution());
+      B.Add<double>(MBinaryEventBlock::c_HitQuality, H->GetHitQuality());
+      uint8_t HFlags = 0;
+      if (H->GetCrossTalkFlag() == true) HFlags |= 1 << 0;
+      if (H->GetChargeLossFlag() == true) HFlags |= 1 << 1;
+      if (H->GetStripHitMultipleTimesX() == true) HFlags |= 1 << 2;
+      if (H->GetStripHitMultipleTimesY() == true) HFlags |= 1 << 3;
+      if (H->GetChargeSharing() == true) HFlags |= 1 << 4;
+      if (H->GetNoDepth() == true) HFlags |= 1 << 5;
+      if (H->GetIsNondominantNeighborStrip() == true) HFlags |= 1 << 6;
+      B.Add<uint8_t>(MBinaryEventBlock::c_HitFlags, HFlags);
+
+      // Strip hits which are not part of this event cannot be referenced and are not saved
+      vector<uint32_t> Indices;
+      for (unsigned int s = 0; s < H->GetNStripHits(); ++s) {
+        MStripHit* SH = H->GetStripHit(s);
+        auto I = find(m_StripHits.begin(), m_StripHits.end(), SH);
+        if (I != m_StripHits.end()) {
+          Indices.push_back(I - m_StripHits.begin());
+          continue;
+        }
+        I = find(m_StripHitsTOnly.begin(), m_StripHitsTOnly.end(), SH);
+        if (I != m_StripHitsTOnly.end()) {
+          Indices.push_back(m_StripHits.size() + (I - m_StripHitsTOnly.begin()));
+        }
+      }
+      B.Add<uint32_t>(MBinaryEventBlock::c_HitNStripHits, Indices.size());
+      for (uint32_t I: Indices) {
+        B.Add<uint32_t>(MBinaryEventBlock::c_HitStripHits, I);
+      }
+
+      vector<int> Origins = H->GetOrigins();
+      B.Add<uint32_t>(MBinaryEventBlock::c_HitNOrigins, Origins.size());
+      for (int O: Origins) {
+        B.Add<int32_t>(MBinaryEventBlock::c_HitOrigins, O);
+      }
+    }
+  }
+
+  B.Add<uint32_t>(MBinaryEventBlock::c_EventNGuardringHits, m_GuardringHits.size());
+  for (MGuardringHit* GH: m_GuardringHits) {
+    B.Add<int32_t>(MBinaryEventBlock::c_GuardringHitDetectorID, GH->GetDetectorID());
+    B.Add<double>(MBinaryEventBlock::c_GuardringHitADCUnits, GH->GetADCUnits());
+    MVector P = GH->GetPosition();
+    B.Add<double>(MBinaryEventBlock::c_GuardringHitPosition, P.X());
+    B.Add<double>(MBinaryEventBlock::c_GuardringHitPosition, P.Y());
+    B.Add<double>(MBinaryEventBlock::c_GuardringHitPosition, P.Z());
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MReadOutAssembly::ParseBinary(MBinaryEventBlock& B)
+{
+  //! Read the next event of a block of the binary event format
+
+  if (B.NextEvent() == false) return false;
+
+  Clear();
+
+  bool* BDs[c_BinaryNBDs] = { &m_AspectIncomplete, &m_TimeIncomplete, &m_EnergyCalibrationIncomplete_BadStrip, &m_EnergyCalibrationIncomplete,
+    &m_EnergyResolutionCalibrationIncomplete, &m_StripPairingIncomplete, &m_LLDEvent, &m_DepthCalibrationIncomplete, &m_DepthCalibration_OutofRange };
+  MString* BDTexts[c_BinaryNBDs] = { &m_AspectIncompleteString, &m_TimeIncompleteString, &m_EnergyCalibrationIncomplete_BadStripString, &m_EnergyCalibrationIncompleteString,
+    &m_EnergyResolutionCalibrationIncompleteString, &m_StripPairingIncompleteString, &m_LLDEventString, &m_DepthCalibrationIncompleteString, &m_DepthCalibration_OutofRangeString };
+
+  m_ID = B.Get<uint64_t>(MBinaryEventBlock::c_EventID);
+  long int Seconds = B.Get<int64_t>(MBinaryEventBlock::c_EventTimeSeconds);
+  m_Time.Set(Seconds, (long int) B.Get<int32_t>(MBinaryEventBlock::c_EventTimeNanoSeconds));
+  Seconds = B.Get<int64_t>(MBinaryEventBlock::c_EventUTCSeconds);
+  m_EventTimeUTC.Set(Seconds, (long int) B.Get<int32_t>(MBinaryEventBlock::c_EventUTCNanoSeconds));
+  m_CL = B.Get<uint64_t>(MBinaryEventBlock::c_EventCL);
+  m_TI = B.Get<uint64_t>(MBinaryEventBlock::c_EventTI);
+  m_FC = B.Get<uint32_t>(MBinaryEventBlock::c_EventFC);
+  m_MJD = B.Get<double>(MBinaryEventBlock::c_EventMJD);
+  m_EventQuality = B.Get<double>(MBinaryEventBlock::c_EventQuality);
+  m_AnalysisProgress = B.Get<uint64_t>(MBinaryEventBlock::c_EventAnalysisProgress);
+
+  uint32_t Flags = B.Get<uint32_t>(MBinaryEventBlock::c_EventFlags);
+  m_Veto = (Flags & c_BinaryVeto) != 0;
+  m_VetoGR0 = (Flags & c_BinaryVetoGR0) != 0;
+  m_VetoGR1 = (Flags & c_BinaryVetoGR1) != 0;
+  m_VetoShield = (Flags & c_BinaryVetoShield) != 0;
+  m_Trigger = (Flags & c_BinaryTrigger) != 0;
+  m_AspectGood = (Flags & c_BinaryAspectGood) != 0;
+  m_FilteredOut = (Flags & c_BinaryFilteredOut) != 0;
+  m_HasSimAspectInfo = (Flags & c_BinaryHasSimAspectInfo) != 0;
+  for (unsigned int b = 0; b < c_BinaryNBDs; ++b) {
+    if ((Flags & (1 << (c_BinaryFirstBD + b))) != 0) {
+      *BDs[b] = true;
+      *BDTexts[b] = B.GetString(MBinaryEventBlock::c_EventBDTexts);
+    }
+  }
+
+  if (m_HasSimAspectInfo == true) {
+    m_GalacticPointingXAxisTheta = B.Get<double>(MBinaryEventBlock::c_EventSimAspect);
+    m_GalacticPointingXAxisPhi = B.Get<double>(MBinaryEventBlock::c_EventSimAspect);
+    m_GalacticPointingZAxisTheta = B.Get<double>(MBinaryEventBlock::c_EventSimAspect);
+    m_GalacticPointingZAxisPhi = B.Get<double>(MBinaryEventBlock::c_EventSimAspect);
+  }
+
+  if ((Flags & c_BinaryHasAspect) != 0) {
+    const unsigned int A = MBinaryEventBlock::c_EventAspect;
+    MAspect* Aspect = new MAspect();
+    MTime T;
+    Seconds = B.Get<int64_t>(A);
+    T.Set(Seconds, (long int) B.Get<int32_t>(A));
+    Aspect->SetTime(T);
+    Aspect->SetFlag(B.Get<int32_t>(A));
+    Aspect->SetBRMS(B.Get<double>(A));
+    Aspect->SetAttFlag(B.Get<uint16_t>(A));
+    Aspect->SetGPS_or_magnetometer(B.Get<int32_t>(A));
+    Aspect->SetHeading(B.Get<double>(A));
+    Aspect->SetPitch(B.Get<double>(A));
+    Aspect->SetRoll(B.Get<double>(A));
+    Aspect->SetLatitude(B.Get<double>(A));
+    Aspect->SetLongitude(B.Get<double>(A));
+    Aspect->SetAltitude(B.Get<double>(A));
+    double Longitude = B.Get<double>(A);
+    Aspect->SetGalacticPointingXAxis(Longitude, B.Get<double>(A));
+    Longitude = B.Get<double>(A);
+    Aspect->SetGalacticPointingZAxis(Longitude, B.Get<double>(A));
+    double Azimuth = B.Get<double>(A);
+    Aspect->SetHorizonPointingXAxis(Azimuth, B.Get<double>(A));
+    Azimuth = B.Get<double>(A);
+    Aspect->SetHorizonPointingZAxis(Azimuth, B.Get<double>(A));
+    Aspect->SetOutOfRange(B.Get<uint8_t>(A) != 0);
+    Seconds = B.Get<int64_t>(A);
+    T.Set(Seconds, (long int) B.Get<int32_t>(A));
+    Aspect->SetGPSTime(T);
+    Seconds = B.Get<int64_t>(A);
+    T.Set(Seconds, (long int) B.Get<int32_t>(A));
+    Aspect->SetUTCTime(T);
+    Aspect->SetPPS(B.Get<uint64_t>(A));
+    SetAspect(Aspect);
+  }
+
+  // The counts are checked against the data left in their columns, since a corrupt count
+  // would otherwise create billions of (empty) hits
+
+  uint32_t NSimIAs = B.Get<uint32_t>(MBinaryEventBlock::c_EventNSimIAs);
+  if (NSimIAs*sizeof(uint32_t) > B.GetRemaining(MBinaryEventBlock::c_EventSimIAs)) return RejectBinaryBlock(B);
+  for (uint32_t i = 0; i < NSimIAs; ++i) {
+    MSimIA IA;
+    IA.AddRawInput(B.GetString(MBinaryEventBlock::c_EventSimIAs), 25);
+    AddSimIA(IA);
+  }
+
+  uint64_t NStripHits = B.Get<uint32_t>(MBinaryEventBlock::c_EventNStripHits);
+  uint64_t NAllStripHits = NStripHits + B.Get<uint32_t>(MBinaryEventBlock::c_EventNStripHitsTOnly);
+  if (NAllStripHits*sizeof(int32_t) > B.GetRemaining(MBinaryEventBlock::c_StripHitDetectorID)) return RejectBinaryBlock(B);
+  for (uint64_t s = 0; s < NAllStripHits; ++s) {
+    MStripHit* SH = new MStripHit();
+    SH->SetDetectorID(B.Get<int32_t>(MBinaryEventBlock::c_StripHitDetectorID));
+    SH->SetStripID(B.Get<int32_t>(MBinaryEventBlock::c_StripHitStripID));
+    uint8_t SHFlags = B.Get<uint8_t>(MBinaryEventBlock::c_StripHitFlags);
+    SH->IsPositiveStrip((SHFlags & (1 << 0)) != 0);
+    SH->IsLowVoltageStrip((SHFlags & (1 << 1)) != 0);
+    SH->HasTriggered((SHFlags & (1 << 2)) != 0);
+    SH->SetUncorrectedADCUnits(B.Get<double>(MBinaryEventBlock::c_StripHitUncorrectedADCUnits));
+    SH->SetADCUnits(B.Get<double>(MBinaryEventBlock::c_StripHitADCUnits));
+    SH->SetEnergy(B.Get<double>(MBinaryEventBlock::c_StripHitEnergy));
+    SH->SetEnergyResolution(B.Get<double>(MBinaryEventBlock::c_StripHitEnergyResolution));
+    SH->SetTiming(B.Get<double>(MBinaryEventBlock::c_StripHitTiming));
+    SH->SetPreampTemp(B.Get<double>(MBinaryEventBlock::c_StripHitPreampTemp));
+    uint32_t NOrigins = B.Get<uint32_t>(MBinaryEventBlock::c_StripHitNOrigins);
+    if (NOrigins*sizeof(int32_t) > B.GetRemaining(MBinaryEventBlock::c_StripHitOrigins)) {
+      delete SH;
+      return RejectBinaryBlock(B);
+    }
+    if (NOrigins > 0) {
+      vector<int> Origins(NOrigins);
+      for (uint32_t o = 0; o < NOrigins; ++o) {
+        Origins[o] = B.Get<int32_t>(MBinaryEventBlock::c_StripHitOrigins);
+      }
+      SH->AddOrigins(Origins);
+    }
+    if (s < NStripHits) {
+      AddStripHit(SH);
+    } else {
+      AddStripHitTOnly(SH);
+    }
+  }
+
+  uint64_t NHits = B.Get<uint32_t>(MBinaryEventBlock::c_EventNHits);
+  uint64_t NAllHits = NHits + B.Get<uint32_t>(MBinaryEventBlock::c_EventNHitsSim);
+  if (NAllHits*3*sizeof(double) > B.GetRemaining(MBinaryEventBlock::c_HitPosition)) return RejectBinaryBlock(B);
+  for (uint64_t h = 0; h < NAllHits; ++h) {
+    MHit* H = new MHit();
+    double X = B.Get<double>(MBinaryEventBlock::c_HitPosition);
+    double Y = B.Get<double>(MBinaryEventBlock::c_HitPosition);
+    double Z = B.Get<double>(MBinaryEventBlock::c_HitPosition);
+    H->SetPosition(MVector(X, Y, Z));
+    X = B.Get<double>(MBinaryEventBlock::c_HitPositionResolution);
+    Y = B.Get<double>(MBinaryEventBlock::c_HitPositionResolution);
+    Z = B.Get<double>(MBinaryEventBlock::c_HitPositionResolution);
+    H->SetPositionResolution(MVector(X, Y, Z));
+    H->SetEnergy(B.Get<double>(MBinaryEventBlock::c_HitEnergy));
+    H->SetEnergyResolution(B.Get<double>(MBinaryEventBlock::c_HitEnergyResolution));
+    H->SetHitQuality(B.Get<double>(MBinaryEventBlock::c_HitQuality));
+    uint8_t HFlags = B.Get<uint8_t>(MBinaryEventBlock::c_HitFlags);
+    H->SetCrossTalkFlag((HFlags & (1 << 0)) != 0);
+    H->SetChargeLossFlag((HFlags & (1 << 1)) != 0);
+    H->SetStripHitMultipleTimesX((HFlags & (1 << 2)) != 0);
+    H->SetStripHitMultipleTimesY((HFlags & (1 << 3)) != 0);
+    H->SetChargeSharing((HFlags & (1 << 4)) != 0);
+    H->SetNoDepth((HFlags & (1 << 5)) != 0);
+    H->SetIsNondominantNeighborStrip((HFlags & (1 << 6)) != 0);
+
+    uint32_t NHitStripHits = B.Get<uint32_t>(MBinaryEventBlock::c_HitNStripHits);
+    if (NHitStripHits*sizeof(uint32_t) > B.GetRemaining(MBinaryEventBlock::c_HitStripHits)) {
+      delete H;
+      return RejectBinaryBlock(B);
+    }
+    for (uint32_t s = 0; s < NHitStripHits; ++s) {
+      uint32_t Index = B.Get<uint32_t>(MBinaryEventBlock::c_HitStripHits);
+      if (Index < m_StripHits.size()) {
+        H->AddStripHit(m_StripHits[Index]);
+      } else if (Index - m_StripHits.size() < m_StripHitsTOnly.size()) {
+        H->AddStripHit(m_StripHitsTOnly[Index - m_StripHits.size()]);
+      }
+    }
+
+    uint32_t NOrigins = B.Get<uint32_t>(MBinaryEventBlock::c_HitNOrigins);
+    if (NOrigins*sizeof(int32_t) > B.GetRemaining(MBinaryEventBlock::c_HitOrigins)) {
+      delete H;
+      return RejectBinaryBlock(B);
+    }
+    if (NOrigins > 0) {
+      vector<int> Origins(NOrigins);
+      for (uint32_t o = 0; o < NOrigins; ++o) {
+        Origins[o] = B.Get<int32_t>(MBinaryEventBlock::c_HitOrigins);
+      }
+      H->AddOrigins(Origins);
+    }
+    if (h < NHits) {
+      m_Hits.push_back(H);
+    } else {
+      m_HitsSim.push_back(H);
+    }
+  }
+
+  uint32_t NGuardringHits = B.Get<uint32_t>(MBinaryEventBlock::c_EventNGuardringHits);
+  if (NGuardringHits*sizeof(int32_t) > B.GetRemaining(MBinaryEventBlock::c_GuardringHitDetectorID)) return RejectBinaryBlock(B);
+  for (uint32_t g = 0; g < NGuardringHits; ++g) {
+    MGuardringHit* GH = new MGuardringHit();
+    GH->SetDetectorID(B.Get<int32_t>(MBinaryEventBlock::c_GuardringHitDetectorID));
+    GH->SetADCUnits(B.Get<double>(MBinaryEventBlock::c_GuardringHitADCUnits));
+    double X = B.Get<double>(MBinaryEventBlock::c_GuardringHitPosition);
+    double Y = B.Get<double>(MBinaryEventBlock::c_GuardringHitPosition);
+    double Z = B.Get<double>(MBinaryEventBlock::c_GuardringHitPosition);
+    GH->SetPosition(MVector(X, Y, Z));
+    m_GuardringHits.push_back(GH);
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MReadOutAssembly::RejectBinaryBlock(MBinaryEventBlock& B)
+{
+  //! Discard the partly read event and the rest of a corrupt block - the later events of the block cannot be trusted either
+
+  if (g_Verbosity >= c_Error) cout<<"MReadOutAssembly: Error: A count in the binary event block does not fit its data - skipping the rest of the block"<<endl;
+  Clear();
+  B.Clear();
+
+  return false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
 bool MReadOutAssembly::IsGood() const
 {
   //! Returns true if none of the "bad" or "incomplete" falgs has been set
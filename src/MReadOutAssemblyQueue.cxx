@@ -0,0 +1,137 @@
+/*
+ * MReadOutAssemblyQueue.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MReadOutAssemblyQueue
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MReadOutAssemblyQueue.h"
+
+// Standard libs:
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MReadOutAssemblyQueue)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MReadOutAssemblyQueue::MReadOutAssemblyQueue() : m_LatestCL(0), m_Sequence(0)
+{
+  // Construct an instance of MReadOutAssemblyQueue
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MReadOutAssemblyQueue::~MReadOutAssemblyQueue()
+{
+  // Delete this instance of MReadOutAssemblyQueue
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssemblyQueue::Clear()
+{
+  // Forget all events
+
+  m_Heap.clear();
+  m_LatestCL = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MReadOutAssemblyQueue::Push(MReadOutAssembly* Event)
+{
+  // Add an event: append it and move it up until its parent is earlier
+
+  Entry New;
+  New.m_CL = Event->GetCL();
+  New.m_Sequence = m_Sequence++;
+  New.m_Event = Event;
+
+  if (m_Heap.empty() == true || New.m_CL > m_LatestCL) {
+    m_LatestCL = New.m_CL;
+  }
+
+  // Since the data is almost time ordered, the new event usually stays at the bottom
+  size_t Position = m_Heap.size();
+  m_Heap.push_back(New);
+  while (Position > 0) {
+    size_t Parent = (Position - 1)/2;
+    if (IsEarlier(New, m_Heap[Parent]) == false) break;
+    m_Heap[Position] = m_Heap[Parent];
+    Position = Parent;
+  }
+  m_Heap[Position] = New;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MReadOutAssembly* MReadOutAssemblyQueue::Pop()
+{
+  // Take out the earliest event: move the last entry down from the top until both children are later
+
+  MReadOutAssembly* Earliest = m_Heap.front().m_Event;
+
+  Entry Last = m_Heap.back();
+  m_Heap.pop_back();
+
+  size_t Size = m_Heap.size();
+  if (Size > 0) {
+    size_t Position = 0;
+    while (true) {
+      size_t Child = 2*Position + 1;
+      if (Child >= Size) break;
+      if (Child + 1 < Size && IsEarlier(m_Heap[Child + 1], m_Heap[Child]) == true) ++Child;
+      if (IsEarlier(m_Heap[Child], Last) == false) break;
+      m_Heap[Position] = m_Heap[Child];
+      Position = Child;
+    }
+    m_Heap[Position] = Last;
+  } else {
+    // The latest clock value is only valid as long as there are events
+    m_LatestCL = 0;
+  }
+
+  return Earliest;
+}
+
+
+// MReadOutAssemblyQueue.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,271 @@
+/*
+ * MStripCalibrationPolynomials.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MStripCalibrationPolynomials
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MStripCalibrationPolynomials.h"
+
+// Standard libs:
+#include <algorithm>
+#include <cmath>
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MStripCalibrationPolynomials)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MStripCalibrationPolynomials::MStripCalibrationPolynomials() : m_NDetectors(0), m_NStrips(0), m_MaxDegree(0), m_InverseXMin(0), m_InverseXMax(0), m_InverseNPoints(0)
+{
+  // Construct an instance of MStripCalibrationPolynomials
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MStripCalibrationPolynomials::~MStripCalibrationPolynomials()
+{
+  // Delete this instance of MStripCalibrationPolynomials
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripCalibrationPolynomials::Reset(unsigned int NDetectors, unsigned int NStrips)
+{
+  // Remove all polynomials and size the table
+
+  m_NDetectors = NDetectors;
+  m_NStrips = NStrips;
+  m_MaxDegree = 0;
+
+  m_Coefficients.assign(2*NDetectors*NStrips*c_NCoefficients, 0.0);
+  m_Degree.assign(2*NDetectors*NStrips, -1);
+
+  m_InverseNPoints = 0;
+  m_InverseSamples.clear();
+  m_InverseOffset.clear();
+  m_InverseMonotony.clear();
+  m_Minimum.clear();
+  m_Maximum.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MStripCalibrationPolynomials::Set(const MReadOutElementDoubleStrip& R, const double* Coefficients, unsigned int Degree)
+{
+  // Set the polynomial of the given strip
+
+  int Slot = GetSlot(R);
+  if (Slot < 0 || Degree > c_MaxDegree) return false;
+
+  double* C = &m_Coefficients[Slot*c_NCoefficients];
+  for (unsigned int d = 0; d < c_NCoefficients; ++d) {
+    C[d] = (d <= Degree) ? Coefficients[d] : 0.0;
+  }
+  m_Degree[Slot] = Degree;
+  m_MaxDegree = max(m_MaxDegree, (int) Degree);
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripCalibrationPolynomials::Evaluate(const int* Slots, const double* X, double* Y, unsigned int N) const
+{
+  // Evaluate the polynomials of all given slots at once
+  // The zero-padded leading coefficients do not change the result for finite X:
+  // (0*x + 0)*x + c is exactly c
+
+  const double* Coefficients = m_Coefficients.data();
+  const int MaxDegree = m_MaxDegree;
+
+  for (unsigned int i = 0; i < N; ++i) {
+    const double* C = Coefficients + Slots[i]*c_NCoefficients;
+    double x = X[i];
+    double y = C[MaxDegree];
+    for (int d = MaxDegree - 1; d >= 0; --d) y = y*x + C[d];
+    Y[i] = y;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+double MStripCalibrationPolynomials::EvaluateDerivative(int Slot, double X) const
+{
+  // Evaluate the derivative of the polynomial of the slot with Horner's rule
+
+  const double* C = &m_Coefficients[Slot*c_NCoefficients];
+  int Degree = m_Degree[Slot];
+  if (Degree < 1) return 0.0;
+
+  double Y = Degree*C[Degree];
+  for (int d = Degree - 1; d >= 1; --d) Y = Y*X + d*C[d];
+  return Y;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripCalibrationPolynomials::BuildInverse(double XMin, double XMax, unsigned int NPoints)
+{
+  // Build the inverses of all polynomials: sample the polynomials of degree two and higher,
+  // determine whether they are monotone, and store the extreme values of all polynomials
+
+  if (NPoints < 2) NPoints = 2;
+
+  m_InverseXMin = XMin;
+  m_InverseXMax = XMax;
+  m_InverseNPoints = NPoints;
+
+  unsigned int NSlots = m_Degree.size();
+  m_InverseSamples.clear();
+  m_InverseOffset.assign(NSlots, -1);
+  m_InverseMonotony.assign(NSlots, 0);
+  m_Minimum.assign(NSlots, 0.0);
+  m_Maximum.assign(NSlots, 0.0);
+
+  double Step = (XMax - XMin)/(NPoints - 1);
+
+  for (unsigned int Slot = 0; Slot < NSlots; ++Slot) {
+    if (m_Degree[Slot] < 0) continue;
+
+    double YMin = Evaluate(Slot, XMin);
+    double YMax = Evaluate(Slot, XMax);
+    if (YMin > YMax) swap(YMin, YMax);
+
+    if (m_Degree[Slot] >= 2) {
+      m_InverseOffset[Slot] = m_InverseSamples.size();
+      bool Increasing = true;
+      bool Decreasing = true;
+      double Last = 0;
+      for (unsigned int k = 0; k < NPoints; ++k) {
+        double Y = Evaluate(Slot, (k == NPoints - 1) ? XMax : XMin + k*Step);
+        m_InverseSamples.push_back(Y);
+        if (k > 0) {
+          if (Y <= Last) Increasing = false;
+          if (Y >= Last) Decreasing = false;
+        }
+        YMin = min(YMin, Y);
+        YMax = max(YMax, Y);
+        Last = Y;
+      }
+      m_InverseMonotony[Slot] = Increasing ? 1 : (Decreasing ? -1 : 0);
+    }
+
+    m_Minimum[Slot] = YMin;
+    m_Maximum[Slot] = YMax;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+double MStripCalibrationPolynomials::Invert(int Slot, double Y) const
+{
+  // Return the x in [XMin, XMax] with P(x) = Y
+
+  const double* C = &m_Coefficients[Slot*c_NCoefficients];
+  int Degree = m_Degree[Slot];
+
+  // Constant and linear polynomials have an exact inverse
+  if (Degree < 1 || (Degree == 1 && C[1] == 0)) return m_InverseXMin;
+  if (Degree == 1) {
+    double X = (Y - C[0])/C[1];
+    return min(max(X, m_InverseXMin), m_InverseXMax);
+  }
+
+  // Find the sample interval [k, k+1] which contains Y
+  const float* T = &m_InverseSamples[m_InverseOffset[Slot]];
+  int N = m_InverseNPoints;
+  int k = -1;
+  if (m_InverseMonotony[Slot] != 0) {
+    bool Increasing = (m_InverseMonotony[Slot] > 0);
+    if (Increasing == true ? Y <= T[0] : Y >= T[0]) return m_InverseXMin;
+    if (Increasing == true ? Y >= T[N-1] : Y <= T[N-1]) return m_InverseXMax;
+    int Low = 0;
+    int High = N - 1;
+    while (High - Low > 1) {
+      int Mid = (Low + High)/2;
+      if ((T[Mid] <= Y) == Increasing) {
+        Low = Mid;
+      } else {
+        High = Mid;
+      }
+    }
+    k = Low;
+  } else {
+    // Not monotone: the first interval which contains Y, or the closest sample
+    int Closest = 0;
+    for (int i = 0; i < N - 1; ++i) {
+      if ((T[i] <= Y && Y <= T[i+1]) || (T[i] >= Y && Y >= T[i+1])) {
+        k = i;
+        break;
+      }
+      if (fabs(T[i+1] - Y) < fabs(T[Closest] - Y)) Closest = i+1;
+    }
+    if (k < 0) {
+      return (Closest == N - 1) ? m_InverseXMax : m_InverseXMin + Closest*(m_InverseXMax - m_InverseXMin)/(N - 1);
+    }
+  }
+
+  // Interpolate linearly and refine with one Newton step, which has to stay in the interval
+  double Step = (m_InverseXMax - m_InverseXMin)/(N - 1);
+  double XLow = m_InverseXMin + k*Step;
+  double XHigh = (k + 1 == N - 1) ? m_InverseXMax : XLow + Step;
+  double X = XLow;
+  if (T[k+1] != T[k]) X += (Y - T[k])/(T[k+1] - T[k])*(XHigh - XLow);
+
+  double Derivative = EvaluateDerivative(Slot, X);
+  if (Derivative != 0) {
+    double Newton = X - (Evaluate(Slot, X) - Y)/Derivative;
+    if (Newton >= XLow && Newton <= XHigh) X = Newton;
+  }
+
+  return X;
+}
+
+
+// MStripCalibrationPolynomials.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
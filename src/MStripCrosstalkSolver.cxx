@@ -0,0 +1,258 @@
+/*
+ * MStripCrosstalkSolver.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MStripCrosstalkSolver
+//
+// The matrix has ones on the diagonal and the slope b0 (b1) at (i,j) and (j,i)
+// whenever strip j is the nearest (skip-1) neighbour of strip i. Each such pair
+// adds half of the offset a0 (a1) to the right-hand side of both strips.
+// For strictly ascending strip IDs only |i-j| <= 2 can be neighbours, thus the
+// matrix is pentadiagonal and is decomposed as L D L^T with a unit lower
+// triangular L of bandwidth two.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MStripCrosstalkSolver.h"
+
+// Standard libs:
+#include <cmath>
+
+// ROOT libs:
+#include "TMatrixD.h"
+
+// MEGAlib libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MStripCrosstalkSolver)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MStripCrosstalkSolver::MStripCrosstalkSolver() : m_Mode(c_ModeBanded), m_NearestOffset(0), m_NearestSlope(0), m_SkipOffset(0), m_SkipSlope(0)
+{
+  // Construct an instance of MStripCrosstalkSolver
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MStripCrosstalkSolver::~MStripCrosstalkSolver()
+{
+  // Delete this instance of MStripCrosstalkSolver
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripCrosstalkSolver::SetCoefficients(double NearestOffset, double NearestSlope, double SkipOffset, double SkipSlope)
+{
+  // Set the cross-talk coefficients
+
+  m_NearestOffset = NearestOffset;
+  m_NearestSlope = NearestSlope;
+  m_SkipOffset = SkipOffset;
+  m_SkipSlope = SkipSlope;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripCrosstalkSolver::Solve(unsigned int N, const int* StripIDs, const double* Energies, double* CorrectedEnergies) const
+{
+  // Correct the energies with the solver of the selected mode
+
+  if (m_Mode == c_ModeBanded) {
+    if (SolveBanded(N, StripIDs, Energies, CorrectedEnergies) == true) return;
+  }
+
+  SolveDense(N, StripIDs, Energies, CorrectedEnergies);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripCrosstalkSolver::SolveDense(unsigned int N, const int* StripIDs, const double* Energies, double* CorrectedEnergies) const
+{
+  // Correct the energies by inverting the full matrix
+
+  TMatrixD EnergyVector(N, 1);
+  for (unsigned int j = 0; j < N; ++j) {
+    EnergyVector[j][0] = Energies[j];
+  }
+
+  TMatrixD Matrix(N, N);
+  TMatrixD Constant(N, 1);
+  for (unsigned int i = 0; i < N; ++i) {
+    for (unsigned int j = i; j < N; ++j) {
+      // Self-contribution
+      if (i == j) {
+        Matrix[i][j] += 1.0;
+      }
+      // Nearest-neighbor contributions
+      if (StripIDs[j] == StripIDs[i] + 1) {
+        Matrix[i][j] += m_NearestSlope;
+        Matrix[j][i] += m_NearestSlope;
+        Constant[i][0] += m_NearestOffset/2.;
+        Constant[j][0] += m_NearestOffset/2.;
+      }
+      // Skip-1 neighbor contributions
+      if (StripIDs[j] == StripIDs[i] + 2) {
+        Matrix[i][j] += m_SkipSlope;
+        Matrix[j][i] += m_SkipSlope;
+        Constant[i][0] += m_SkipOffset/2.;
+        Constant[j][0] += m_SkipOffset/2.;
+      }
+    }
+  }
+
+  TMatrixD Inv = Matrix.Invert();
+  TMatrixD FinalEnergies = TMatrixD(Inv, TMatrixD::kMult, EnergyVector + Constant);
+  for (unsigned int j = 0; j < N; ++j) {
+    CorrectedEnergies[j] = FinalEnergies[j][0];
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MStripCrosstalkSolver::SolveBanded(unsigned int N, const int* StripIDs, const double* Energies, double* CorrectedEnergies) const
+{
+  // Correct the energies with a banded L D L^T decomposition
+
+  if (N > c_MaxBandedStrips) return false;
+  for (unsigned int i = 1; i < N; ++i) {
+    if (StripIDs[i] <= StripIDs[i-1]) return false;
+  }
+
+  // The two upper diagonals of the matrix and the right-hand side
+  double Upper1[c_MaxBandedStrips];
+  double Upper2[c_MaxBandedStrips];
+  double R[c_MaxBandedStrips];
+  for (unsigned int i = 0; i < N; ++i) {
+    Upper1[i] = 0.0;
+    Upper2[i] = 0.0;
+    R[i] = Energies[i];
+  }
+  for (unsigned int i = 0; i < N; ++i) {
+    for (unsigned int j = i + 1; j < N && j <= i + 2; ++j) {
+      int Distance = StripIDs[j] - StripIDs[i];
+      double Slope = 0.0;
+      double Offset = 0.0;
+      if (Distance == 1) {
+        Slope = m_NearestSlope;
+        Offset = m_NearestOffset;
+      } else if (Distance == 2) {
+        Slope = m_SkipSlope;
+        Offset = m_SkipOffset;
+      } else {
+        continue;
+      }
+      if (j == i + 1) {
+        Upper1[i] = Slope;
+      } else {
+        Upper2[i] = Slope;
+      }
+      R[i] += Offset/2.;
+      R[j] += Offset/2.;
+    }
+  }
+
+  if (N == 1) {
+    CorrectedEnergies[0] = R[0];
+    return true;
+  }
+
+  if (N == 2) {
+    double E = Upper1[0];
+    double Det = 1.0 - E*E;
+    if (!(Det > 0)) return false;
+    CorrectedEnergies[0] = (R[0] - E*R[1])/Det;
+    CorrectedEnergies[1] = (R[1] - E*R[0])/Det;
+    return true;
+  }
+
+  if (N == 3) {
+    // Symmetric 3x3 matrix with unit diagonal: inverse via the adjugate
+    double P = Upper1[0];
+    double Q = Upper2[0];
+    double S = Upper1[1];
+    double Det = 1.0 + 2.0*P*Q*S - P*P - Q*Q - S*S;
+    if (!(Det > 0) || !(1.0 - P*P > 0)) return false;
+    double C00 = 1.0 - S*S;
+    double C01 = Q*S - P;
+    double C02 = P*S - Q;
+    double C11 = 1.0 - Q*Q;
+    double C12 = P*Q - S;
+    double C22 = 1.0 - P*P;
+    CorrectedEnergies[0] = (C00*R[0] + C01*R[1] + C02*R[2])/Det;
+    CorrectedEnergies[1] = (C01*R[0] + C11*R[1] + C12*R[2])/Det;
+    CorrectedEnergies[2] = (C02*R[0] + C12*R[1] + C22*R[2])/Det;
+    return true;
+  }
+
+  // Decomposition: L[i][i-1] = L1[i], L[i][i-2] = L2[i]
+  double D[c_MaxBandedStrips];
+  double L1[c_MaxBandedStrips];
+  double L2[c_MaxBandedStrips];
+  for (unsigned int i = 0; i < N; ++i) {
+    L2[i] = (i >= 2) ? Upper2[i-2]/D[i-2] : 0.0;
+    L1[i] = (i >= 1) ? (Upper1[i-1] - ((i >= 2) ? L2[i]*L1[i-1]*D[i-2] : 0.0))/D[i-1] : 0.0;
+    D[i] = 1.0;
+    if (i >= 1) D[i] -= L1[i]*L1[i]*D[i-1];
+    if (i >= 2) D[i] -= L2[i]*L2[i]*D[i-2];
+    if (!(D[i] > 0)) return false;
+  }
+
+  // Forward substitution with L, scaling with D, and back substitution with L^T
+  for (unsigned int i = 1; i < N; ++i) {
+    R[i] -= L1[i]*R[i-1];
+    if (i >= 2) R[i] -= L2[i]*R[i-2];
+  }
+  for (unsigned int i = 0; i < N; ++i) {
+    R[i] /= D[i];
+  }
+  for (int i = N - 2; i >= 0; --i) {
+    R[i] -= L1[i+1]*R[i+1];
+    if (i + 2 < (int) N) R[i] -= L2[i+2]*R[i+2];
+  }
+
+  for (unsigned int i = 0; i < N; ++i) {
+    CorrectedEnergies[i] = R[i];
+  }
+
+  return true;
+}
+
+
+// MStripCrosstalkSolver.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
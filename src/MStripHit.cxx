@@ -35,6 +35,7 @@ using namespace std;
 
 // MEGAlib libs:
 #include "MStreams.h"
+#include "MAsciiBuffer.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -200,5 +201,51 @@ void MStripHit::StreamRoa(ostream& S)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MStripHit::StreamDat(MAsciiBuffer& S, int Version)
+{
+  //! Dump the content into a reusable character buffer (identical to the ostream version)
+  
+  S<<"SH "
+   <<m_ReadOutElement->GetDetectorID()<<' '
+   <<((m_ReadOutElement->IsLowVoltageStrip() == true) ? 'l' : 'h')<<' '
+   <<m_ReadOutElement->GetStripID()<<' '
+   <<m_HasTriggered<<' ';
+  // As setprecision, this sticks for all following numbers
+  S.SetPrecision(9);
+  S<<m_Timing<<' '
+   <<m_UncorrectedADCUnits<<' '
+   <<m_ADCUnits<<' '
+   <<m_Energy<<' '
+   <<m_EnergyResolution<<'\n';
+ 
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripHit::StreamRoa(MAsciiBuffer& S)
+{
+  //! Stream the content in MEGAlib's roa format into a reusable character buffer (identical to the ostream version)
+
+  S<<"UH " 
+   <<m_ReadOutElement->GetDetectorID()<<' '
+   <<m_ReadOutElement->GetStripID()<<' '
+   <<((m_ReadOutElement->IsLowVoltageStrip() == true) ? 'l' : 'h')<<' '
+   <<m_ADCUnits<<' '
+   <<m_Timing<<' '
+   <<m_PreampTemp<<' ';
+  for (unsigned int i = 0; i < m_Origins.size(); ++i) {
+    if (i != 0) S<<';';
+    S<<m_Origins[i]; 
+  }
+  S<<'\n';
+}
+
+
 // MStripHit.cxx: the end...
 ////////////////////////////////////////////////////////////////////////////////
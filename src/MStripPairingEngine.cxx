@@ -0,0 +1,1107 @@
+/*
+ * MStripPairingEngine.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MStripPairingEngine
+//
+// This is a re-implementation of Clio Sleator's greedy strip pairing which gives
+// bit-identical results. The kill matrix elements of the original algorithm are
+// the vector sums of the constituent strips. Thus an element (i, j) is non-zero
+// exactly if the combinations i and j share an original strip, and a combination
+// is bad exactly if it contains an original strip twice. Both are stored as a
+// bitmask of the original strips and a flag per combination.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MStripPairingEngine.h"
+
+// Standard libs:
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <algorithm>
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MStripPairingEngine)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MStripPairingEngine::MStripPairingEngine()
+{
+  // Construct an instance of MStripPairingEngine
+
+  // Large enough for all but the three-hit searches of high-multiplicity events
+  m_WeightMatrix.resize(c_MaxEntriesWithoutThreeHits*c_MaxEntriesWithoutThreeHits);
+
+  m_Mode = c_ModeGreedy;
+  m_AssignmentStamp = 0;
+
+  Clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MStripPairingEngine::~MStripPairingEngine()
+{
+  // Delete this instance of MStripPairingEngine
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::SetMode(unsigned int Mode)
+{
+  // Set the pairing mode - the buffers of the optimal assignment are only created when needed
+
+  m_Mode = Mode;
+
+  if (m_Mode == c_ModeOptimalAssignment && m_AssignmentStates.size() == 0) {
+    m_MaskPairs.resize(c_NMasks*c_NMasks);
+    m_AssignmentStates.resize(c_NMasks*c_NMasks);
+    for (AssignmentState& S: m_AssignmentStates) {
+      S.m_Stamp = 0;
+    }
+    m_AssignmentStamp = 0;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::Clear()
+{
+  // Reset all counters
+
+  for (int axis = 0; axis < 2; ++axis) {
+    m_NHits[axis] = 0;
+    m_NHitsOrig[axis] = 0;
+    m_NHitsAdj[axis] = 0;
+    m_NThreeHitsAdj[axis] = 0;
+  }
+  m_NFinalPairs = 0;
+  for (int p = 0; p < c_MaxPasses-1; ++p) {
+    m_NSavedFinalPairs[p] = 0;
+  }
+  m_NHitRecords = 0;
+  m_DetectorQuality = 0;
+  m_NDecodedHits = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+int MStripPairingEngine::Load(MReadOutAssembly* Event, int DetectorID)
+{
+  // Get the strip hits of one detector from the event
+
+  Clear();
+
+  // Find the number of hits per side for this detector
+  int n_x = Event->GetNStripHits(DetectorID, 0);
+  int n_y = Event->GetNStripHits(DetectorID, 1);
+
+  // No strip hits in detector: different return value
+  // (don't want to flag as bad if there weren't any strip hits...)
+  if (n_x == 0 && n_y == 0) return -3;
+
+  // IMPORTANT: THIS SETS CAPS ON THE KIND OF EVENTS ANALYZED BY THE CODE!
+  if (!((n_x > 0) && (n_y > 0) && (abs(n_x - n_y) < 5) && (n_x <= c_MaxStripsPerSide) && (n_y <= c_MaxStripsPerSide))) {
+    return -1;
+  }
+
+  // The strip hits of each side come sorted by strip ID from the event
+  for (int axis = 0; axis < 2; ++axis) {
+    MStripHit** StripHits = Event->GetStripHits(DetectorID, axis);
+    int NStripHits = (axis == 0) ? n_x : n_y;
+    bool HasDuplicates = false;
+    for (int i = 0; i < NStripHits; ++i) {
+      if (i > 0 && StripHits[i]->GetStripID() == StripHits[i-1]->GetStripID()) HasDuplicates = true;
+      AddStrip(axis, StripHits[i]);
+    }
+
+    // Multiple strip hits on one strip: their order matters for the pairing, thus
+    // sort them exactly as done historically, i.e. by selection sort from the event order
+    if (HasDuplicates == true) {
+      m_NHits[axis] = 0;
+      for (unsigned int i = 0; i < Event->GetNStripHits(); ++i) {
+        MStripHit* SH = Event->GetStripHit(i);
+        if (SH->GetDetectorID() == DetectorID && SH->IsXStrip() == (axis == 0)) {
+          AddStrip(axis, SH);
+        }
+      }
+      for (int i = 0; i < m_NHits[axis]-1; ++i) {
+        int min = i;
+        for (int j = i+1; j < m_NHits[axis]; ++j) {
+          if (m_StripsHit[axis][j] < m_StripsHit[axis][min]) {
+            min = j;
+          }
+        }
+        if (min != i) {
+          swap(m_StripsHit[axis][i], m_StripsHit[axis][min]);
+          swap(m_Energy[axis][i], m_Energy[axis][min]);
+          swap(m_Sigma[axis][i], m_Sigma[axis][min]);
+        }
+      }
+    }
+  }
+  n_x = m_NHits[0];
+  n_y = m_NHits[1];
+  m_NHitsOrig[0] = n_x;
+  m_NHitsOrig[1] = n_y;
+
+  // Check strip numbers again: some strips could have bad energy or resolution
+  if (!((n_x > 0) && (n_y > 0) && (abs(n_x - n_y) < 5))) {
+    return -2;
+  }
+
+  // The original strips kill only themselves
+  for (int axis = 0; axis < 2; ++axis) {
+    for (int i = 0; i < m_NHits[axis]; ++i) {
+      m_KillMask[axis][i] = (unsigned char) (1 << i);
+      m_BadCombination[axis][i] = false;
+    }
+  }
+
+  return 1;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::AddStrip(int Axis, MStripHit* SH)
+{
+  // Add a strip hit, but only if its energy and resolution are NOT inf, 0, nan
+
+  const double inf = numeric_limits<double>::infinity();
+  float stripEnergy = SH->GetEnergy();
+  float stripSigma = SH->GetEnergyResolution();
+  if (stripEnergy != 0 && stripEnergy != inf && !std::isnan(stripEnergy) && stripSigma != 0 && stripSigma != inf && !std::isnan(stripSigma)) {
+    int n = m_NHits[Axis]++;
+    m_StripsHit[Axis][n] = SH->GetStripID();
+    m_Energy[Axis][n] = stripEnergy;
+    m_Sigma[Axis][n] = stripSigma;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MStripPairingEngine::Pair()
+{
+  // Pair the loaded strips: repeat the greedy search with more strip combinations
+  // as long as the chi-square is bad, and then use the best search
+
+  float firstChiSq, secondChiSq, thirdChiSq, fourthChiSq;
+  firstChiSq = secondChiSq = thirdChiSq = fourthChiSq = -1;
+
+  CheckForAdjacentStrips();
+  if (FindFinalPairs(firstChiSq) == false) return false;
+
+  if (firstChiSq > 25) {
+    SaveFinalPairs(0);
+
+    ChargeSharingThreeStrips(0);
+    ChargeSharingThreeStrips(1);
+    if (FindFinalPairs(secondChiSq) == false) return false;
+
+    if (secondChiSq > 25) {
+      SaveFinalPairs(1);
+
+      AddMultipleHits(0);
+      AddMultipleHits(1);
+      if (FindFinalPairs(thirdChiSq) == false) return false;
+
+      if (thirdChiSq > 25) {
+        SaveFinalPairs(2);
+
+        AddThreeHits(0);
+        AddThreeHits(1);
+        if (FindFinalPairs(fourthChiSq) == false) return false;
+
+        // Find min chi-square
+        if (firstChiSq <= secondChiSq && firstChiSq <= thirdChiSq && firstChiSq <= fourthChiSq) {
+          RestoreFinalPairs(0);
+        } else if (secondChiSq <= firstChiSq && secondChiSq <= thirdChiSq && secondChiSq <= fourthChiSq) {
+          RestoreFinalPairs(1);
+        } else if (thirdChiSq <= firstChiSq && thirdChiSq <= secondChiSq && thirdChiSq <= fourthChiSq) {
+          RestoreFinalPairs(2);
+        }
+      }
+
+      if (firstChiSq <= secondChiSq && firstChiSq <= thirdChiSq) {
+        RestoreFinalPairs(0);
+      } else if (secondChiSq <= firstChiSq && secondChiSq <= thirdChiSq) {
+        RestoreFinalPairs(1);
+      }
+    }
+
+    if (firstChiSq <= secondChiSq) {
+      RestoreFinalPairs(0);
+    }
+  }
+
+  // The detector quality is the average of the hit quality factors of all searches
+  float detectorQuality = 0;
+  int counter = 0;
+  for (int i = 0; i < m_NHitRecords; ++i) {
+    detectorQuality = detectorQuality + m_HitQualityFactor[i];
+    counter += 1;
+  }
+  m_DetectorQuality = detectorQuality / counter;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::SaveFinalPairs(int Pass)
+{
+  // Save the final pairs of a greedy search
+
+  m_NSavedFinalPairs[Pass] = m_NFinalPairs;
+  for (int p = 0; p < m_NFinalPairs; ++p) {
+    m_SavedFinalPairs[Pass][p][0] = m_FinalPairs[p][0];
+    m_SavedFinalPairs[Pass][p][1] = m_FinalPairs[p][1];
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::RestoreFinalPairs(int Pass)
+{
+  // Restore the final pairs of an earlier greedy search
+
+  m_NFinalPairs = m_NSavedFinalPairs[Pass];
+  for (int p = 0; p < m_NFinalPairs; ++p) {
+    m_FinalPairs[p][0] = m_SavedFinalPairs[Pass][p][0];
+    m_FinalPairs[p][1] = m_SavedFinalPairs[Pass][p][1];
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::AddCombination(int Axis, int Index, int Label, float Energy, float Sigma, int FirstIndex, int SecondIndex, int ThirdIndex)
+{
+  // Store a strip combination: It kills everything its constituents kill, and it is a bad
+  // combination if one of its constituents is bad or two of them share an original strip
+
+  unsigned char Mask = m_KillMask[Axis][FirstIndex];
+  bool Bad = m_BadCombination[Axis][FirstIndex];
+
+  Bad = Bad || m_BadCombination[Axis][SecondIndex] || (Mask & m_KillMask[Axis][SecondIndex]) != 0;
+  Mask |= m_KillMask[Axis][SecondIndex];
+
+  if (ThirdIndex >= 0) {
+    Bad = Bad || m_BadCombination[Axis][ThirdIndex] || (Mask & m_KillMask[Axis][ThirdIndex]) != 0;
+    Mask |= m_KillMask[Axis][ThirdIndex];
+  }
+
+  m_StripsHit[Axis][Index] = Label;
+  m_Energy[Axis][Index] = Energy;
+  m_Sigma[Axis][Index] = Sigma;
+  m_KillMask[Axis][Index] = Mask;
+  m_BadCombination[Axis][Index] = Bad;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::CheckForAdjacentStrips()
+{
+  // If strip n and n+1 are hit, the combined strip 50+n is appended
+
+  for (int axis = 0; axis < 2; ++axis) {
+    int counter = 0;
+    for (int i = 0; i < m_NHits[axis]-1; ++i) {
+      if (m_StripsHit[axis][i]+1 == m_StripsHit[axis][i+1]) {
+        counter += 1;
+        float adjStripEnergy = m_Energy[axis][i] + m_Energy[axis][i+1];
+        float adjStripSig = sqrt(m_Sigma[axis][i]*m_Sigma[axis][i]+m_Sigma[axis][i+1]*m_Sigma[axis][i+1]);
+        AddCombination(axis, m_NHits[axis]+counter-1, m_StripsHit[axis][i] + 50, adjStripEnergy, adjStripSig, i, i+1);
+      }
+    }
+    m_NHits[axis] = m_NHits[axis] + counter;
+    m_NHitsAdj[axis] = m_NHits[axis] - m_NHitsOrig[axis];
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::ChargeSharingThreeStrips(int Axis)
+{
+  // If the strips n, n+1, n+2 are hit and the middle one has the highest energy,
+  // the combined strip 5000+n is appended
+
+  int counter = 0;
+  for (int i = m_NHitsOrig[Axis]; i < m_NHitsOrig[Axis]+m_NHitsAdj[Axis]-1; ++i) {
+    if (abs(m_StripsHit[Axis][i+1] - m_StripsHit[Axis][i]) == 1) {
+      int sID_one = m_StripsHit[Axis][i]-50;
+      int indOne = GetStripIndex(Axis, sID_one);
+      // Only possible with strip IDs beyond the label ranges
+      if (indOne < 0 || indOne+2 >= m_NHits[Axis]+counter) continue;
+
+      float eOne = m_Energy[Axis][indOne];
+      float eTwo = m_Energy[Axis][indOne+1];
+      float eThree = m_Energy[Axis][indOne+2];
+      if (eTwo > eOne && eTwo > eThree) {
+        float newEnergy = eOne+eTwo+eThree;
+        float eResOne = m_Sigma[Axis][indOne];
+        float eResTwo = m_Sigma[Axis][indOne+1];
+        float eResThree = m_Sigma[Axis][indOne+2];
+        float newERes = sqrt(eResOne*eResOne + eResTwo*eResTwo + eResThree*eResThree);
+        counter += 1;
+        AddCombination(Axis, m_NHits[Axis]+counter-1, 5000+sID_one, newEnergy, newERes, indOne, indOne+1, indOne+2);
+      }
+    }
+  }
+
+  m_NHits[Axis] = m_NHits[Axis] + counter;
+  m_NThreeHitsAdj[Axis] = m_NThreeHitsAdj[Axis] + counter;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::AddMultipleHits(int Axis)
+{
+  // Append all combinations 100*a+b of two single or charge-sharing strips a, b
+
+  int nPairs = 0;
+  int nSingles = m_NHits[Axis]-m_NThreeHitsAdj[Axis];
+  for (int i = 0; i < nSingles; ++i) {
+    for (int j = i+1; j < nSingles; ++j) {
+      nPairs += 1;
+      float pairE = m_Energy[Axis][i]+m_Energy[Axis][j];
+      float pairSig = sqrt(m_Sigma[Axis][i]*m_Sigma[Axis][i]+m_Sigma[Axis][j]*m_Sigma[Axis][j]);
+      AddCombination(Axis, m_NHits[Axis]+nPairs-1, m_StripsHit[Axis][i]*100+m_StripsHit[Axis][j], pairE, pairSig, i, j);
+    }
+  }
+
+  m_NHits[Axis] = m_NHits[Axis] + nPairs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::AddThreeHits(int Axis)
+{
+  // Append all combinations 10000*a+b of a single or charge-sharing strip a and a two-hit combination b
+
+  int nPairs = 0;
+  int nSingles = m_NHitsOrig[Axis]+m_NHitsAdj[Axis];
+  int nHits = m_NHits[Axis];
+  for (int i = 0; i < nSingles; ++i) {
+    for (int j = nSingles+m_NThreeHitsAdj[Axis]; j < nHits; ++j) {
+      nPairs += 1;
+      float pairE = m_Energy[Axis][i]+m_Energy[Axis][j];
+      float pairSig = sqrt(m_Sigma[Axis][i]*m_Sigma[Axis][i]+m_Sigma[Axis][j]*m_Sigma[Axis][j]);
+      AddCombination(Axis, nHits+nPairs-1, m_StripsHit[Axis][i]*10000+m_StripsHit[Axis][j], pairE, pairSig, i, j);
+    }
+  }
+
+  m_NHits[Axis] = m_NHits[Axis] + nPairs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::CalculateWeightMatrix()
+{
+  // Fill the weight matrix with the weights of all x-y pairs, bad pairs get -1
+
+  int n_x = m_NHits[0];
+  int n_y = m_NHits[1];
+  int n_xSingles = m_NHitsOrig[0] + m_NHitsAdj[0];
+  int n_ySingles = m_NHitsOrig[1] + m_NHitsAdj[1];
+
+  if (m_WeightMatrix.size() < (size_t) (n_x*n_y)) {
+    m_WeightMatrix.resize(n_x*n_y);
+  }
+
+  for (int i = 0; i < n_x; ++i) {
+    float* Row = &m_WeightMatrix[i*n_y];
+    float xE = m_Energy[0][i];
+    float xS = m_Sigma[0][i];
+    for (int j = 0; j < n_y; ++j) {
+      if (m_BadCombination[0][i] == false && m_BadCombination[1][j] == false && (i < n_xSingles || j < n_ySingles)) {
+        float yE = m_Energy[1][j];
+        float yS = m_Sigma[1][j];
+        Row[j] = (xE-yE)*(xE-yE)/((xS*xS)+(yS*yS));
+      } else {
+        Row[j] = -1;
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MStripPairingEngine::FindFinalPairs(float& ChiSquare)
+{
+  // Find the final pairs depending on the mode
+
+  if (m_Mode == c_ModeOptimalAssignment) {
+    FindOptimalPairs(ChiSquare);
+    return true;
+  }
+
+  return FindGreedyPairs(ChiSquare);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MStripPairingEngine::FindGreedyPairs(float& ChiSquare)
+{
+  // Greedy search: Take the pair with the minimum weight, remove all pairs with
+  // conflicting strips, and repeat until no pair is left
+
+  int n_x = m_NHits[0];
+  int n_y = m_NHits[1];
+
+  CalculateWeightMatrix();
+  if (g_Verbosity >= c_Info) PrintXYStripsHit();
+  if (g_Verbosity >= c_Info) PrintWeightMatrix();
+
+  float* W = &m_WeightMatrix[0];
+  int nElements = n_x*n_y;
+  int nNegElem = 0;
+  float greedyChiSq = 0;
+
+  m_NFinalPairs = 0;
+  do {
+    // The original code would loop forever here (only possible with infinite weights)
+    if (m_NFinalPairs == c_MaxPairsPerPass) return false;
+
+    // Find the indices of the minimum weight, and remove it
+    float min_weight = numeric_limits<float>::max();
+    int xIndex = 0;
+    int yIndex = 0;
+    for (int i = 0; i < n_x; ++i) {
+      const float* Row = W + i*n_y;
+      for (int j = 0; j < n_y; ++j) {
+        float weight = Row[j];
+        if (weight < min_weight && weight >= 0) {
+          min_weight = weight;
+          xIndex = i;
+          yIndex = j;
+        }
+      }
+    }
+    W[xIndex*n_y + yIndex] = -1;
+
+    m_FinalPairs[m_NFinalPairs][0] = m_StripsHit[0][xIndex];
+    m_FinalPairs[m_NFinalPairs][1] = m_StripsHit[1][yIndex];
+    ++m_NFinalPairs;
+
+    greedyChiSq += pow((m_Energy[0][xIndex]-m_Energy[1][yIndex]),2) / (pow(m_Sigma[0][xIndex],2) + pow(m_Sigma[1][yIndex],2));
+
+    // At this stage we can only use ONE side for energy and resolution
+    // The hit quality factor is the (already removed) weight
+    m_HitQualityFactor[m_NHitRecords] = W[xIndex*n_y + yIndex];
+    m_HitEnergy[m_NHitRecords] = m_Energy[1][yIndex];
+    m_EnergyResolution[m_NHitRecords] = m_Sigma[1][yIndex];
+    ++m_NHitRecords;
+
+    // Remove all pairs which share an original strip with the chosen ones
+    unsigned char xMask = m_KillMask[0][xIndex];
+    for (int i = 0; i < n_x; ++i) {
+      if ((m_KillMask[0][i] & xMask) != 0) {
+        fill(W + i*n_y, W + (i+1)*n_y, -1.0f);
+      }
+    }
+    unsigned char yMask = m_KillMask[1][yIndex];
+    for (int i = 0; i < n_y; ++i) {
+      if ((m_KillMask[1][i] & yMask) != 0) {
+        for (int j = 0; j < n_x; ++j) {
+          W[j*n_y + i] = -1;
+        }
+      }
+    }
+
+    nNegElem = 0;
+    for (int e = 0; e < nElements; ++e) {
+      if (W[e] == -1) ++nNegElem;
+    }
+  } while (nNegElem != nElements);
+
+  greedyChiSq = greedyChiSq / m_NFinalPairs;
+
+  if (g_Verbosity >= c_Info) {
+    cout<<"final pairs: "<<endl;
+    for (int i = 0; i < m_NFinalPairs; ++i) {
+      cout<<m_FinalPairs[i][0]<<'\t'<<m_FinalPairs[i][1]<<endl;
+    }
+    cout<<"chi sq: "<<greedyChiSq<<endl;
+  }
+
+  ChiSquare = greedyChiSq;
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::FindOptimalPairs(float& ChiSquare)
+{
+  // Exact assignment: Choose the set of x-y pairs without conflicting strips which leaves
+  // the least original strips unpaired, and among those the one with the lowest sum of weights.
+  // All pairs with the same two bitmasks of original strips are interchangeable, thus only the
+  // best of them is kept, and the assignment is solved on the bitmasks of the paired strips.
+  // With at most c_MaxStripsPerSide strips per side these are at most c_NMasks^2 states, and
+  // contrary to the greedy search, the weight matrix is traversed only once.
+
+  int n_x = m_NHits[0];
+  int n_y = m_NHits[1];
+  int n_xSingles = m_NHitsOrig[0] + m_NHitsAdj[0];
+  int n_ySingles = m_NHitsOrig[1] + m_NHitsAdj[1];
+
+  if (g_Verbosity >= c_Info) {
+    CalculateWeightMatrix();
+    PrintXYStripsHit();
+    PrintWeightMatrix();
+  }
+
+  // Collect the distinct bitmasks of both sides
+  for (int axis = 0; axis < 2; ++axis) {
+    bool Seen[c_NMasks] = { false };
+    m_NMasks[axis] = 0;
+    for (int i = 0; i < m_NHits[axis]; ++i) {
+      unsigned char Mask = m_KillMask[axis][i];
+      if (m_BadCombination[axis][i] == false && Seen[Mask] == false) {
+        Seen[Mask] = true;
+        m_Masks[axis][m_NMasks[axis]++] = Mask;
+      }
+    }
+    m_AllStrips[axis] = (1U << m_NHitsOrig[axis]) - 1;
+  }
+  for (int mx = 0; mx < m_NMasks[0]; ++mx) {
+    MaskPair* Row = &m_MaskPairs[m_Masks[0][mx]*c_NMasks];
+    for (int my = 0; my < m_NMasks[1]; ++my) {
+      Row[m_Masks[1][my]].m_Weight = -1;
+    }
+  }
+
+  // Keep the lowest weight per combination of bitmasks - the first one in case of equal weights
+  // (same weights and valid pairs as in CalculateWeightMatrix)
+  for (int i = 0; i < n_x; ++i) {
+    if (m_BadCombination[0][i] == true) continue;
+    MaskPair* Row = &m_MaskPairs[m_KillMask[0][i]*c_NMasks];
+    float xE = m_Energy[0][i];
+    float xS = m_Sigma[0][i];
+    int jMax = (i < n_xSingles) ? n_y : n_ySingles;
+    for (int j = 0; j < jMax; ++j) {
+      if (m_BadCombination[1][j] == true) continue;
+      float yE = m_Energy[1][j];
+      float yS = m_Sigma[1][j];
+      float Weight = (xE-yE)*(xE-yE)/((xS*xS)+(yS*yS));
+      // Infinite and NaN weights can never be paired
+      if (Weight >= 0 && Weight < numeric_limits<float>::max()) {
+        MaskPair& P = Row[m_KillMask[1][j]];
+        if (P.m_Weight < 0 || Weight < P.m_Weight) {
+          P.m_Weight = Weight;
+          P.m_XIndex = i;
+          P.m_YIndex = j;
+        }
+      }
+    }
+  }
+
+  // Group the x bitmasks by their lowest strip and list their valid pairs
+  for (int b = 0; b < m_NHitsOrig[0]; ++b) {
+    m_NXMasksByStrip[b] = 0;
+  }
+  for (int mx = 0; mx < m_NMasks[0]; ++mx) {
+    unsigned char XMask = m_Masks[0][mx];
+    const MaskPair* Row = &m_MaskPairs[XMask*c_NMasks];
+    int NYMasks = 0;
+    for (int my = 0; my < m_NMasks[1]; ++my) {
+      unsigned char YMask = m_Masks[1][my];
+      if (Row[YMask].m_Weight >= 0) {
+        m_YMasksByXMask[XMask][NYMasks++] = YMask;
+      }
+    }
+    m_NYMasksByXMask[XMask] = NYMasks;
+    if (NYMasks > 0) {
+      int b = 0;
+      while ((XMask & (1 << b)) == 0) ++b;
+      m_XMasksByStrip[b][m_NXMasksByStrip[b]++] = XMask;
+    }
+  }
+
+  // Solve the assignment - a wrap-around of the counter invalidates all states explicitly
+  if (++m_AssignmentStamp == 0) {
+    for (AssignmentState& S: m_AssignmentStates) {
+      S.m_Stamp = 0;
+    }
+    m_AssignmentStamp = 1;
+  }
+  SolveAssignment(0, 0);
+
+  // Follow the best choices from the initial state, and sort the pairs by weight like the greedy search
+  m_NFinalPairs = 0;
+  int xIndices[c_MaxPairsPerPass];
+  int yIndices[c_MaxPairsPerPass];
+  float Weights[c_MaxPairsPerPass];
+  unsigned int XPaired = 0;
+  unsigned int YPaired = 0;
+  while (XPaired != m_AllStrips[0]) {
+    const AssignmentState& S = m_AssignmentStates[XPaired*c_NMasks + YPaired];
+    if (S.m_YMask != 0) {
+      const MaskPair& P = m_MaskPairs[S.m_XMask*c_NMasks + S.m_YMask];
+      int p = m_NFinalPairs++;
+      while (p > 0 && Weights[p-1] > P.m_Weight) {
+        xIndices[p] = xIndices[p-1];
+        yIndices[p] = yIndices[p-1];
+        Weights[p] = Weights[p-1];
+        --p;
+      }
+      xIndices[p] = P.m_XIndex;
+      yIndices[p] = P.m_YIndex;
+      Weights[p] = P.m_Weight;
+    }
+    XPaired |= S.m_XMask;
+    YPaired |= S.m_YMask;
+  }
+
+  // Like the greedy search, fall back to the pair (0, 0) if nothing can be paired
+  if (m_NFinalPairs == 0) {
+    xIndices[0] = 0;
+    yIndices[0] = 0;
+    Weights[0] = -1;
+    m_NFinalPairs = 1;
+  }
+
+  float ChiSq = 0;
+  for (int p = 0; p < m_NFinalPairs; ++p) {
+    int xIndex = xIndices[p];
+    int yIndex = yIndices[p];
+    m_FinalPairs[p][0] = m_StripsHit[0][xIndex];
+    m_FinalPairs[p][1] = m_StripsHit[1][yIndex];
+
+    ChiSq += pow((m_Energy[0][xIndex]-m_Energy[1][yIndex]),2) / (pow(m_Sigma[0][xIndex],2) + pow(m_Sigma[1][yIndex],2));
+
+    // At this stage we can only use ONE side for energy and resolution
+    m_HitQualityFactor[m_NHitRecords] = Weights[p];
+    m_HitEnergy[m_NHitRecords] = m_Energy[1][yIndex];
+    m_EnergyResolution[m_NHitRecords] = m_Sigma[1][yIndex];
+    ++m_NHitRecords;
+  }
+  ChiSq = ChiSq / m_NFinalPairs;
+
+  if (g_Verbosity >= c_Info) {
+    cout<<"final pairs: "<<endl;
+    for (int i = 0; i < m_NFinalPairs; ++i) {
+      cout<<m_FinalPairs[i][0]<<'\t'<<m_FinalPairs[i][1]<<endl;
+    }
+    cout<<"chi sq: "<<ChiSq<<endl;
+  }
+
+  ChiSquare = ChiSq;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+unsigned int MStripPairingEngine::SolveAssignment(unsigned int XPaired, unsigned int YPaired)
+{
+  // Solve the assignment for the not yet paired strips: The lowest unpaired x strip either stays
+  // unpaired, or it is paired as part of any combination without already paired strips
+
+  unsigned int Index = XPaired*c_NMasks + YPaired;
+  AssignmentState& S = m_AssignmentStates[Index];
+  if (S.m_Stamp == m_AssignmentStamp) return Index;
+
+  S.m_Stamp = m_AssignmentStamp;
+  S.m_Weight = 0;
+  S.m_XMask = 0;
+  S.m_YMask = 0;
+
+  // All x strips are done: The remaining y strips stay unpaired
+  if (XPaired == m_AllStrips[0]) {
+    unsigned int YUnpaired = m_AllStrips[1] & ~YPaired;
+    S.m_NUnpaired = 0;
+    for (; YUnpaired != 0; YUnpaired &= YUnpaired - 1) ++S.m_NUnpaired;
+    return Index;
+  }
+
+  int LowestStrip = 0;
+  while ((XPaired & (1U << LowestStrip)) != 0) ++LowestStrip;
+  unsigned int Lowest = 1U << LowestStrip;
+
+  // The strip stays unpaired
+  unsigned char BestXMask = Lowest;
+  unsigned char BestYMask = 0;
+  const AssignmentState& Unpaired = m_AssignmentStates[SolveAssignment(XPaired | Lowest, YPaired)];
+  unsigned int BestNUnpaired = Unpaired.m_NUnpaired + 1;
+  float BestWeight = Unpaired.m_Weight;
+
+  // The strip is paired: All lower strips are already paired, thus it is the lowest strip of the combination
+  for (int mx = 0; mx < m_NXMasksByStrip[LowestStrip]; ++mx) {
+    unsigned int XMask = m_XMasksByStrip[LowestStrip][mx];
+    if ((XMask & XPaired) != 0) continue;
+    const MaskPair* Row = &m_MaskPairs[XMask*c_NMasks];
+    const unsigned char* YMasks = m_YMasksByXMask[XMask];
+    for (int my = 0; my < m_NYMasksByXMask[XMask]; ++my) {
+      unsigned int YMask = YMasks[my];
+      if ((YMask & YPaired) != 0) continue;
+
+      const AssignmentState& Next = m_AssignmentStates[SolveAssignment(XPaired | XMask, YPaired | YMask)];
+      float Weight = Next.m_Weight + Row[YMask].m_Weight;
+      if (Next.m_NUnpaired < BestNUnpaired || (Next.m_NUnpaired == BestNUnpaired && Weight < BestWeight)) {
+        BestNUnpaired = Next.m_NUnpaired;
+        BestWeight = Weight;
+        BestXMask = XMask;
+        BestYMask = YMask;
+      }
+    }
+  }
+
+  // The recursion does not invalidate the reference: the states are never reallocated
+  S.m_NUnpaired = BestNUnpaired;
+  S.m_Weight = BestWeight;
+  S.m_XMask = BestXMask;
+  S.m_YMask = BestYMask;
+
+  return Index;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::DecodeLabel(int Label, int* StripIDs, int& NStripIDs, bool& TwoHits, bool& ThreeHits, bool& ChargeSharing) const
+{
+  // Split a strip label into its strip IDs, e.g. 51 -> 1, 2; 104 -> 1, 4; 256 -> 2, 6, 7
+
+  NStripIDs = 0;
+  TwoHits = false;
+  ThreeHits = false;
+  ChargeSharing = false;
+
+  if (Label > 50 && Label < 100) {
+    // Charge sharing between two strips
+    StripIDs[NStripIDs++] = Label-50;
+    StripIDs[NStripIDs++] = Label+1-50;
+    ChargeSharing = true;
+  } else if (Label > 5000 && Label < 5100) {
+    // Charge sharing between three strips
+    StripIDs[NStripIDs++] = Label-5000;
+    StripIDs[NStripIDs++] = Label+1-5000;
+    StripIDs[NStripIDs++] = Label+2-5000;
+    ChargeSharing = true;
+  } else if (Label > 100 && Label < 10000) {
+    // Two hits: the strip on the other side was hit twice
+    TwoHits = true;
+    int Lower = Label - (Label/100)*100;
+    StripIDs[NStripIDs++] = Label/100;
+    if (Lower > 50) {
+      ChargeSharing = true;
+      StripIDs[NStripIDs++] = Lower-50;
+      StripIDs[NStripIDs++] = Lower+1-50;
+    } else {
+      StripIDs[NStripIDs++] = Lower;
+    }
+  } else if (Label > 10000) {
+    // Three hits: the strip on the other side was hit three times
+    ThreeHits = true;
+    StripIDs[NStripIDs++] = Label/10000;
+    int lowerFourDigits = Label - (Label/10000)*10000;
+    int Lower = lowerFourDigits - (lowerFourDigits/100)*100;
+    StripIDs[NStripIDs++] = lowerFourDigits/100;
+    if (Lower > 50) {
+      ChargeSharing = true;
+      StripIDs[NStripIDs++] = Lower-50;
+      StripIDs[NStripIDs++] = Lower+1-50;
+    } else {
+      StripIDs[NStripIDs++] = Lower;
+    }
+  } else if (Label < 38) {
+    // Simplest case: one strip
+    StripIDs[NStripIDs++] = Label;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::AddDecodedHit(const int* XStripIDs, int NXStripIDs, const int* YStripIDs, int NYStripIDs, bool MultipleTimesX, bool MultipleTimesY, bool ChargeSharing)
+{
+  // Add a decoded hit
+
+  DecodedHit& H = m_DecodedHits[m_NDecodedHits++];
+  copy(XStripIDs, XStripIDs + NXStripIDs, H.m_StripIDs[0]);
+  copy(YStripIDs, YStripIDs + NYStripIDs, H.m_StripIDs[1]);
+  H.m_NStrips[0] = NXStripIDs;
+  H.m_NStrips[1] = NYStripIDs;
+  H.m_MultipleTimesX = MultipleTimesX;
+  H.m_MultipleTimesY = MultipleTimesY;
+  H.m_ChargeSharing = ChargeSharing;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MStripPairingEngine::SplitHitRecord(int Index, const float* Energies, const float* Resolutions, int NHits)
+{
+  // The hit record at Index belongs to the first of NHits hits on the same strip:
+  // Set its energy and resolution and insert the records of the others after it
+
+  if (m_NHitRecords <= Index || m_NHitRecords + NHits - 1 > c_MaxHitRecords) {
+    return false;
+  }
+
+  float Quality = m_HitQualityFactor[Index];
+  m_HitEnergy[Index] = Energies[0];
+  m_EnergyResolution[Index] = Resolutions[0];
+  for (int h = 1; h < NHits; ++h) {
+    int Position = Index + h;
+    copy_backward(m_HitEnergy + Position, m_HitEnergy + m_NHitRecords, m_HitEnergy + m_NHitRecords + 1);
+    copy_backward(m_EnergyResolution + Position, m_EnergyResolution + m_NHitRecords, m_EnergyResolution + m_NHitRecords + 1);
+    copy_backward(m_HitQualityFactor + Position, m_HitQualityFactor + m_NHitRecords, m_HitQualityFactor + m_NHitRecords + 1);
+    m_HitEnergy[Position] = Energies[h];
+    m_EnergyResolution[Position] = Resolutions[h];
+    m_HitQualityFactor[Position] = Quality;
+    ++m_NHitRecords;
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+bool MStripPairingEngine::Decode()
+{
+  // Decode the final pairs into hits: Multiple hits on one strip become separate hits,
+  // and their energies and resolutions are taken from the other side
+
+  m_NDecodedHits = 0;
+
+  int StripIDs[2][c_MaxStripsPerHit];
+  int NStripIDs[2];
+  bool TwoHits[2];
+  bool ThreeHits[2];
+  bool ChargeSharing[2];
+
+  int twoHitsCounter = 0;
+  int threeHitsCounter = 0;
+
+  for (int i = 0; i < m_NFinalPairs; ++i) {
+    for (int axis = 0; axis < 2; ++axis) {
+      DecodeLabel(m_FinalPairs[i][axis], StripIDs[axis], NStripIDs[axis], TwoHits[axis], ThreeHits[axis], ChargeSharing[axis]);
+    }
+
+    if (TwoHits[0] == true || TwoHits[1] == true) {
+      // The strips of the side with two hits are split, the other side's strip has been hit multiple times
+      int axis = (TwoHits[0] == true) ? 0 : 1;
+      int other = 1 - axis;
+      twoHitsCounter += 1;
+
+      int Single[2][c_MaxStripsPerHit];
+      Single[0][0] = StripIDs[axis][0];
+      int Index[2];
+      Index[0] = GetStripIndex(axis, StripIDs[axis][0]);
+      int NSecond = 0;
+      if (ChargeSharing[axis] == true) {
+        Single[1][NSecond++] = StripIDs[axis][1];
+        Single[1][NSecond++] = StripIDs[axis][2];
+        Index[1] = GetStripIndex(axis, 50+StripIDs[axis][1]);
+      } else {
+        Single[1][NSecond++] = StripIDs[axis][1];
+        Index[1] = GetStripIndex(axis, StripIDs[axis][1]);
+      }
+
+      if (axis == 0) {
+        AddDecodedHit(Single[0], 1, StripIDs[other], NStripIDs[other], false, true, false);
+        AddDecodedHit(Single[1], NSecond, StripIDs[other], NStripIDs[other], false, true, ChargeSharing[axis]);
+      } else {
+        AddDecodedHit(StripIDs[other], NStripIDs[other], Single[0], 1, true, false, false);
+        AddDecodedHit(StripIDs[other], NStripIDs[other], Single[1], NSecond, true, false, ChargeSharing[axis]);
+      }
+
+      if (Index[0] < 0 || Index[1] < 0) return false;
+      float Energies[2] = { m_Energy[axis][Index[0]], m_Energy[axis][Index[1]] };
+      float Resolutions[2] = { m_Sigma[axis][Index[0]], m_Sigma[axis][Index[1]] };
+      if (SplitHitRecord(i+twoHitsCounter-1, Energies, Resolutions, 2) == false) return false;
+
+    } else if (ThreeHits[0] == true || ThreeHits[1] == true) {
+      // Same for three hits
+      int axis = (ThreeHits[0] == true) ? 0 : 1;
+      int other = 1 - axis;
+      threeHitsCounter += 1;
+
+      int Single[3][c_MaxStripsPerHit];
+      int Index[3];
+      Single[0][0] = StripIDs[axis][0];
+      Index[0] = GetStripIndex(axis, StripIDs[axis][0]);
+      Single[1][0] = StripIDs[axis][1];
+      Index[1] = GetStripIndex(axis, StripIDs[axis][1]);
+      int NThird = 0;
+      if (ChargeSharing[axis] == true) {
+        Single[2][NThird++] = StripIDs[axis][2];
+        Single[2][NThird++] = StripIDs[axis][3];
+        Index[2] = GetStripIndex(axis, 50+StripIDs[axis][2]);
+      } else {
+        Single[2][NThird++] = StripIDs[axis][2];
+        Index[2] = GetStripIndex(axis, StripIDs[axis][2]);
+      }
+
+      if (axis == 0) {
+        AddDecodedHit(Single[0], 1, StripIDs[other], NStripIDs[other], false, true, false);
+        AddDecodedHit(Single[1], 1, StripIDs[other], NStripIDs[other], false, true, false);
+        AddDecodedHit(Single[2], NThird, StripIDs[other], NStripIDs[other], false, true, ChargeSharing[axis]);
+      } else {
+        AddDecodedHit(StripIDs[other], NStripIDs[other], Single[0], 1, true, false, false);
+        AddDecodedHit(StripIDs[other], NStripIDs[other], Single[1], 1, true, false, false);
+        AddDecodedHit(StripIDs[other], NStripIDs[other], Single[2], NThird, true, false, ChargeSharing[axis]);
+      }
+
+      if (Index[0] < 0 || Index[1] < 0 || Index[2] < 0) return false;
+      float Energies[3] = { m_Energy[axis][Index[0]], m_Energy[axis][Index[1]], m_Energy[axis][Index[2]] };
+      float Resolutions[3] = { m_Sigma[axis][Index[0]], m_Sigma[axis][Index[1]], m_Sigma[axis][Index[2]] };
+      if (SplitHitRecord(i+threeHitsCounter-1, Energies, Resolutions, 3) == false) return false;
+
+    } else {
+      // One hit on x, one on y
+      AddDecodedHit(StripIDs[0], NStripIDs[0], StripIDs[1], NStripIDs[1], false, false, ChargeSharing[0] || ChargeSharing[1]);
+    }
+  }
+
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+int MStripPairingEngine::GetStripIndex(int Axis, int Label) const
+{
+  // For a given strip label return the (last) index in the strip list
+
+  int index = -1;
+  for (int i = 0; i < m_NHits[Axis]; ++i) {
+    if (m_StripsHit[Axis][i] == Label) {
+      index = i;
+    }
+  }
+
+  return index;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::PrintXYStripsHit() const
+{
+  // Print the current list of x and y strips including all combinations
+
+  const char* Names[2] = { "xStripsHit", "yStripsHit" };
+  const char* Totals[2] = { "total X energy: ", "total Y energy: " };
+  for (int axis = 0; axis < 2; ++axis) {
+    cout<<"--------------------------"<<endl<<"Printing "<<Names[axis]<<"...."<<endl;
+    for (int i = 0; i < m_NHits[axis]; ++i) {
+      cout<<m_StripsHit[axis][i]<<'\t'<<m_Energy[axis][i]<<'\t'<<m_Sigma[axis][i]<<endl;
+    }
+    float E = 0;
+    for (int i = 0; i < m_NHitsOrig[axis]; ++i) {
+      E += m_Energy[axis][i];
+    }
+    cout<<Totals[axis]<<'\t'<<E<<endl;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::PrintFinalPairs() const
+{
+  // Print the final pairs
+
+  cout<<"----------------------"<<endl<<"Printing final pairs"<<endl;
+  for (int p = 0; p < m_NFinalPairs; ++p) {
+    cout<<m_FinalPairs[p][0]<<'\t'<<m_FinalPairs[p][1]<<'\t'<<endl;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MStripPairingEngine::PrintWeightMatrix() const
+{
+  // Print the weight matrix (one row per y strip)
+
+  cout<<"-------------------"<<endl;
+  cout<<"printing matrix"<<endl;
+  for (int i = 0; i < m_NHits[1]; ++i) {
+    for (int j = 0; j < m_NHits[0]; ++j) {
+      cout<<m_WeightMatrix[j*m_NHits[1] + i]<<'\t';
+    }
+    cout<<endl;
+  }
+  cout<<"-------------------"<<endl;
+}
+
+
+// MStripPairingEngine.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,177 @@
+/*
+ * MThreadPool.cxx
+ *
+ *
+ * Copyright (C) by Andreas Zoglauer.
+ * All rights reserved.
+ *
+ *
+ * This code implementation is the intellectual property of
+ * Andreas Zoglauer.
+ *
+ * By copying, distributing or modifying the Program (or any work
+ * based on the Program) you indicate your acceptance of this statement,
+ * and all its terms.
+ *
+ */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+// MThreadPool
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Include the header:
+#include "MThreadPool.h"
+
+// Standard libs:
+
+// ROOT libs:
+
+// MEGAlib libs:
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifdef ___CLING___
+ClassImp(MThreadPool)
+#endif
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MThreadPool::MThreadPool() : m_Task(nullptr), m_NTasks(0), m_NextTask(0), m_Generation(0), m_NBusy(0), m_Stop(false)
+{
+  // Construct an instance of MThreadPool
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+MThreadPool::~MThreadPool()
+{
+  // Delete this instance of MThreadPool
+
+  Stop();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MThreadPool::SetNumberOfThreads(unsigned int NThreads)
+{
+  // Set the number of worker threads - this restarts all threads
+
+  if (NThreads == m_Threads.size()) return;
+
+  Stop();
+
+  m_Stop = false;
+  for (unsigned int t = 0; t < NThreads; ++t) {
+    m_Threads.push_back(thread(&MThreadPool::Run, this, m_Generation));
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MThreadPool::Stop()
+{
+  // Stop and join all threads
+
+  {
+    lock_guard<mutex> Lock(m_Mutex);
+    m_Stop = true;
+  }
+  m_WorkAvailable.notify_all();
+
+  for (thread& T: m_Threads) {
+    T.join();
+  }
+  m_Threads.clear();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MThreadPool::ParallelFor(unsigned int NTasks, const function<void(unsigned int)>& Task)
+{
+  // Call Task(i) for all i in [0, NTasks) and return when all calls are done
+
+  if (m_Threads.size() == 0 || NTasks <= 1) {
+    for (unsigned int i = 0; i < NTasks; ++i) {
+      Task(i);
+    }
+    return;
+  }
+
+  {
+    lock_guard<mutex> Lock(m_Mutex);
+    m_Task = &Task;
+    m_NTasks = NTasks;
+    m_NextTask = 0;
+    m_NBusy = m_Threads.size();
+    ++m_Generation;
+  }
+  m_WorkAvailable.notify_all();
+
+  // The calling thread works, too
+  Work();
+
+  unique_lock<mutex> Lock(m_Mutex);
+  m_WorkDone.wait(Lock, [this]{ return m_NBusy == 0; });
+  m_Task = nullptr;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MThreadPool::Work()
+{
+  // Execute tasks until none is left
+
+  unsigned int i;
+  while ((i = m_NextTask++) < m_NTasks) {
+    (*m_Task)(i);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+
+
+void MThreadPool::Run(unsigned long Generation)
+{
+  // The loop of a worker thread: wait for a new loop, work on it, and report back
+
+  while (true) {
+    {
+      unique_lock<mutex> Lock(m_Mutex);
+      m_WorkAvailable.wait(Lock, [this, Generation]{ return m_Stop == true || m_Generation != Generation; });
+      if (m_Stop == true) return;
+      Generation = m_Generation;
+    }
+
+    Work();
+
+    {
+      lock_guard<mutex> Lock(m_Mutex);
+      if (--m_NBusy == 0) {
+        m_WorkDone.notify_one();
+      }
+    }
+  }
+}
+
+
+// MThreadPool.cxx: the end...
+////////////////////////////////////////////////////////////////////////////////